@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 1994-2021 Altair Engineering, Inc.
+ * For more information, contact Altair at www.altair.com.
+ *
+ * This file is part of both the OpenPBS software ("OpenPBS")
+ * and the PBS Professional ("PBS Pro") software.
+ *
+ * Open Source License Information:
+ *
+ * OpenPBS is free software. You can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * OpenPBS is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Commercial License Information:
+ *
+ * PBS Pro is commercially licensed software that shares a common core with
+ * the OpenPBS software.  For a copy of the commercial license terms and
+ * conditions, go to: (http://www.pbspro.com/agreement.html) or contact the
+ * Altair Legal Department.
+ *
+ * Altair's dual-license business model allows companies, individuals, and
+ * organizations to create proprietary derivative works of OpenPBS and
+ * distribute them - whether embedded or bundled with other software -
+ * under a commercial license agreement.
+ *
+ * Use of Altair's trademarks, including but not limited to "PBS™",
+ * "OpenPBS®", "PBS Professional®", and "PBS Pro™" and Altair's logos is
+ * subject to Altair's trademark licensing policies.
+ */
+
+#ifndef	_ACCT_BIN_H
+#define	_ACCT_BIN_H
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+#include <stdio.h>
+#include <time.h>
+
+/*
+ * Binary accounting log, written by the server next to or instead of the
+ * text accounting log when PBS_ACCT_BINARY is set in pbs.conf.
+ *
+ * YYYYMMDD.bin starts with ACCT_BIN_MAGIC followed by records, all
+ * integers little endian:
+ *	uint32	length of the rest of the record
+ *	int64	time of the record
+ *	uint8	record type, PBS_ACCT_* in acct.h
+ *	uint16	length of the id, then the id (job or reservation id)
+ *	uint32	length of the text, then the text (the key=value list
+ *		of the text record)
+ *
+ * YYYYMMDD.idx starts with ACCT_IDX_MAGIC followed by one fixed size
+ * entry per record, in the order of the records:
+ *	int64	time of the record
+ *	uint64	offset of the record in the .bin file
+ *	uint32	acct_bin_idhash() of the id
+ *	uint32	zero
+ */
+#define ACCT_BIN_MAGIC		"PBSACB01"
+#define ACCT_IDX_MAGIC		"PBSACI01"
+#define ACCT_MAGIC_LEN		8
+#define ACCT_BIN_SUFFIX		".bin"
+#define ACCT_IDX_SUFFIX		".idx"
+#define ACCT_BIN_HDR_LEN	19	/* record bytes besides id and text */
+#define ACCT_IDX_ENTRY_LEN	24
+
+/* values of PBS_ACCT_BINARY */
+#define ACCT_FMT_TEXT		0	/* text log only, the default */
+#define ACCT_FMT_BOTH		1	/* text and binary logs */
+#define ACCT_FMT_BINARY		2	/* binary log only */
+
+struct acct_bin_rec {
+	time_t		ab_time;
+	int		ab_type;
+	char		*ab_id;		/* points into the read buffer */
+	char		*ab_text;	/* points into the read buffer */
+};
+
+struct acct_idx_ent {
+	time_t		ai_time;
+	long long	ai_offset;
+	unsigned int	ai_idhash;
+};
+
+extern unsigned int acct_bin_idhash(const char *id);
+extern size_t acct_bin_encode(char **buf, size_t *bufsz, time_t t, int type, const char *id, const char *text);
+extern void acct_idx_encode(char *buf, time_t t, long long offset, const char *id);
+extern int acct_bin_check_magic(FILE *fp, const char *magic);
+extern int acct_bin_read(FILE *fp, struct acct_bin_rec *rec, char **buf, size_t *bufsz);
+extern int acct_idx_read(FILE *fp, struct acct_idx_ent *ent);
+extern int acct_bin_to_text(const struct acct_bin_rec *rec, FILE *out);
+
+#ifdef	__cplusplus
+}
+#endif
+#endif	/* _ACCT_BIN_H */
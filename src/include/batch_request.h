@@ -50,6 +50,7 @@ extern "C" {
 
 #define PBS_SIGNAMESZ 16
 #define MAX_JOBS_PER_REPLY 500
+#define MAX_NODES_PER_REPLY 500
 
 /* QueueJob */
 struct rq_queuejob {
@@ -175,6 +176,13 @@ struct rq_runjob {
 	unsigned long rq_resch;
 };
 
+/* RunJobList - one run request per job, started as a group */
+struct rq_runjoblist {
+	int rq_count;
+	char **rq_jobslist;
+	char **rq_destinlist;
+};
+
 /* SignalJob */
 struct rq_signal {
 	char rq_jid[PBS_MAXSVRJOBID + 1];
@@ -324,6 +332,7 @@ struct batch_request {
 		char rq_rerun[PBS_MAXSVRJOBID + 1];
 		struct rq_rescq rq_rescq;
 		struct rq_runjob rq_run;
+		struct rq_runjoblist rq_runjoblist;
 		struct rq_selstat rq_select;
 		int rq_shutdown;
 		struct rq_signal rq_signal;
@@ -350,6 +359,7 @@ extern void reply_badattr_msg(int, int, svrattrl *, struct batch_request *, int)
 extern int reply_text(struct batch_request *, int, char *);
 extern int reply_send(struct batch_request *);
 extern int reply_send_status_part(struct batch_request *);
+extern int update_runjoblist_stat(struct batch_request *, char *, int);
 extern int reply_jobid(struct batch_request *, char *, int);
 extern int reply_jobid_msg(struct batch_request *, char *, int, int);
 extern void reply_free(struct batch_reply *);
@@ -377,6 +387,7 @@ extern void req_register(struct batch_request *);
 extern void req_releasejob(struct batch_request *);
 extern void req_rescq(struct batch_request *);
 extern void req_runjob(struct batch_request *);
+extern void req_runjoblist(struct batch_request *);
 extern void req_selectjobs(struct batch_request *);
 extern void req_stat_que(struct batch_request *);
 extern void req_stat_svr(struct batch_request *);
@@ -418,6 +429,7 @@ extern int decode_DIS_ReqHdr(int, struct batch_request *, int *, int *);
 extern int decode_DIS_Rescl(int, struct batch_request *);
 extern int decode_DIS_Rescq(int, struct batch_request *);
 extern int decode_DIS_Run(int, struct batch_request *);
+extern int decode_DIS_RunJobList(int, struct batch_request *);
 extern int decode_DIS_ShutDown(int, struct batch_request *);
 extern int decode_DIS_SignalJob(int, struct batch_request *);
 extern int decode_DIS_Status(int, struct batch_request *);
@@ -434,6 +446,7 @@ extern int encode_DIS_TrackJob(int, struct batch_request *);
 extern int encode_DIS_reply(int, struct batch_reply *);
 extern int encode_DIS_replyTPP(int, char *, struct batch_reply *);
 extern int encode_DIS_svrattrl(int, svrattrl *);
+extern void free_brp_blob(struct brp_blob *);
 extern int encode_DIS_Cred(int, char *, char *, int, char *, size_t, long);
 extern int dis_request_read(int, struct batch_request *);
 extern int dis_reply_read(int, struct batch_reply *, int);
@@ -93,6 +93,8 @@ int __pbs_rlsjob(int, char *, char *, char *);
 
 int __pbs_runjob(int, char *, char *, char *);
 
+struct batch_deljob_status *__pbs_runjoblist(int, char **, char **, int, char *);
+
 char **__pbs_selectjob(int, struct attropl *, char *);
 
 int __pbs_sigjob(int, char *, char *, char *);
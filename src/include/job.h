@@ -445,6 +445,8 @@ struct job {
 	time_t ji_actalarm;			    /* time of site callout alarm */
 	time_t ji_joinalarm;			    /* time of job's sister join job alarm, also, time obit sent, all */
 	time_t ji_overlmt_timestamp;		    /*time the job exceeded limit*/
+	double ji_joinstart;			    /* time JOIN_JOB was sent to sisters, MS only */
+	int ji_joinscan;			    /* first host that may still have events, MS only */
 	int ji_jsmpipe;				    /* pipe from child starter process */
 	int ji_mjspipe;				    /* pipe to   child starter for ack */
 	int ji_jsmpipe2;			    /* pipe for child starter process to send special requests to parent mom */
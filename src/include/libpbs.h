@@ -165,12 +165,25 @@ struct brp_select {
 	char brp_jobid[PBS_MAXSVRJOBID + 1];
 };
 
+/*
+ * pre-encoded DIS form of the attribute list of a status reply entry,
+ * shared (reference counted) between the object it describes and the
+ * replies it is linked into; bb_len is zero until first encoded
+ */
+struct brp_blob {
+	int bb_refct;  /* number of references */
+	int bb_perm;   /* privilege the attribute list was built for */
+	size_t bb_len; /* length of bb_data */
+	char *bb_data;
+};
+
 /* reply to Status Job/Queue/Server Request */
 struct brp_status {
 	pbs_list_link brp_stlink;
 	int brp_objtype;
 	char brp_objname[(PBS_MAXSVRJOBID > PBS_MAXDEST ? PBS_MAXSVRJOBID : PBS_MAXDEST) + 1];
-	pbs_list_head brp_attr; /* head of svrattrlist */
+	pbs_list_head brp_attr;	 /* head of svrattrlist */
+	struct brp_blob *brp_blob; /* if set, encoded form of brp_attr */
 };
 
 /* reply to Resource Query Request */
@@ -310,6 +323,7 @@ struct batch_reply
 #define PBS_BATCH_ModifyVnode    	99
 #define PBS_BATCH_DeleteJobList  	100
 #define PBS_BATCH_ServerReady    	101
+#define PBS_BATCH_RunJobList     	102
 
 #define PBS_BATCH_FileOpt_Default	0
 #define PBS_BATCH_FileOpt_OFlg		1
@@ -386,6 +400,7 @@ int encode_DIS_ReqExtend(int, char *);
 int encode_DIS_ReqHdr(int, int, char *);
 int encode_DIS_Rescq(int, char **, int);
 int encode_DIS_Run(int, char *, char *, unsigned long);
+int encode_DIS_RunJobList(int, char **, char **, int);
 int encode_DIS_ShutDown(int, int);
 int encode_DIS_SignalJob(int, char *, char *);
 int encode_DIS_Status(int, char *, struct attrl *);
@@ -80,6 +80,10 @@ extern "C" {
 #define OBJ_SAVE_NEW    1   /* object is new, so whole object should be saved */
 #define OBJ_SAVE_QS     2   /* quick save area modified, it should be saved */
 
+/* how to end a transaction - see pbs_db_end_trx */
+#define PBS_DB_COMMIT	0
+#define PBS_DB_ROLLBACK	1
+
 /**
  * @brief
  * Following are a set of mapping of DATABASE vs C data types. These are
@@ -332,6 +336,34 @@ int pbs_db_connect(void **conn, char *host, int port, int timeout);
  */
 int pbs_db_disconnect(void *conn);
 
+/**
+ * @brief
+ *	Start a (possibly nested) transaction on the connection, so
+ *	that the saves which follow are committed together
+ *
+ * @param[in]	conn - Connected database handle
+ *
+ * @return      int
+ * @retval      -1  - Failure
+ * @retval       0  - success
+ *
+ */
+int pbs_db_begin_trx(void *conn);
+
+/**
+ * @brief
+ *	End a transaction started with pbs_db_begin_trx
+ *
+ * @param[in]	conn - Connected database handle
+ * @param[in]	commit - PBS_DB_COMMIT or PBS_DB_ROLLBACK
+ *
+ * @return      int
+ * @retval      -1  - Failure
+ * @retval       0  - success
+ *
+ */
+int pbs_db_end_trx(void *conn, int commit);
+
 /**
  * @brief
  *	Insert a new object into the database
@@ -404,6 +436,79 @@ int pbs_db_delete_attr_obj(void *conn, pbs_db_obj_info_t *obj, void *obj_id, pbs
  */
 int pbs_db_search(void *conn, pbs_db_obj_info_t *obj, pbs_db_query_options_t *opts, query_cb_t query_cb);
 
+/**
+ * @brief
+ *	Open a server side cursor over all the objects of a type, to be read
+ *	in batches with pbs_db_cursor_fetch() and closed with
+ *	pbs_db_cursor_close(). Only one cursor can be open on a connection.
+ *
+ * @param[in]	conn - Connected database handle
+ * @param[in]	pbs_db_obj_info_t - The wrapper object describing the type
+ * @param[in]	pbs_db_query_options_t - Options which will effect the query
+ *
+ * @return      int
+ * @retval      -1  - Failure
+ * @retval       0  - success
+ *
+ */
+int pbs_db_cursor_open(void *conn, pbs_db_obj_info_t *obj, pbs_db_query_options_t *opts);
+
+/**
+ * @brief
+ *	Fetch the next batch of at most fetch_size rows from the open cursor
+ *
+ * @param[in]	conn - Connected database handle
+ * @param[in]	fetch_size - Maximum number of rows to fetch
+ * @param[out]	batch - The rows fetched, free with pbs_db_batch_free()
+ *
+ * @return      int
+ * @retval      -1  - Failure
+ * @retval       0  - no more rows
+ * @retval      >0  - number of rows in the batch
+ *
+ */
+int pbs_db_cursor_fetch(void *conn, int fetch_size, void **batch);
+
+/**
+ * @brief
+ *	Load one row of a batch into the wrapper object. Different rows can
+ *	be loaded by different threads, see pbs_db_batch_load() for details.
+ *
+ * @param[in]	batch - The batch of rows
+ * @param[in]	row - Index of the row in the batch
+ * @param[out]	pbs_db_obj_info_t - The wrapper object to load into
+ *
+ * @return      int
+ * @retval      -1  - Failure
+ * @retval       0  - success
+ *
+ */
+int pbs_db_batch_load(void *batch, int row, pbs_db_obj_info_t *obj);
+
+/**
+ * @brief
+ *	Free a batch of rows returned by pbs_db_cursor_fetch()
+ *
+ * @param[in]	batch - The batch of rows
+ *
+ * @return      void
+ *
+ */
+void pbs_db_batch_free(void *batch);
+
+/**
+ * @brief
+ *	Close the cursor opened by pbs_db_cursor_open()
+ *
+ * @param[in]	conn - Connected database handle
+ *
+ * @return      int
+ * @retval      -1  - Failure
+ * @retval       0  - success
+ *
+ */
+int pbs_db_cursor_close(void *conn);
+
 /**
  * @brief
  *	Load a single existing object from the database
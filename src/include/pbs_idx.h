@@ -45,6 +45,7 @@ extern "C" {
 
 #define PBS_IDX_DUPS_OK     0x01 /* duplicate key allowed in index */
 #define PBS_IDX_ICASE_CMP   0x02 /* set case-insensitive compare */
+#define PBS_IDX_HASH        0x04 /* hash index, see pbs_idx_create() */
 
 #define PBS_IDX_RET_OK    0 /* index op succeed */
 #define PBS_IDX_RET_FAIL -1 /* index op failed */
@@ -53,13 +54,19 @@ extern "C" {
  * @brief
  *	Create an empty index
  *
- * @param[in] - dups   - Whether duplicates are allowed or not in index
+ * @param[in] - flags  - PBS_IDX_* flags for index
  * @param[in] - keylen - length of key in index (can be 0 for default size)
  *
  * @return void *
  * @retval !NULL - success
  * @retval NULL  - failure
  *
+ * @note
+ *	With PBS_IDX_HASH the index is a hash table instead of an AVL tree.
+ *	Lookup by key is O(1), but iteration from NULL key is in no particular
+ *	order and iteration from a given key only returns entries with that
+ *	same key. Entries must not be added while iterating a hash index.
+ *
  */
 extern void *pbs_idx_create(int dups, int keylen);
 
@@ -641,6 +641,8 @@ DECLDIR int pbs_rlsjob(int, char *, char *, char *);
 
 DECLDIR int pbs_runjob(int, char *, char *, char *);
 
+DECLDIR struct batch_deljob_status *pbs_runjoblist(int, char **, char **, int, char *);
+
 DECLDIR char **pbs_selectjob(int, struct attropl *, char *);
 
 DECLDIR int pbs_sigjob(int, char *, char *, char *);
@@ -743,6 +745,8 @@ extern int pbs_rlsjob(int, char *, char *, char *);
 
 extern int pbs_runjob(int, char *, char *, char *);
 
+extern struct batch_deljob_status *pbs_runjoblist(int, char **, char **, int, char *);
+
 extern char **pbs_selectjob(int, struct attropl *, char *);
 
 extern int pbs_sigjob(int, char *, char *, char *);
@@ -811,6 +815,7 @@ extern int (*pfn_pbs_orderjob)(int, char *, char *, char *);
 extern int (*pfn_pbs_rerunjob)(int, char *, char *);
 extern int (*pfn_pbs_rlsjob)(int, char *, char *, char *);
 extern int (*pfn_pbs_runjob)(int, char *, char *, char *);
+extern struct batch_deljob_status *(*pfn_pbs_runjoblist)(int, char **, char **, int, char *);
 extern char **(*pfn_pbs_selectjob)(int, struct attropl *, char *);
 extern int (*pfn_pbs_sigjob)(int, char *, char *, char *);
 extern void (*pfn_pbs_statfree)(struct batch_status *);
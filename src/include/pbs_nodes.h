@@ -128,6 +128,7 @@ struct mom_svrinfo {
 	int		msr_has_inventory; /* Tells whether mom is an inventory reporting mom */
 	mom_hook_action_t **msr_action;	/* pending hook copy/delete on mom */
 	int		msr_num_action;	/* # of hook actions in msr_action */
+	unsigned int	msr_vnl_digest;	/* digest of last UPDATE2 vnode list applied, 0 if none */
 };
 typedef struct mom_svrinfo mom_svrinfo_t;
 
@@ -265,6 +266,7 @@ struct pbsnode {
 	pbs_list_link un_lic_link;		/*Link to unlicense list */
 	int nd_svrflags;	/* server flags */
 	pbs_list_link nd_link;	/* Link to holding svr list in case if this is an alien node */
+	struct brp_blob *nd_statblob[2]; /* encoded full status, user and privileged */
 	attribute nd_attr[ND_ATR_LAST];
 };
 typedef struct pbsnode pbs_node;
@@ -204,6 +204,8 @@ struct resc_resv {
 	int			req_sched_count;
 	int			rep_sched_count;
 
+	struct brp_blob		*ri_statblob[2];	/* encoded full status, user and privileged */
+
 	/*
 	 * fixed size internal data - maintained via "quick save"
 	 * some of the items are copies of attributes, if so this
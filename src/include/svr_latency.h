@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 1994-2021 Altair Engineering, Inc.
+ * For more information, contact Altair at www.altair.com.
+ *
+ * This file is part of both the OpenPBS software ("OpenPBS")
+ * and the PBS Professional ("PBS Pro") software.
+ *
+ * Open Source License Information:
+ *
+ * OpenPBS is free software. You can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * OpenPBS is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Commercial License Information:
+ *
+ * PBS Pro is commercially licensed software that shares a common core with
+ * the OpenPBS software.  For a copy of the commercial license terms and
+ * conditions, go to: (http://www.pbspro.com/agreement.html) or contact the
+ * Altair Legal Department.
+ *
+ * Altair's dual-license business model allows companies, individuals, and
+ * organizations to create proprietary derivative works of OpenPBS and
+ * distribute them - whether embedded or bundled with other software -
+ * under a commercial license agreement.
+ *
+ * Use of Altair's trademarks, including but not limited to "PBS™",
+ * "OpenPBS®", "PBS Professional®", and "PBS Pro™" and Altair's logos is
+ * subject to Altair's trademark licensing policies.
+ */
+
+#ifndef	_SVR_LATENCY_H
+#define	_SVR_LATENCY_H
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+#include <time.h>
+
+/*
+ * Service time histograms of the server main loop, see svr_latency.c
+ */
+
+#define LAT_BUCKETS	32	/* bucket i counts times of [2^(i-1), 2^i) usecs */
+#define LAT_MAX_TYPE	128	/* types per class, above PBS_BATCH_* and IS_* */
+#define LAT_DUMP_INTERVAL 300	/* secs between dumps to the log and PBS_SVRMETRICS */
+
+enum lat_class {
+	LAT_BATCH,	/* batch requests, by PBS_BATCH_* type */
+	LAT_IS,		/* inter-server messages from MoMs, by IS_* command */
+	LAT_DB_SAVE,	/* database saves, by LAT_DB_* object type */
+	LAT_HOOK,	/* server hook runs, by PBS_BATCH_* type of the request */
+	LAT_CLASS_HIGH
+};
+
+/* object types for LAT_DB_SAVE */
+#define LAT_DB_JOB	0
+#define LAT_DB_RESV	1
+#define LAT_DB_NODE	2
+#define LAT_DB_QUEUE	3
+#define LAT_DB_SVR	4
+
+/* take the start time of something to be passed to lat_record() later */
+#define LAT_START(ts)	clock_gettime(CLOCK_MONOTONIC, (ts))
+
+struct work_task;
+
+extern void lat_add(enum lat_class cls, int type, unsigned long usecs);
+extern unsigned long lat_since(const struct timespec *start);
+extern void lat_record(enum lat_class cls, int type, const struct timespec *start);
+extern void lat_dump(struct work_task *ptask);
+
+#ifdef	__cplusplus
+}
+#endif
+#endif	/* _SVR_LATENCY_H */
@@ -94,6 +94,7 @@ extern "C" {
 /* TPP specific definitions and structures */
 #define TPP_DEF_ROUTER_PORT 17001
 #define TPP_MAXOPENFD 8192 /* limit for pbs_comm max open files */
+#define TPP_MAX_LEAF_ADDRS 255 /* addresses a leaf can register, the join packet count is a byte */
 
 /* tpp node types, leaf and router */
 #define TPP_LEAF_NODE           1  /* leaf node that does not care about TPP_CTL_LEAVE messages from other leaves */
@@ -126,6 +127,7 @@ extern int set_tpp_config(struct pbs_config *, struct tpp_config *, char *, int,
 extern void free_tpp_config(struct tpp_config *);
 extern void DIS_tpp_funcs();
 extern int tpp_open(char *, unsigned int);
+extern int tpp_open_new(char *, unsigned int);
 extern int tpp_close(int);
 extern int tpp_eom(int);
 extern int tpp_bind(unsigned int);
@@ -133,6 +135,7 @@ extern int tpp_poll(void);
 extern void tpp_terminate(void);
 extern void tpp_shutdown(void);
 extern struct sockaddr_in *tpp_getaddr(int);
+extern struct sockaddr_in *tpp_localaddr(int);
 extern void tpp_add_close_func(int, void (*func)(int));
 extern char *tpp_parse_hostname(char *, int *);
 extern int tpp_init_router(struct tpp_config *);
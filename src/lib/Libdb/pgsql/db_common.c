@@ -92,7 +92,8 @@ pg_db_fn_t db_fn_arr[PBS_DB_NUM_TYPES] = {
 		pbs_db_load_svr,
 		NULL,
 		NULL,
-		pbs_db_del_attr_svr
+		pbs_db_del_attr_svr,
+		NULL
 	},
 	{	/* PBS_DB_SCHED */
 		pbs_db_save_sched,
@@ -100,7 +101,8 @@ pg_db_fn_t db_fn_arr[PBS_DB_NUM_TYPES] = {
 		pbs_db_load_sched,
 		pbs_db_find_sched,
 		pbs_db_next_sched,
-		pbs_db_del_attr_sched
+		pbs_db_del_attr_sched,
+		NULL
 	},
 	{	/* PBS_DB_QUE */
 		pbs_db_save_que,
@@ -108,7 +110,8 @@ pg_db_fn_t db_fn_arr[PBS_DB_NUM_TYPES] = {
 		pbs_db_load_que,
 		pbs_db_find_que,
 		pbs_db_next_que,
-		pbs_db_del_attr_que
+		pbs_db_del_attr_que,
+		NULL
 	},
 	{	/* PBS_DB_NODE */
 		pbs_db_save_node,
@@ -116,7 +119,8 @@ pg_db_fn_t db_fn_arr[PBS_DB_NUM_TYPES] = {
 		pbs_db_load_node,
 		pbs_db_find_node,
 		pbs_db_next_node,
-		pbs_db_del_attr_node
+		pbs_db_del_attr_node,
+		NULL
 	},
 	{	/* PBS_DB_MOMINFO_TIME */
 		pbs_db_save_mominfo_tm,
@@ -124,6 +128,7 @@ pg_db_fn_t db_fn_arr[PBS_DB_NUM_TYPES] = {
 		pbs_db_load_mominfo_tm,
 		NULL,
 		NULL,
+		NULL,
 		NULL
 	},
 	{	/* PBS_DB_JOB */
@@ -132,7 +137,8 @@ pg_db_fn_t db_fn_arr[PBS_DB_NUM_TYPES] = {
 		pbs_db_load_job,
 		pbs_db_find_job,
 		pbs_db_next_job,
-		pbs_db_del_attr_job
+		pbs_db_del_attr_job,
+		pbs_db_declare_job_cursor
 	},
 	{	/* PBS_DB_JOBSCR */
 		pbs_db_save_jobscr,
@@ -140,6 +146,7 @@ pg_db_fn_t db_fn_arr[PBS_DB_NUM_TYPES] = {
 		pbs_db_load_jobscr,
 		NULL,
 		NULL,
+		NULL,
 		NULL
 	},
 	{	/* PBS_DB_RESV */
@@ -148,7 +155,8 @@ pg_db_fn_t db_fn_arr[PBS_DB_NUM_TYPES] = {
 		pbs_db_load_resv,
 		pbs_db_find_resv,
 		pbs_db_next_resv,
-		pbs_db_del_attr_resv
+		pbs_db_del_attr_resv,
+		NULL
 	}
 };
 
@@ -278,6 +286,143 @@ db_cursor_next(void *conn, void *st, pbs_db_obj_info_t *obj)
 	return 1; /* no more rows */
 }
 
+/**
+ * @brief
+ *	Open a server side cursor over all the objects of the given type, so
+ *	that they can be fetched in batches with pbs_db_cursor_fetch() instead
+ *	of one resultset holding every row. Only one such cursor can be open on
+ *	a connection at a time.
+ *
+ * @param[in]	conn - Connected database handle
+ * @param[in]	pbs_db_obj_info_t - The pointer to the wrapper object which
+ *		describes the PBS object type to search for
+ * @param[in]	pbs_db_query_options_t - Pointer to the options object that can
+ *		contain the flags or timestamp which will effect the query.
+ *
+ * @return	int
+ * @retval	-1	- Failure, or no cursor support for the object type
+ * @retval	0	- Success
+ *
+ */
+int
+pbs_db_cursor_open(void *conn, pbs_db_obj_info_t *obj, pbs_db_query_options_t *opts)
+{
+	if (db_fn_arr[obj->pbs_db_obj_type].pbs_db_declare_cursor == NULL)
+		return -1;
+
+	return (db_fn_arr[obj->pbs_db_obj_type].pbs_db_declare_cursor(conn, DB_SEARCH_CURSOR, opts));
+}
+
+/**
+ * @brief
+ *	Fetch the next batch of rows from the cursor opened by
+ *	pbs_db_cursor_open(). The batch stays valid after further fetches,
+ *	until it is freed with pbs_db_batch_free().
+ *
+ * @param[in]	conn - Connected database handle
+ * @param[in]	fetch_size - The maximum number of rows to fetch
+ * @param[out]	batch - The batch of rows fetched, to be passed to
+ *		pbs_db_batch_load()
+ *
+ * @return	int
+ * @retval	-1	- Failure
+ * @retval	0	- Success but no more rows
+ * @retval	>0	- Success and number of rows in the batch
+ *
+ */
+int
+pbs_db_cursor_fetch(void *conn, int fetch_size, void **batch)
+{
+	char conn_sql[MAX_SQL_LENGTH];
+	PGresult *res;
+	db_query_state_t *state;
+
+	*batch = NULL;
+
+	snprintf(conn_sql, MAX_SQL_LENGTH, "fetch forward %d from %s", fetch_size, DB_SEARCH_CURSOR);
+	res = PQexecParams((PGconn *) conn, conn_sql, 0, NULL, NULL, NULL, NULL, 1);
+	if (PQresultStatus(res) != PGRES_TUPLES_OK) {
+		char *sql_error = PQresultErrorField(res, PG_DIAG_SQLSTATE);
+		db_set_error(conn, &errmsg_cache, "Fetch from cursor", DB_SEARCH_CURSOR, sql_error);
+		PQclear(res);
+		return -1;
+	}
+
+	if (PQntuples(res) <= 0) {
+		PQclear(res);
+		return 0;
+	}
+
+	if ((state = db_initialize_state(conn, NULL)) == NULL) {
+		PQclear(res);
+		return -1;
+	}
+	state->res = res;
+	state->row = 0;
+	state->count = PQntuples(res);
+	*batch = state;
+
+	return state->count;
+}
+
+/**
+ * @brief
+ *	Load one row of a batch fetched by pbs_db_cursor_fetch(). Distinct
+ *	rows of a batch may be loaded concurrently from different threads,
+ *	once a first row of the object type has been loaded by a single thread.
+ *
+ * @param[in]	batch - The batch of rows
+ * @param[in]	row   - The index of the row in the batch
+ * @param[out]	pbs_db_obj_info_t - The wrapper object the row is loaded into
+ *
+ * @return	Error code
+ * @retval	-1  - Failure
+ * @retval	0  - success
+ *
+ */
+int
+pbs_db_batch_load(void *batch, int row, pbs_db_obj_info_t *obj)
+{
+	db_query_state_t state = *((db_query_state_t *) batch);
+
+	if (row < 0 || row >= state.count)
+		return -1;
+
+	state.row = row;
+	return (db_fn_arr[obj->pbs_db_obj_type].pbs_db_next_obj(NULL, &state, obj));
+}
+
+/**
+ * @brief
+ *	Free a batch of rows fetched by pbs_db_cursor_fetch()
+ *
+ * @param[in]	batch - The batch of rows
+ *
+ * @return void
+ */
+void
+pbs_db_batch_free(void *batch)
+{
+	db_destroy_state(batch);
+}
+
+/**
+ * @brief
+ *	Close the cursor opened by pbs_db_cursor_open()
+ *
+ * @param[in]	conn - Connected database handle
+ *
+ * @return	int
+ * @retval	-1  - Failure
+ * @retval	0   - success
+ *
+ */
+int
+pbs_db_cursor_close(void *conn)
+{
+	return (db_execute_str(conn, "close " DB_SEARCH_CURSOR) == -1 ? -1 : 0);
+}
+
 /**
  * @brief
  *	Delete an existing object from the database
@@ -869,6 +1014,68 @@ pbs_db_disconnect(void *conn)
 	return 0;
 }
 
+/**
+ * @brief
+ *	Start a transaction so that the statements which follow are
+ *	committed to disk together rather than one by one.  Transactions
+ *	nest, only the outermost begin and end go to the database.
+ *
+ * @param[in]	conn - Connected database handle
+ *
+ * @return      Error code
+ * @retval	-1  - Failure
+ * @retval	 0  - Success
+ *
+ */
+int
+pbs_db_begin_trx(void *conn)
+{
+	if (conn_trx->conn_trx_nest == 0) {
+		if (db_execute_str(conn, "BEGIN") == -1)
+			return -1;
+		conn_trx->conn_trx_rollback = 0;
+	}
+	conn_trx->conn_trx_nest++;
+
+	return 0;
+}
+
+/**
+ * @brief
+ *	End a transaction started by pbs_db_begin_trx().  The outermost
+ *	end commits, or rolls back if any level asked for a rollback.
+ *
+ * @param[in]	conn - Connected database handle
+ * @param[in]	commit - PBS_DB_COMMIT or PBS_DB_ROLLBACK
+ *
+ * @return      Error code
+ * @retval	-1  - Failure (no transaction, or the commit failed)
+ * @retval	 0  - Success
+ *
+ */
+int
+pbs_db_end_trx(void *conn, int commit)
+{
+	int rc;
+
+	if (conn_trx->conn_trx_nest == 0)
+		return -1;
+
+	if (commit == PBS_DB_ROLLBACK)
+		conn_trx->conn_trx_rollback = 1;
+
+	if (--conn_trx->conn_trx_nest > 0)
+		return 0;
+
+	if (conn_trx->conn_trx_rollback)
+		rc = db_execute_str(conn, "ROLLBACK");
+	else
+		rc = db_execute_str(conn, "COMMIT");
+	conn_trx->conn_trx_rollback = 0;
+
+	return (rc == -1 ? -1 : 0);
+}
+
 /**
  * @brief
  *	Saves a new object into the database
@@ -1002,6 +1209,13 @@ db_cmd(void *conn, char *stmt, int num_vars)
 	PGresult *res;
 	char *rows_affected = NULL;
 
+	/*
+	 * inside a transaction a failed statement would abort all the
+	 * others, so give each one a savepoint to fall back to
+	 */
+	if (conn_trx->conn_trx_nest > 0 && db_execute_str(conn, "SAVEPOINT pbs_db_cmd") == -1)
+		return -1;
+
 	res = PQexecPrepared((PGconn *)conn, stmt, num_vars,
 				conn_data->paramValues,
 				conn_data->paramLengths,
@@ -1010,8 +1224,12 @@ db_cmd(void *conn, char *stmt, int num_vars)
 		char *sql_error = PQresultErrorField(res, PG_DIAG_SQLSTATE);
 		db_set_error(conn, &errmsg_cache, "Execution of Prepared statement", stmt, sql_error);
 		PQclear(res);
+		if (conn_trx->conn_trx_nest > 0)
+			PQclear(PQexec((PGconn *)conn, "ROLLBACK TO SAVEPOINT pbs_db_cmd"));
 		return -1;
 	}
+	if (conn_trx->conn_trx_nest > 0)
+		PQclear(PQexec((PGconn *)conn, "RELEASE SAVEPOINT pbs_db_cmd"));
 	rows_affected = PQcmdTuples(res);
 
 	/*
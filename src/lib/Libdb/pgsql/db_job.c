@@ -47,6 +47,26 @@
 #include "pbs_db.h"
 #include "db_postgres.h"
 
+/* columns returned by the job find queries and the job cursor, see load_job() */
+#define JOB_FIND_COLUMNS \
+	"ji_jobid," \
+	"ji_state," \
+	"ji_substate," \
+	"ji_svrflags," \
+	"ji_stime," \
+	"ji_queue," \
+	"ji_destin," \
+	"ji_un_type," \
+	"ji_exitstat," \
+	"ji_quetime," \
+	"ji_rteretry," \
+	"ji_fromsock," \
+	"ji_fromaddr," \
+	"ji_jid," \
+	"ji_credtype," \
+	"ji_qrank," \
+	"hstore_to_array(attributes) as attributes "
+
 /**
  * @brief
  *	Prepare all the job related sqls. Typically called after connect
@@ -197,46 +217,12 @@ db_prepare_job_sqls(void *conn)
 	if (db_prepare_stmt(conn, STMT_SELECT_JOBSCR, conn_sql, 1) != 0)
 		return -1;
 
-	snprintf(conn_sql, MAX_SQL_LENGTH, "select "
-		"ji_jobid,"
-		"ji_state,"
-		"ji_substate,"
-		"ji_svrflags,"
-		"ji_stime,"
-		"ji_queue,"
-		"ji_destin,"
-		"ji_un_type,"
-		"ji_exitstat,"
-		"ji_quetime,"
-		"ji_rteretry,"
-		"ji_fromsock,"
-		"ji_fromaddr,"
-		"ji_jid,"
-		"ji_credtype,"
-		"ji_qrank,"
-		"hstore_to_array(attributes) as attributes "
+	snprintf(conn_sql, MAX_SQL_LENGTH, "select " JOB_FIND_COLUMNS
 		"from pbs.job order by ji_qrank");
 	if (db_prepare_stmt(conn, STMT_FINDJOBS_ORDBY_QRANK, conn_sql, 0) != 0)
 		return -1;
 
-	snprintf(conn_sql, MAX_SQL_LENGTH, "select "
-		"ji_jobid,"
-		"ji_state,"
-		"ji_substate,"
-		"ji_svrflags,"
-		"ji_stime,"
-		"ji_queue,"
-		"ji_destin,"
-		"ji_un_type,"
-		"ji_exitstat,"
-		"ji_quetime,"
-		"ji_rteretry,"
-		"ji_fromsock,"
-		"ji_fromaddr,"
-		"ji_jid,"
-		"ji_credtype,"
-		"ji_qrank,"
-		"hstore_to_array(attributes) as attributes "
+	snprintf(conn_sql, MAX_SQL_LENGTH, "select " JOB_FIND_COLUMNS
 		"from pbs.job where ji_queue = $1"
 		" order by ji_qrank");
 	if (db_prepare_stmt(conn, STMT_FINDJOBS_BYQUE_ORDBY_QRANK,
@@ -509,6 +495,34 @@ pbs_db_next_job(void *conn, void *st, pbs_db_obj_info_t *obj)
 	return load_job(state->res, obj->pbs_db_un.pbs_db_job, state->row);
 }
 
+/**
+ * @brief
+ *	Declare a server side cursor over all the jobs, in the same order as
+ *	pbs_db_find_job(). The cursor is declared WITH HOLD so that it
+ *	survives the implicit commit and other statements can be run on the
+ *	connection while rows are being fetched from it.
+ *
+ * @param[in]	conn   - Connection handle
+ * @param[in]	cursor - Name of the cursor to declare
+ * @param[in]	opts   - Any other options (like flags, timestamp), unused
+ *
+ * @return      Error code
+ * @retval	-1 - Failure
+ * @retval	 0 - Success
+ *
+ */
+int
+pbs_db_declare_job_cursor(void *conn, char *cursor, pbs_db_query_options_t *opts)
+{
+	char conn_sql[MAX_SQL_LENGTH];
+
+	snprintf(conn_sql, MAX_SQL_LENGTH, "declare %s no scroll cursor with hold for "
+		"select " JOB_FIND_COLUMNS
+		"from pbs.job order by ji_qrank", cursor);
+
+	return (db_execute_str(conn, conn_sql) == -1 ? -1 : 0);
+}
+
 /**
  * @brief
  *	Delete the job from the database
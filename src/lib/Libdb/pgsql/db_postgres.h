@@ -215,15 +215,19 @@ struct db_query_state {
 };
 typedef struct db_query_state db_query_state_t;
 
+/* name of the server side cursor used by pbs_db_cursor_open() */
+#define DB_SEARCH_CURSOR "pbs_search_cur"
+
 /**
  * @brief
- * Each database object type supports most of the following 6 operations:
+ * Each database object type supports most of the following 7 operations:
  *	- insertion
  *	- updation
  *	- deletion
  *	- loading
  *	- find rows matching a criteria
  *	- get next row from a cursor (created in a find command)
+ *	- declare a server side cursor over all rows, see pbs_db_cursor_open()
  *
  * The following structure has function pointers to all the above described
  * operations.
@@ -236,6 +240,7 @@ struct postgres_db_fn {
 	int (*pbs_db_find_obj) (void *conn, void *state, pbs_db_obj_info_t *obj, pbs_db_query_options_t *opts);
 	int (*pbs_db_next_obj) (void *conn, void *state, pbs_db_obj_info_t *obj);
 	int (*pbs_db_del_attr_obj)(void *conn, void *obj_id, pbs_db_attr_list_t *attr_list);
+	int (*pbs_db_declare_cursor)(void *conn, char *cursor, pbs_db_query_options_t *opts);
 };
 
 typedef struct postgres_db_fn pg_db_fn_t;
@@ -348,6 +353,7 @@ int pbs_db_save_job(void *conn, pbs_db_obj_info_t *obj, int savetype);
 int pbs_db_load_job(void *conn, pbs_db_obj_info_t *obj);
 int pbs_db_find_job(void *conn, void *st, pbs_db_obj_info_t *obj, pbs_db_query_options_t *opts);
 int pbs_db_next_job(void *conn, void *st, pbs_db_obj_info_t *obj);
+int pbs_db_declare_job_cursor(void *conn, char *cursor, pbs_db_query_options_t *opts);
 int pbs_db_delete_job(void *conn, pbs_db_obj_info_t *obj);
 
 int pbs_db_save_jobscr(void *conn, pbs_db_obj_info_t *obj, int savetype);
@@ -774,6 +774,71 @@ dis_puts(int fd, const char *str, size_t ct)
 	return ct;
 }
 
+/**
+ * @brief
+ * 	dis_wmark - return the current offset into the write buffer, to be
+ *	given later to dis_wcopy()
+ *
+ * @param[in] fd - file descriptor
+ *
+ * @return	long
+ *
+ * @retval	>= 0	offset of the next character to be written
+ * @retval	-1 	if no channel or nothing written yet
+ *
+ * @par Side Effects:
+ *	None
+ *
+ * @par MT-safe: Yes
+ *
+ */
+long
+dis_wmark(int fd)
+{
+	pbs_dis_buf_t *tp = dis_get_writebuf(fd);
+
+	if (tp == NULL || tp->tdis_len <= 0)
+		return -1;
+	return (long) (tp->tdis_pos - tp->tdis_data);
+}
+
+/**
+ * @brief
+ * 	dis_wcopy - copy what was put into the write buffer since mark
+ *
+ * @param[in] fd - file descriptor
+ * @param[in] mark - offset returned by dis_wmark()
+ * @param[out] ct - number of characters copied
+ *
+ * @return	char *
+ *
+ * @retval	malloc-ed copy of the characters, caller must free
+ * @retval	NULL 	if error or nothing written since mark
+ *
+ * @par Side Effects:
+ *	None
+ *
+ * @par MT-safe: Yes
+ *
+ */
+char *
+dis_wcopy(int fd, long mark, size_t *ct)
+{
+	pbs_dis_buf_t *tp = dis_get_writebuf(fd);
+	char *copy;
+	size_t len;
+
+	*ct = 0;
+	if (tp == NULL || mark < 0 || (tp->tdis_data + mark) >= tp->tdis_pos)
+		return NULL;
+	len = tp->tdis_pos - (tp->tdis_data + mark);
+	if ((copy = malloc(len)) == NULL)
+		return NULL;
+	memcpy(copy, tp->tdis_data + mark, len);
+	*ct = len;
+	return copy;
+}
+
 /**
  * @brief
  *	flush dis write buffer
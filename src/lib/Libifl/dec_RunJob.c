@@ -43,6 +43,7 @@
  * @file	dec_RunJob.c
  * @brief
  * decode_DIS_RunJob() - decode a Run Job batch request
+ * decode_DIS_RunJobList() - decode a Run Job List batch request
  *
  *	The batch_request structure must already exist (be allocated by the
  *	caller.   It is assumed that the header fields (protocol type,
@@ -52,6 +53,9 @@
  * 			string		job id
  *			string		destination
  *			unsigned int	resource_handle
+ *
+ * @par A Run Job List is an unsigned int count followed by that many
+ *	of the above.
  */
 
 #include <pbs_config.h>   /* the master config generated by configure */
@@ -105,3 +109,62 @@ decode_DIS_Run(int sock, struct batch_request *preq)
 	preq->rq_ind.rq_run.rq_resch = disrul(sock, &rc);
 	return rc;
 }
+
+/**
+ * @brief-
+ *	decode a Run Job List batch request
+ *
+ * @par	Functionality:
+ *		Decodes the count and then one job id, destination and
+ *		resource handle per job into rq_runjoblist.  The resource
+ *		handle is only used by reservations and is discarded.
+ *
+ * @param[in] sock - socket descriptor
+ * @param[out] preq - pointer to batch_request structure
+ *
+ * @return      int
+ * @retval      DIS_SUCCESS(0)  success
+ * @retval      error code      error
+ *
+ */
+
+int
+decode_DIS_RunJobList(int sock, struct batch_request *preq)
+{
+	int rc;
+	int count;
+	int i;
+	char **jobs;
+	char **destins;
+
+	preq->rq_ind.rq_runjoblist.rq_count = 0;
+	preq->rq_ind.rq_runjoblist.rq_jobslist = NULL;
+	preq->rq_ind.rq_runjoblist.rq_destinlist = NULL;
+
+	count = disrui(sock, &rc);
+	if (rc) return rc;
+
+	jobs = calloc(count + 1, sizeof(char *));
+	if (jobs == NULL)
+		return DIS_NOMALLOC;
+	destins = calloc(count + 1, sizeof(char *));
+	if (destins == NULL) {
+		free(jobs);
+		return DIS_NOMALLOC;
+	}
+	/* set up front so free_br() releases whatever was read on error */
+	preq->rq_ind.rq_runjoblist.rq_jobslist = jobs;
+	preq->rq_ind.rq_runjoblist.rq_destinlist = destins;
+
+	for (i = 0; i < count; i++) {
+		jobs[i] = disrst(sock, &rc);
+		if (rc) return rc;
+		destins[i] = disrst(sock, &rc);
+		if (rc) return rc;
+		(void)disrul(sock, &rc);
+		if (rc) return rc;
+		preq->rq_ind.rq_runjoblist.rq_count = i + 1;
+	}
+
+	return rc;
+}
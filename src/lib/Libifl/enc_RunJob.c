@@ -43,11 +43,15 @@
  * @file	enc_RunJob.c
  * @brief
  * encode_DIS_RunJob() - encode a Run Job Batch Request
+ * encode_DIS_RunJobList() - encode a Run Job List Batch Request
  *
  * @par Data items are:
  * 			string		job id
  *			string		destination
  *			unsigned int	resource handle (currently 0)
+ *
+ * @par A Run Job List is an unsigned int count followed by that many
+ *	of the above.
  */
 
 #include <pbs_config.h>   /* the master config generated by configure */
@@ -89,3 +93,34 @@ encode_DIS_Run(int sock, char *id, char *where, unsigned long arg)
 
 	return 0;
 }
+
+/**
+ * @brief
+ *	-used to encode the jobs and destinations of a RunJobList request
+ *
+ * @param[in] sock - socket descriptor
+ * @param[in] jobids - job ids to run
+ * @param[in] destins - execvnode for each entry in jobids
+ * @param[in] count - number of entries in jobids and destins
+ *
+ * @return      int
+ * @retval      DIS_SUCCESS(0)  success
+ * @retval      error code      error
+ *
+ */
+
+int
+encode_DIS_RunJobList(int sock, char **jobids, char **destins, int count)
+{
+	int rc;
+	int i;
+
+	if ((rc = diswui(sock, count)) != 0)
+		return rc;
+
+	for (i = 0; i < count; i++)
+		if ((rc = encode_DIS_Run(sock, jobids[i], destins[i], 0)) != 0)
+			return rc;
+
+	return 0;
+}
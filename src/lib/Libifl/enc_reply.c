@@ -58,6 +58,63 @@
 
 int encode_DIS_svrattrl(int sock, svrattrl *psattl);
 
+/**
+ * @brief
+ *	free_brp_blob - drop a reference to a pre-encoded status attribute
+ *	list, freeing it when the last reference goes
+ *
+ * @param[in]	blob - blob to release, may be NULL
+ *
+ * @return	void
+ */
+void
+free_brp_blob(struct brp_blob *blob)
+{
+	if ((blob == NULL) || (--blob->bb_refct > 0))
+		return;
+	free(blob->bb_data);
+	free(blob);
+}
+
+/**
+ * @brief
+ *	encode_DIS_status_attrs - encode the attribute list of one status
+ *	reply entry
+ *
+ * @par
+ *	If the entry carries a blob which was already filled in, its bytes
+ *	are put into the reply as is.  If it carries an empty blob, the
+ *	attribute list is encoded and what was written is saved into the
+ *	blob for the next reply about the same object.
+ *
+ * @param[in]	sock - socket descriptor
+ * @param[in]	pstat - status reply entry
+ *
+ * @return	int
+ * @retval	DIS_SUCCESS(0)	success
+ * @retval	error code	error
+ */
+static int
+encode_DIS_status_attrs(int sock, struct brp_status *pstat)
+{
+	struct brp_blob *blob = pstat->brp_blob;
+	long mark = -1;
+	int rc;
+
+	if ((blob != NULL) && (blob->bb_len > 0)) {
+		if (dis_puts(sock, blob->bb_data, blob->bb_len) != (int) blob->bb_len)
+			return DIS_PROTO;
+		return DIS_SUCCESS;
+	}
+
+	if (blob != NULL)
+		mark = dis_wmark(sock);
+	rc = encode_DIS_svrattrl(sock, (svrattrl *) GET_NEXT(pstat->brp_attr));
+	if ((rc == DIS_SUCCESS) && (mark >= 0))
+		blob->bb_data = dis_wcopy(sock, mark, &blob->bb_len);
+	return rc;
+}
+
 
 /**
  * @brief-
@@ -83,7 +140,6 @@ encode_DIS_reply_inner(int sock, struct batch_reply *reply)
 	struct brp_select *psel;
 	struct brp_status *pstat;
 	struct batch_deljob_status *pdelstat;
-	svrattrl *psvrl;
 	preempt_job_info *ppj;
 
 	int rc;
@@ -139,8 +195,7 @@ encode_DIS_reply_inner(int sock, struct batch_reply *reply)
 				if ((rc = diswui(sock, pstat->brp_objtype)) || (rc = diswst(sock, pstat->brp_objname)))
 					return rc;
 
-				psvrl = (svrattrl *) GET_NEXT(pstat->brp_attr);
-				if ((rc = encode_DIS_svrattrl(sock, psvrl)) != 0)
+				if ((rc = encode_DIS_status_attrs(sock, pstat)) != 0)
 					return rc;
 				pstat = (struct brp_status *) GET_NEXT(pstat->brp_stlink);
 			}
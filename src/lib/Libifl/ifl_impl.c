@@ -499,6 +499,26 @@ pbs_runjob(int c, char *jobid, char *location, char *extend) {
 	return (*pfn_pbs_runjob)(c, jobid, location, extend);
 }
 
+/**
+ * @brief
+ *	-Pass-through call to send a run job list batch request
+ *
+ * @param[in] c - communication handle
+ * @param[in] jobids - job identifiers
+ * @param[in] locations - where to run each job in jobids
+ * @param[in] numjids - number of jobs
+ * @param[in] extend - extend string to encode req
+ *
+ * @return	struct batch_deljob_status *
+ * @retval	list of jobs which could not be run (or NULL)
+ *
+ */
+struct batch_deljob_status *
+pbs_runjoblist(int c, char **jobids, char **locations, int numjids, char *extend)
+{
+	return (*pfn_pbs_runjoblist)(c, jobids, locations, numjids, extend);
+}
+
 /**
  * @brief
  *	-Pass-through call to send SelectJob request
@@ -65,6 +65,7 @@ int (*pfn_pbs_orderjob)(int, char *, char *, char *) = __pbs_orderjob;
 int (*pfn_pbs_rerunjob)(int, char *, char *) = __pbs_rerunjob;
 int (*pfn_pbs_rlsjob)(int, char *, char *, char *) = __pbs_rlsjob;
 int (*pfn_pbs_runjob)(int, char *, char *, char *) = __pbs_runjob;
+struct batch_deljob_status *(*pfn_pbs_runjoblist)(int, char **, char **, int, char *) = __pbs_runjoblist;
 char **(*pfn_pbs_selectjob)(int, struct attropl *, char *) = __pbs_selectjob;
 int (*pfn_pbs_sigjob)(int, char *, char *, char *) = __pbs_sigjob;
 void (*pfn_pbs_statfree)(struct batch_status *) = __pbs_statfree;
@@ -237,3 +237,191 @@ __pbs_runjob(int c, char *jobid, char *location, char *extend)
 {
 	return __runjob_helper(c, jobid, location, extend, PBS_BATCH_RunJob);
 }
+
+/**
+ * @brief	Send one RunJobList request and read back the list of jobs
+ *		the server could not run
+ *
+ * @param[in] c - instance connection handle
+ * @param[in] jobids - job identifiers
+ * @param[in] locations - where to run each job in jobids
+ * @param[in] numjids - number of jobs
+ * @param[in] extend - extend string for encoding req
+ *
+ * @return	struct batch_deljob_status *
+ * @retval	list of jobs which could not be run, NULL if all were
+ *		accepted or on error (pbs_errno set)
+ */
+static struct batch_deljob_status *
+__runjoblist_inner(int c, char **jobids, char **locations, int numjids, char *extend)
+{
+	int rc;
+	struct batch_reply *reply;
+	struct batch_deljob_status *ret = NULL;
+
+	if (pbs_client_thread_lock_connection(c) != 0)
+		return NULL;
+
+	DIS_tcp_funcs();
+
+	if ((rc = encode_DIS_ReqHdr(c, PBS_BATCH_RunJobList, pbs_current_user)) ||
+		(rc = encode_DIS_RunJobList(c, jobids, locations, numjids)) ||
+		(rc = encode_DIS_ReqExtend(c, extend))) {
+		if (set_conn_errtxt(c, dis_emsg[rc]) != 0)
+			pbs_errno = PBSE_SYSTEM;
+		else
+			pbs_errno = PBSE_PROTOCOL;
+		pbs_client_thread_unlock_connection(c);
+		return NULL;
+	}
+
+	if (dis_flush(c)) {
+		pbs_errno = PBSE_PROTOCOL;
+		pbs_client_thread_unlock_connection(c);
+		return NULL;
+	}
+
+	reply = PBSD_rdrpy(c);
+	if (reply == NULL && pbs_errno == PBSE_NONE)
+		pbs_errno = PBSE_PROTOCOL;
+	else if (reply != NULL && reply->brp_choice != BATCH_REPLY_CHOICE_NULL &&
+		 reply->brp_choice != BATCH_REPLY_CHOICE_Text &&
+		 reply->brp_choice != BATCH_REPLY_CHOICE_Delete)
+		pbs_errno = PBSE_PROTOCOL;
+	else if (reply != NULL && reply->brp_choice == BATCH_REPLY_CHOICE_Delete) {
+		ret = reply->brp_un.brp_deletejoblist.brp_delstatc;
+		reply->brp_un.brp_deletejoblist.brp_delstatc = NULL;
+	}
+	PBSD_FreeReply(reply);
+
+	if (pbs_client_thread_unlock_connection(c) != 0) {
+		pbs_delstatfree(ret);
+		return NULL;
+	}
+
+	return ret;
+}
+
+/**
+ * @brief
+ *	-send a run job list batch request
+ *	Starts many jobs with one request.  Each job is validated and
+ *	started as if it had been sent by pbs_asyrunjob_ack(), the server
+ *	replies once the whole list has been handed to the MoMs.
+ *
+ * @par	MT-safe: Yes
+ *
+ * @param[in] c - connection handle
+ * @param[in] jobids - job identifiers
+ * @param[in] locations - where to run each job in jobids
+ * @param[in] numjids - number of jobs
+ * @param[in] extend - extend string for encoding req
+ *
+ * @return	struct batch_deljob_status *
+ * @retval	list of jobs which could not be run with the error for each
+ * @retval	NULL if every job was accepted (pbs_errno == PBSE_NONE) or
+ *		if the request failed as a whole (pbs_errno set)
+ */
+struct batch_deljob_status *
+__pbs_runjoblist(int c, char **jobids, char **locations, int numjids, char *extend)
+{
+	svr_conn_t **svr_conns;
+	struct batch_deljob_status *failed = NULL;
+	struct batch_deljob_status *unknown = NULL;
+	struct batch_deljob_status *ret;
+	struct batch_deljob_status *pdel;
+	struct batch_deljob_status *next;
+	char **sjobs = jobids;
+	char **slocs = locations;
+	int nsend = numjids;
+	int nsvr = get_num_servers();
+	int i;
+	int j;
+
+	if ((jobids == NULL) || (locations == NULL) || (numjids <= 0)) {
+		pbs_errno = PBSE_IVALREQ;
+		return NULL;
+	}
+
+	/* initialize the thread context data, if not already initialized */
+	if (pbs_client_thread_init_thread_context() != 0)
+		return NULL;
+
+	svr_conns = get_conn_svr_instances(c);
+	if (svr_conns == NULL) {
+		/* Not a cluster fd. Treat it as an instance fd */
+		return __runjoblist_inner(c, jobids, locations, numjids, extend);
+	}
+
+	/*
+	 * Send the whole list to the first server that is up, then resend
+	 * the jobs it did not know about to the next one, the same way
+	 * __runjob_helper() walks the servers for a single job
+	 */
+	for (i = 0; i < nsvr && nsend > 0; i++) {
+		if (!svr_conns[i] || svr_conns[i]->state != SVR_CONN_STATE_UP)
+			continue;
+
+		ret = __runjoblist_inner(svr_conns[i]->sd, sjobs, slocs, nsend, extend);
+		if (pbs_errno != PBSE_NONE) {
+			pbs_delstatfree(ret);
+			goto done;
+		}
+
+		pbs_delstatfree(unknown);
+		unknown = NULL;
+		for (pdel = ret; pdel != NULL; pdel = next) {
+			next = pdel->next;
+			if (pdel->code == PBSE_UNKJOBID) {
+				pdel->next = unknown;
+				unknown = pdel;
+			} else {
+				pdel->next = failed;
+				failed = pdel;
+			}
+		}
+
+		if (sjobs != jobids) {
+			free(sjobs);
+			free(slocs);
+		}
+		sjobs = NULL;
+		slocs = NULL;
+		nsend = 0;
+		for (pdel = unknown; pdel != NULL; pdel = pdel->next)
+			nsend++;
+		if (nsend == 0)
+			break;
+
+		sjobs = malloc(nsend * sizeof(char *));
+		slocs = malloc(nsend * sizeof(char *));
+		if (sjobs == NULL || slocs == NULL) {
+			pbs_errno = PBSE_SYSTEM;
+			goto done;
+		}
+		for (nsend = 0, pdel = unknown; pdel != NULL; pdel = pdel->next) {
+			for (j = 0; j < numjids; j++) {
+				if (strcmp(jobids[j], pdel->name) == 0) {
+					sjobs[nsend] = jobids[j];
+					slocs[nsend] = locations[j];
+					nsend++;
+					break;
+				}
+			}
+		}
+	}
+
+done:
+	if (sjobs != jobids) {
+		free(sjobs);
+		free(slocs);
+	}
+	/* jobs no server knew about are failures too */
+	if (unknown != NULL) {
+		for (pdel = unknown; pdel->next != NULL; pdel = pdel->next)
+			;
+		pdel->next = failed;
+		failed = unknown;
+	}
+	return failed;
+}
@@ -67,6 +67,9 @@
 #include <signal.h>
 #include <stddef.h>
 #include <stdarg.h>
+#ifndef WIN32
+#include <sys/uio.h>
+#endif
 
 #include "log.h"
 #include "pbs_ifl.h"
@@ -107,6 +110,26 @@ static volatile int log_opened = 0;
 static int syslogopen = 0;
 #endif /* SYSLOG */
 
+/*
+ * Asynchronous logging, see log_set_async().  Formatted records are
+ * appended to a ring of bytes under log_write_mutex and written out in
+ * batches by a writer thread.  head and tail only grow, the byte of a
+ * position is at (pos % LOG_ASYNC_BUFSIZE).  Records which do not fit
+ * are dropped and counted rather than blocking the caller.
+ */
+#define LOG_ASYNC_BUFSIZE	(4 * 1024 * 1024)
+static char *log_async_buf;
+static unsigned long log_async_head;	/* next byte to be written out */
+static unsigned long log_async_tail;	/* next byte to be filled */
+static unsigned long log_async_dropped;	/* records dropped since last reported */
+static unsigned long log_async_switch_at;	/* position of the first record of a new day */
+static int log_async_switch_pending;	/* writer must switch log files at log_async_switch_at */
+static int log_async_wanted;		/* set by log_set_async() */
+static volatile int log_async_running;	/* writer thread is running */
+static int log_async_stopping;		/* writer thread is asked to drain and exit */
+static pthread_t log_async_tid;
+static pthread_cond_t log_async_cond = PTHREAD_COND_INITIALIZER;
+
 /*
  * the order of these names MUST match the defintions of
  * PBS_EVENTCLASS_* in log.h
@@ -140,6 +163,10 @@ static int log_mutex_unlock();
 static void get_timestamp(ms_time *mst);
 static void log_record_inner(int eventtype, int objclass, int sev, const char *objname, const char *text, ms_time *mst);
 static void log_console_error(char *);
+#ifndef WIN32
+static int log_async_start(void);
+static void log_async_stop(void);
+#endif
 
 void
 set_log_conf(char *leafname, char *nodename,
@@ -357,6 +384,17 @@ log_parent_post_fork_handler()
 static void
 log_child_post_fork_handler()
 {
+	/*
+	 * The writer thread is not copied into the child.  Leave the records
+	 * buffered so far to the parent and log synchronously from here on.
+	 */
+	if (log_async_running) {
+		log_async_running = 0;
+		log_async_wanted = 0;
+		log_async_stopping = 0;
+		log_async_head = log_async_tail;
+		log_async_switch_pending = 0;
+	}
 	log_mutex_unlock();
 }
 #endif
@@ -642,6 +680,11 @@ log_open_main(char *filename, char *directory, int silent)
 			log_add_debug_info();
 			log_add_if_info();
 		}
+#ifndef WIN32
+		/* restart the writer after the log was closed and reopened */
+		if (log_async_wanted && !log_async_running)
+			(void)log_async_start();
+#endif
 	}
 #if SYSLOG
 	if (syslogopen == 0 && syslogfac > 0 && syslogfac < 10) {
@@ -970,6 +1013,309 @@ log_console_error(char *msg)
 	}
 }
 
+#ifndef WIN32
+/**
+ * @brief
+ * 	format a record into the ring for the writer thread.
+ *	Must be called with log_write_mutex held.
+ *
+ * @param[in] eventtype - event type
+ * @param[in] objclass - event object class
+ * @param[in] objname - object name stating log msg related to which object
+ * @param[in] text - log msg to be logged
+ * @param[in] mst - the ms_time format timestamp
+ */
+static void
+log_async_put(int eventtype, int objclass, const char *objname, const char *text, ms_time *mst)
+{
+	char buf[LOG_BUF_SIZE + 512];
+	char *rec = buf;
+	unsigned long pos;
+	size_t off;
+	size_t first;
+	int len;
+
+	/* the writer switches files, the records of the new day start here */
+	if (log_auto_switch && !log_async_switch_pending &&
+	    (mst->ptm.tm_yday != log_open_day)) {
+		log_async_switch_pending = 1;
+		log_async_switch_at = log_async_tail;
+	}
+
+	len = snprintf(buf, sizeof(buf),
+		"%02d/%02d/%04d %02d:%02d:%02d%s;%04x;%s;%s;%s;%s\n",
+		mst->ptm.tm_mon + 1, mst->ptm.tm_mday, mst->ptm.tm_year + 1900,
+		mst->ptm.tm_hour, mst->ptm.tm_min, mst->ptm.tm_sec, mst->microsec_buf,
+		eventtype & ~PBSEVENT_FORCE, msg_daemonname,
+		class_names[objclass], objname, text);
+	if (len < 0)
+		return;
+	if (len >= sizeof(buf)) {
+		if ((rec = malloc(len + 1)) == NULL)
+			return;
+		snprintf(rec, len + 1,
+			"%02d/%02d/%04d %02d:%02d:%02d%s;%04x;%s;%s;%s;%s\n",
+			mst->ptm.tm_mon + 1, mst->ptm.tm_mday, mst->ptm.tm_year + 1900,
+			mst->ptm.tm_hour, mst->ptm.tm_min, mst->ptm.tm_sec, mst->microsec_buf,
+			eventtype & ~PBSEVENT_FORCE, msg_daemonname,
+			class_names[objclass], objname, text);
+	}
+
+	if (log_async_tail - log_async_head + len > LOG_ASYNC_BUFSIZE) {
+		log_async_dropped++;
+	} else {
+		pos = log_async_tail;
+		off = pos % LOG_ASYNC_BUFSIZE;
+		first = LOG_ASYNC_BUFSIZE - off;
+		if (first >= len)
+			memcpy(log_async_buf + off, rec, len);
+		else {
+			memcpy(log_async_buf + off, rec, first);
+			memcpy(log_async_buf, rec + first, len - first);
+		}
+		log_async_tail = pos + len;
+		pthread_cond_signal(&log_async_cond);
+	}
+
+	if (rec != buf)
+		free(rec);
+}
+
+/**
+ * @brief
+ * 	write a range of the ring to the log file
+ *
+ * @param[in] from - first position to write
+ * @param[in] to - position after the last one to write
+ *
+ * @return int
+ * @retval 0 - success
+ * @retval -1 - write failed
+ */
+static int
+log_async_write(unsigned long from, unsigned long to)
+{
+	struct iovec iov[2];
+	size_t off;
+	ssize_t n;
+	int cnt;
+	int fd;
+
+	if ((logfile == NULL) || (log_opened <= 0))
+		return -1;
+	fd = fileno(logfile);
+
+	while (from < to) {
+		off = from % LOG_ASYNC_BUFSIZE;
+		iov[0].iov_base = log_async_buf + off;
+		if (off + (to - from) <= LOG_ASYNC_BUFSIZE) {
+			iov[0].iov_len = to - from;
+			cnt = 1;
+		} else {
+			iov[0].iov_len = LOG_ASYNC_BUFSIZE - off;
+			iov[1].iov_base = log_async_buf;
+			iov[1].iov_len = (to - from) - iov[0].iov_len;
+			cnt = 2;
+		}
+		n = writev(fd, iov, cnt);
+		if (n < 0) {
+			if (errno == EINTR)
+				continue;
+			return -1;
+		}
+		from += n;
+	}
+	return 0;
+}
+
+/**
+ * @brief
+ * 	main of the writer thread, writes out the ring in batches until
+ *	asked to stop, then drains it and exits.
+ *
+ * @param[in] arg - unused
+ *
+ * @return void *
+ */
+static void *
+log_async_writer(void *arg)
+{
+	unsigned long from;
+	unsigned long to;
+	unsigned long dropped;
+	char msg[128];
+	ms_time mst;
+
+	if (log_mutex_lock() != 0)
+		return NULL;
+	for (;;) {
+		while ((log_async_head == log_async_tail) && !log_async_switch_pending && !log_async_stopping)
+			pthread_cond_wait(&log_async_cond, &log_write_mutex);
+
+		if (log_async_switch_pending && (log_async_head == log_async_switch_at)) {
+			/* producers wait while the files are switched, once a day */
+			log_close(1);
+			log_open(NULL, log_directory);
+			if (log_opened < 1)
+				log_console_error("PBS cannot open its log");
+			log_async_switch_pending = 0;
+			continue;
+		}
+		if (log_async_head == log_async_tail) {
+			if (log_async_stopping) {
+				log_async_running = 0;
+				break;
+			}
+			continue;
+		}
+
+		from = log_async_head;
+		to = log_async_switch_pending ? log_async_switch_at : log_async_tail;
+		dropped = log_async_dropped;
+		log_async_dropped = 0;
+		log_mutex_unlock();
+
+		if (log_async_write(from, to) != 0)
+			log_console_error("PBS cannot write to its log");
+		if (dropped > 0) {
+			snprintf(msg, sizeof(msg), "%lu log records dropped, the log writer fell behind", dropped);
+			get_timestamp(&mst);
+			log_record_inner(PBSEVENT_ERROR | PBSEVENT_FORCE, PBS_EVENTCLASS_SERVER, LOG_WARNING, "Log", msg, &mst);
+		}
+
+		if (log_mutex_lock() != 0)
+			return NULL;
+		log_async_head = to;
+	}
+	log_mutex_unlock();
+	return NULL;
+}
+
+/**
+ * @brief
+ * 	start the writer thread, with all signals blocked so they keep
+ *	going to the daemon's own threads.
+ *
+ * @return int
+ * @retval 0 - success
+ * @retval -1 - failure, logging stays synchronous
+ */
+static int
+log_async_start(void)
+{
+	sigset_t block_mask;
+	sigset_t old_mask;
+	int rc;
+
+	if (log_async_buf == NULL) {
+		if ((log_async_buf = malloc(LOG_ASYNC_BUFSIZE)) == NULL)
+			return -1;
+	}
+
+	sigfillset(&block_mask);
+	pthread_sigmask(SIG_BLOCK, &block_mask, &old_mask);
+	log_async_head = log_async_tail = 0;
+	log_async_switch_pending = 0;
+	log_async_stopping = 0;
+	log_async_running = 1;
+	rc = pthread_create(&log_async_tid, NULL, log_async_writer, NULL);
+	if (rc != 0)
+		log_async_running = 0;
+	pthread_sigmask(SIG_SETMASK, &old_mask, NULL);
+
+	return (rc == 0) ? 0 : -1;
+}
+
+/**
+ * @brief
+ * 	have the writer thread write out everything buffered and wait for
+ *	it to exit.  Logging is synchronous afterwards.
+ */
+static void
+log_async_stop(void)
+{
+	if (!log_async_running || (log_mutex_lock() != 0))
+		return;
+	log_async_stopping = 1;
+	pthread_cond_signal(&log_async_cond);
+	log_mutex_unlock();
+	pthread_join(log_async_tid, NULL);
+	log_async_stopping = 0;
+}
+
+/**
+ * @brief
+ * 	write out the buffered records at process exit
+ */
+static void
+log_async_atexit(void)
+{
+	if (log_async_running)
+		log_async_stop();
+}
+#endif
+
+/**
+ * @brief
+ * 	log_set_async - switch between logging synchronously and handing the
+ *	records to a writer thread.  Asynchronous logging keeps slow disks
+ *	and high log_events settings from stalling the daemon, at the price
+ *	of dropping records when the writer falls behind by more than
+ *	LOG_ASYNC_BUFSIZE bytes.
+ *
+ *	Call it after the daemon has forked into the background, the writer
+ *	thread does not survive a fork and children log synchronously.
+ *
+ * @param[in] enable - 1 to log asynchronously, 0 to log synchronously
+ *
+ * @return int
+ * @retval 0 - success
+ * @retval -1 - the writer thread could not be started
+ */
+int
+log_set_async(int enable)
+{
+#ifndef WIN32
+	static int atexit_set = 0;
+
+	pthread_once(&log_once_ctl, log_init); /* initialize mutex once */
+
+	if (!enable) {
+		log_async_wanted = 0;
+		log_async_stop();
+		return 0;
+	}
+	log_async_wanted = 1;
+	if (!atexit_set) {
+		atexit(log_async_atexit);
+		atexit_set = 1;
+	}
+	if (log_async_running || (log_opened <= 0))
+		return 0;	/* started by log_open() otherwise */
+	return log_async_start();
+#else
+	return 0;
+#endif
+}
+
+/**
+ * @brief
+ * 	log_async_flush - write out the buffered records without locking.
+ *	Only for the way down from a fatal signal, when the writer thread
+ *	cannot be relied on anymore.  Records may be written twice if the
+ *	writer was in the middle of a batch.
+ */
+void
+log_async_flush(void)
+{
+#ifndef WIN32
+	if (log_async_running) {
+		(void)log_async_write(log_async_head, log_async_tail);
+		log_async_head = log_async_tail;
+	}
+#endif
+}
+
 /**
  * @brief
  * 	log a message to the log file - this function acquires a lock
@@ -1013,10 +1359,23 @@ log_record(int eventtype, int objclass, int sev, const char *objname, const char
 	}
 #endif  /* SYSLOG */
 
-	if (log_opened <= 0)
+	if ((text == NULL) || (objname == NULL))
 		goto sigunblock;
 
-	if ((text == NULL) || (objname == NULL))
+#ifndef WIN32
+	if (log_async_running && (log_mutex_lock() == 0)) {
+		/* check again, the writer may have stopped meanwhile */
+		if (log_async_running) {
+			get_timestamp(&mst);
+			log_async_put(eventtype, objclass, objname, text, &mst);
+			log_mutex_unlock();
+			goto sigunblock;
+		}
+		log_mutex_unlock();
+	}
+#endif
+
+	if (log_opened <= 0)
 		goto sigunblock;
 
 	/* lock the file mutex */
@@ -1095,6 +1454,11 @@ log_record_inner(int eventtype, int objclass, int sev, const char *objname, cons
 void
 log_close(int msg)
 {
+#ifndef WIN32
+	/* write out what is buffered first, unless the writer is switching files */
+	if (log_async_running && !pthread_equal(pthread_self(), log_async_tid))
+		log_async_stop();
+#endif
 	if (log_opened == 1) {
 		log_auto_switch = 0;
 		if (msg) {
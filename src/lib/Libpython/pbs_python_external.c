@@ -57,11 +57,13 @@
 #include <pbs_python_private.h> /* private python file  */
 #include <eval.h>               /* For PyEval_EvalCode  */
 #include <pythonrun.h>          /* For Py_SetPythonHome */
+#include <marshal.h>            /* For PyMarshal_* */
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <signal.h>
 #include <unistd.h>
 #include <wchar.h>
+#include <stdio.h>
 
 extern PyObject* PyInit__pbs_ifl(void);
 
@@ -74,6 +76,11 @@ static struct _inittab pbs_python_inittab_modules[] = {
 static PyObject *
 _pbs_python_compile_file(const char *file_name,
 	const char *compiled_code_file_name);
+static PyObject *
+_pbs_python_load_code_cache(const char *file_name, struct stat *sbuf);
+static void
+_pbs_python_save_code_cache(const char *file_name, struct stat *sbuf,
+	PyObject *code_obj);
 extern int pbs_python_setup_namespace_dict(PyObject *globals);
 
 #endif      /* PYTHON */
@@ -747,11 +754,18 @@ pbs_python_run_code_in_namespace(struct python_interpreter_data *interp_data,
 				PBSEVENT_DEBUG, PBS_EVENTCLASS_SERVER,
 				LOG_INFO, interp_data->daemon_name, log_buffer);
 
-		if (!(py_script->py_code_obj =
-			_pbs_python_compile_file(py_script->path,
-			"<embedded code object>"))) {
-			pbs_python_write_error_to_log("Failed to compile script");
-			return -2;
+		py_script->py_code_obj = _pbs_python_load_code_cache(py_script->path,
+			&py_script->cur_sbuf);
+		if (py_script->py_code_obj == NULL) {
+			if (!(py_script->py_code_obj =
+				_pbs_python_compile_file(py_script->path,
+				"<embedded code object>"))) {
+				pbs_python_write_error_to_log("Failed to compile script");
+				return -2;
+			}
+			_pbs_python_save_code_cache(py_script->path,
+				&py_script->cur_sbuf,
+				(PyObject *)py_script->py_code_obj);
 		}
 	}
 
@@ -936,5 +950,196 @@ ERROR_EXIT:
 	return rv;
 }
 
+/*
+ * Compiled hook scripts are cached in the "tmp" directory next to the
+ * script (i.e. the hooks work directory), which the daemons clean up
+ * periodically.  Scripts without such a directory (e.g. the per-run
+ * copies made for hooks running as the job owner) are not cached.
+ */
+#define PY_CODE_CACHE_DIR	"tmp"
+#define PY_CODE_CACHE_SUFFIX	".pyc"
+#define PY_CODE_CACHE_MAGIC	"PBSPYC1"
+
+/* header of a compiled code cache file, followed by the marshalled code */
+struct py_code_cache_header {
+	char	magic[8];
+	long	py_version;	/* PY_VERSION_HEX the code was compiled by */
+	long	src_size;	/* st_size of the script */
+	long	src_mtime;	/* st_mtime of the script */
+	long	src_ino;	/* st_ino of the script */
+};
+
+/**
+ * @brief
+ *	build the path of the compiled code cache file of a script
+ *
+ * @param[in]	file_name - abs file name of the script
+ * @param[out]	cache_path - the cache file path
+ * @param[in]	len - size of cache_path
+ *
+ * @return	int
+ * @retval	0	: success
+ * @retval	-1	: the script can not be cached
+ */
+static int
+_pbs_python_code_cache_path(const char *file_name, char *cache_path, size_t len)
+{
+	const char *base;
+	struct stat sbuf;
+
+	base = strrchr(file_name, '/');
+	if (base == NULL)
+		return -1;
+	base++;
+
+	snprintf(cache_path, len, "%.*s%s", (int)(base - file_name), file_name,
+		PY_CODE_CACHE_DIR);
+	if ((stat(cache_path, &sbuf) == -1) || !S_ISDIR(sbuf.st_mode))
+		return -1;
+
+	if (snprintf(cache_path, len, "%.*s%s/%s%s", (int)(base - file_name),
+		file_name, PY_CODE_CACHE_DIR, base, PY_CODE_CACHE_SUFFIX) >= (int)len)
+		return -1;
+
+	return 0;
+}
+
+/**
+ * @brief
+ *	fill in a compiled code cache header for a script
+ *
+ * @param[out]	hdr - header to fill in
+ * @param[in]	sbuf - stat of the script
+ *
+ * @return	void
+ */
+static void
+_pbs_python_code_cache_header(struct py_code_cache_header *hdr, struct stat *sbuf)
+{
+	memset(hdr, 0, sizeof(struct py_code_cache_header));
+	snprintf(hdr->magic, sizeof(hdr->magic), "%s", PY_CODE_CACHE_MAGIC);
+	hdr->py_version = PY_VERSION_HEX;
+	hdr->src_size = (long) sbuf->st_size;
+	hdr->src_mtime = (long) sbuf->st_mtime;
+	hdr->src_ino = (long) sbuf->st_ino;
+}
+
+/**
+ * @brief
+ *	load the compiled code of a script from its cache file, which saves
+ *	compiling the script on every hook run.
+ *
+ * @param[in]	file_name - abs file name of the script
+ * @param[in]	sbuf - stat of the script, used to check the cache is current
+ *
+ * @return	PyObject *
+ * @retval	the code object (new reference)
+ * @retval	NULL	: no usable cache
+ */
+static PyObject *
+_pbs_python_load_code_cache(const char *file_name, struct stat *sbuf)
+{
+	char cache_path[MAXPATHLEN + 1];
+	struct py_code_cache_header hdr;
+	struct py_code_cache_header want;
+	struct stat cbuf;
+	FILE *fp;
+	char *data;
+	size_t data_sz;
+	PyObject *code_obj = NULL;
+
+	if (_pbs_python_code_cache_path(file_name, cache_path, sizeof(cache_path)) != 0)
+		return NULL;
+
+	if ((fp = fopen(cache_path, "rb")) == NULL)
+		return NULL;
+
+	/* only trust a cache written by ourselves for this very script */
+	_pbs_python_code_cache_header(&want, sbuf);
+	if ((fstat(fileno(fp), &cbuf) == -1) ||
+		(cbuf.st_uid != geteuid()) ||
+		(cbuf.st_size <= (off_t) sizeof(hdr)) ||
+		(fread(&hdr, sizeof(hdr), 1, fp) != 1) ||
+		(memcmp(&hdr, &want, sizeof(hdr)) != 0)) {
+		fclose(fp);
+		return NULL;
+	}
+
+	data_sz = cbuf.st_size - sizeof(hdr);
+	if ((data = (char *)PyMem_Malloc(data_sz)) == NULL) {
+		fclose(fp);
+		return NULL;
+	}
+	if (fread(data, 1, data_sz, fp) == data_sz) {
+		code_obj = PyMarshal_ReadObjectFromString(data, data_sz);
+		if ((code_obj != NULL) && !PyCode_Check(code_obj))
+			Py_CLEAR(code_obj);
+		PyErr_Clear();
+	}
+	PyMem_Free(data);
+	fclose(fp);
+
+	if (code_obj != NULL) {
+		snprintf(log_buffer, LOG_BUF_SIZE-1,
+			"Loaded compiled script: <%s>", cache_path);
+		log_buffer[LOG_BUF_SIZE-1] = '\0';
+		log_event(PBSEVENT_DEBUG3, PBS_EVENTCLASS_SERVER, LOG_INFO,
+			__func__, log_buffer);
+	}
+
+	return code_obj;
+}
+
+/**
+ * @brief
+ *	save the compiled code of a script to its cache file.  The file is
+ *	written under a temporary name and renamed, so a concurrent reader
+ *	never sees a partial file.  Failures are not fatal.
+ *
+ * @param[in]	file_name - abs file name of the script
+ * @param[in]	sbuf - stat of the script
+ * @param[in]	code_obj - the compiled code
+ *
+ * @return	void
+ */
+static void
+_pbs_python_save_code_cache(const char *file_name, struct stat *sbuf,
+	PyObject *code_obj)
+{
+	char cache_path[MAXPATHLEN + 1];
+	char tmp_path[MAXPATHLEN + 1];
+	struct py_code_cache_header hdr;
+	PyObject *data;
+	FILE *fp;
+	int err;
+
+	if (_pbs_python_code_cache_path(file_name, cache_path, sizeof(cache_path)) != 0)
+		return;
+	if (snprintf(tmp_path, sizeof(tmp_path), "%s.%d", cache_path,
+		(int) getpid()) >= (int)sizeof(tmp_path))
+		return;
+
+	if ((data = PyMarshal_WriteObjectToString(code_obj, Py_MARSHAL_VERSION)) == NULL) {
+		PyErr_Clear();
+		return;
+	}
+
+	if ((fp = fopen(tmp_path, "wb")) == NULL) {
+		Py_DECREF(data);
+		return;
+	}
+
+	_pbs_python_code_cache_header(&hdr, sbuf);
+	err = (fwrite(&hdr, sizeof(hdr), 1, fp) != 1);
+	if (!err)
+		err = (fwrite(PyBytes_AS_STRING(data), 1, PyBytes_GET_SIZE(data), fp) !=
+			(size_t) PyBytes_GET_SIZE(data));
+	if (fclose(fp) != 0)
+		err = 1;
+	Py_DECREF(data);
+
+	if (err || (rename(tmp_path, cache_path) != 0))
+		(void) unlink(tmp_path);
+}
 
 #endif /* PYTHON */
@@ -632,6 +632,10 @@ tpp_init(struct tpp_config *cnf)
 		tpp_log(LOG_CRIT, __func__, "Failed to resolve address, err=%d", errno);
 		return -1;
 	}
+	if (leaf_addr_count > TPP_MAX_LEAF_ADDRS) {
+		tpp_log(LOG_CRIT, __func__, "Too many leaf addresses %d, max %d", leaf_addr_count, TPP_MAX_LEAF_ADDRS);
+		return -1;
+	}
 
 	/*
 	 * first register handlers with the transport, so these functions are called
@@ -753,29 +757,22 @@ tpp_eom(int fd)
 
 /**
  * @brief
- *	Opens a virtual connection to another leaf (another PBS daemon)
- *
- * @par Functionality:
- *	This function merely allocates a free stream slot from the array of
- *	streams and sets the destination host and port, and returns the slot
- *	index as the fd for the application to use to read/write to the virtual
- *	connection
+ *	Allocates a stream to another leaf, reusing an open one to the same
+ *	destination if asked to
  *
  * @param[in] dest_host - Hostname of the destination leaf
  * @param[in] port - The port at which the destination is available
+ * @param[in] reuse - return a fully open stream to the destination if any
  *
  * @return - The file descriptor that APP must use to do the IO
  * @retval -1   - Function failed
  * @retval !=-1 - Success, the fd for the APP to use is returned
  *
- * @par Side Effects:
- *	None
- *
  * @par MT-safe: Yes
  *
  */
-int
-tpp_open(char *dest_host, unsigned int port)
+static int
+open_stream(char *dest_host, unsigned int port, int reuse)
 {
 	stream_t *strm;
 	char *dest;
@@ -798,29 +795,31 @@ tpp_open(char *dest_host, unsigned int port)
 	memcpy(&dest_addr, addrs, sizeof(tpp_addr_t));
 	free(addrs);
 
-	tpp_read_lock(&strmarray_lock); /* walking the idx, so read lock */
+	if (reuse) {
+		tpp_read_lock(&strmarray_lock); /* walking the idx, so read lock */
 
-	/*
-	 * Just try to find a fully open stream to use, else fall through
-	 * to create a new stream. Any half closed streams will be closed
-	 * elsewhere, either when network first dropped or if any message
-	 * comes to such a half open stream
-	 */
-	while (pbs_idx_find(streams_idx, &pdest_addr, (void **)&strm, &idx_ctx) == PBS_IDX_RET_OK) {
-		if (memcmp(pdest_addr, &dest_addr, sizeof(tpp_addr_t)) != 0)
-			break;
-		if (strm->u_state == TPP_STRM_STATE_OPEN && strm->t_state == TPP_TRNS_STATE_OPEN && strm->used_locally == 1) {
-			tpp_unlock_rwlock(&strmarray_lock);
-			pbs_idx_free_ctx(idx_ctx);
+		/*
+		 * Just try to find a fully open stream to use, else fall through
+		 * to create a new stream. Any half closed streams will be closed
+		 * elsewhere, either when network first dropped or if any message
+		 * comes to such a half open stream
+		 */
+		while (pbs_idx_find(streams_idx, &pdest_addr, (void **)&strm, &idx_ctx) == PBS_IDX_RET_OK) {
+			if (memcmp(pdest_addr, &dest_addr, sizeof(tpp_addr_t)) != 0)
+				break;
+			if (strm->u_state == TPP_STRM_STATE_OPEN && strm->t_state == TPP_TRNS_STATE_OPEN && strm->used_locally == 1) {
+				tpp_unlock_rwlock(&strmarray_lock);
+				pbs_idx_free_ctx(idx_ctx);
 
-			TPP_DBPRT("Stream for dest[%s] returned = %u", dest, strm->sd);
-			free(dest);
-			return strm->sd;
+				TPP_DBPRT("Stream for dest[%s] returned = %u", dest, strm->sd);
+				free(dest);
+				return strm->sd;
+			}
 		}
-	}
-	pbs_idx_free_ctx(idx_ctx);
+		pbs_idx_free_ctx(idx_ctx);
 
-	tpp_unlock_rwlock(&strmarray_lock);
+		tpp_unlock_rwlock(&strmarray_lock);
+	}
 
 	/* by default use the first address of the host as the source address */
 	if ((strm = alloc_stream(&leaf_addrs[0], &dest_addr)) == NULL) {
@@ -838,6 +837,59 @@ tpp_open(char *dest_host, unsigned int port)
 	return strm->sd;
 }
 
+/**
+ * @brief
+ *	Opens a virtual connection to another leaf (another PBS daemon)
+ *
+ * @par Functionality:
+ *	This function merely allocates a free stream slot from the array of
+ *	streams and sets the destination host and port, and returns the slot
+ *	index as the fd for the application to use to read/write to the virtual
+ *	connection.  A stream already open to the destination is returned
+ *	instead, if there is one.
+ *
+ * @param[in] dest_host - Hostname of the destination leaf
+ * @param[in] port - The port at which the destination is available
+ *
+ * @return - The file descriptor that APP must use to do the IO
+ * @retval -1   - Function failed
+ * @retval !=-1 - Success, the fd for the APP to use is returned
+ *
+ * @par Side Effects:
+ *	None
+ *
+ * @par MT-safe: Yes
+ *
+ */
+int
+tpp_open(char *dest_host, unsigned int port)
+{
+	return open_stream(dest_host, port, 1);
+}
+
+/**
+ * @brief
+ *	Opens a new virtual connection to another leaf, even if a stream to
+ *	it is already open, so one leaf can hold several independent
+ *	conversations with the same daemon (e.g. the MoM simulator, which
+ *	talks to the server once per simulated MoM)
+ *
+ * @param[in] dest_host - Hostname of the destination leaf
+ * @param[in] port - The port at which the destination is available
+ *
+ * @return - The file descriptor that APP must use to do the IO
+ * @retval -1   - Function failed
+ * @retval !=-1 - Success, the fd for the APP to use is returned
+ *
+ * @par MT-safe: Yes
+ *
+ */
+int
+tpp_open_new(char *dest_host, unsigned int port)
+{
+	return open_stream(dest_host, port, 0);
+}
+
 
 /**
  * @brief
@@ -1210,7 +1262,9 @@ alloc_stream(tpp_addr_t *src_addr, tpp_addr_t *dest_addr)
 
 /**
  * @brief
- *	Socket address of the local side for the given sd
+ *	Socket address of the local side for the given sd, i.e. the leaf
+ *	address the stream was opened from or, for a stream opened by the
+ *	other side, the leaf address it was opened to
  *
  * @param[in] sd - The stream descriptor
  *
@@ -1234,8 +1288,8 @@ tpp_localaddr(int fd)
 	if (!strm)
 		return NULL;
 
-	memcpy((char *) &sa.sin_addr, &leaf_addrs->ip, sizeof(sa.sin_addr));
-	sa.sin_port = htons(leaf_addrs->port);
+	memcpy((char *) &sa.sin_addr, &strm->src_addr.ip, sizeof(sa.sin_addr));
+	sa.sin_port = strm->src_addr.port;
 
 	return (&sa);
 }
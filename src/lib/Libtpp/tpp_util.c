@@ -2055,7 +2055,8 @@ tpp_get_addresses(char *names, int *count)
 
 			for (i = 0; i < tmp_count; i++) {
 				for (j = 0; j < tot_count; j++) {
-					if (memcmp(&addrs[j].ip, &addrs_tmp[i].ip, sizeof(addrs_tmp[i].ip)) == 0)
+					if (memcmp(&addrs[j].ip, &addrs_tmp[i].ip, sizeof(addrs_tmp[i].ip)) == 0 &&
+					    addrs[j].port == htons(port))
 						break;
 				}
 
@@ -0,0 +1,311 @@
+/*
+ * Copyright (C) 1994-2021 Altair Engineering, Inc.
+ * For more information, contact Altair at www.altair.com.
+ *
+ * This file is part of both the OpenPBS software ("OpenPBS")
+ * and the PBS Professional ("PBS Pro") software.
+ *
+ * Open Source License Information:
+ *
+ * OpenPBS is free software. You can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * OpenPBS is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Commercial License Information:
+ *
+ * PBS Pro is commercially licensed software that shares a common core with
+ * the OpenPBS software.  For a copy of the commercial license terms and
+ * conditions, go to: (http://www.pbspro.com/agreement.html) or contact the
+ * Altair Legal Department.
+ *
+ * Altair's dual-license business model allows companies, individuals, and
+ * organizations to create proprietary derivative works of OpenPBS and
+ * distribute them - whether embedded or bundled with other software -
+ * under a commercial license agreement.
+ *
+ * Use of Altair's trademarks, including but not limited to "PBS™",
+ * "OpenPBS®", "PBS Professional®", and "PBS Pro™" and Altair's logos is
+ * subject to Altair's trademark licensing policies.
+ */
+
+/**
+ * @file	acct_bin.c
+ *
+ * @brief
+ *	Encoding and decoding of the binary accounting log and its index,
+ *	see acct_bin.h for the layout.  Used by the server to write them
+ *	and by pbs_acctbin to read them back.
+ */
+
+#include <pbs_config.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "acct_bin.h"
+
+/**
+ * @brief
+ *	store the low n bytes of v at p, least significant first
+ */
+static void
+put_le(unsigned char *p, unsigned long long v, int n)
+{
+	int i;
+
+	for (i = 0; i < n; i++, v >>= 8)
+		p[i] = (unsigned char)(v & 0xff);
+}
+
+/**
+ * @brief
+ *	load n bytes stored by put_le()
+ */
+static unsigned long long
+get_le(const unsigned char *p, int n)
+{
+	unsigned long long v = 0;
+	int i;
+
+	for (i = n - 1; i >= 0; i--)
+		v = (v << 8) | p[i];
+	return v;
+}
+
+/**
+ * @brief
+ *	acct_bin_idhash - hash of a record id kept in the index, so a
+ *	reader can skip records of other ids without reading them
+ *
+ * @param[in]	id	- job or reservation id
+ *
+ * @return	unsigned int (FNV-1a)
+ */
+unsigned int
+acct_bin_idhash(const char *id)
+{
+	unsigned int h = 2166136261U;
+
+	for (; *id; id++) {
+		h ^= (unsigned char)*id;
+		h *= 16777619U;
+	}
+	return h;
+}
+
+/**
+ * @brief
+ *	acct_bin_encode - encode a record into a buffer which is grown as
+ *	needed and kept by the caller for the next record
+ *
+ * @param[in,out]	buf	- buffer, may be NULL at first
+ * @param[in,out]	bufsz	- size of buf
+ * @param[in]	t	- time of the record
+ * @param[in]	type	- PBS_ACCT_* type
+ * @param[in]	id	- job or reservation id
+ * @param[in]	text	- text of the record, may be NULL
+ *
+ * @return	size_t
+ * @retval	length of the encoded record
+ * @retval	0	- out of memory
+ */
+size_t
+acct_bin_encode(char **buf, size_t *bufsz, time_t t, int type, const char *id, const char *text)
+{
+	size_t idlen = strlen(id);
+	size_t textlen = text ? strlen(text) : 0;
+	size_t len;
+	unsigned char *p;
+
+	if (idlen > 0xffff)
+		idlen = 0xffff;
+	len = ACCT_BIN_HDR_LEN + idlen + textlen;
+	if (len > *bufsz) {
+		char *nb;
+
+		if ((nb = realloc(*buf, len * 2)) == NULL)
+			return 0;
+		*buf = nb;
+		*bufsz = len * 2;
+	}
+
+	p = (unsigned char *)*buf;
+	put_le(p, len - 4, 4);
+	put_le(p + 4, (unsigned long long)(long long)t, 8);
+	p[12] = (unsigned char)type;
+	put_le(p + 13, idlen, 2);
+	memcpy(p + 15, id, idlen);
+	put_le(p + 15 + idlen, textlen, 4);
+	if (textlen)
+		memcpy(p + 19 + idlen, text, textlen);
+
+	return len;
+}
+
+/**
+ * @brief
+ *	acct_idx_encode - encode an index entry
+ *
+ * @param[out]	buf	- ACCT_IDX_ENTRY_LEN bytes
+ * @param[in]	t	- time of the record
+ * @param[in]	offset	- offset of the record in the .bin file
+ * @param[in]	id	- job or reservation id
+ *
+ * @return	void
+ */
+void
+acct_idx_encode(char *buf, time_t t, long long offset, const char *id)
+{
+	unsigned char *p = (unsigned char *)buf;
+
+	put_le(p, (unsigned long long)(long long)t, 8);
+	put_le(p + 8, (unsigned long long)offset, 8);
+	put_le(p + 16, acct_bin_idhash(id), 4);
+	put_le(p + 20, 0, 4);
+}
+
+/**
+ * @brief
+ *	acct_bin_check_magic - check the header of a .bin or .idx file
+ *
+ * @param[in]	fp	- file positioned at its start
+ * @param[in]	magic	- ACCT_BIN_MAGIC or ACCT_IDX_MAGIC
+ *
+ * @return	int
+ * @retval	0	- header matches
+ * @retval	-1	- not a file of that kind
+ */
+int
+acct_bin_check_magic(FILE *fp, const char *magic)
+{
+	char hdr[ACCT_MAGIC_LEN];
+
+	if (fread(hdr, 1, ACCT_MAGIC_LEN, fp) != ACCT_MAGIC_LEN)
+		return -1;
+	return (memcmp(hdr, magic, ACCT_MAGIC_LEN) == 0) ? 0 : -1;
+}
+
+/**
+ * @brief
+ *	acct_bin_read - read the next record of a .bin file
+ *
+ * @param[in]	fp	- file positioned at a record
+ * @param[out]	rec	- the record, its strings point into buf
+ * @param[in,out]	buf	- read buffer, grown as needed, may be NULL at first
+ * @param[in,out]	bufsz	- size of buf
+ *
+ * @return	int
+ * @retval	1	- a record was read
+ * @retval	0	- end of file
+ * @retval	-1	- truncated or corrupt record, or out of memory
+ */
+int
+acct_bin_read(FILE *fp, struct acct_bin_rec *rec, char **buf, size_t *bufsz)
+{
+	unsigned char lenbuf[4];
+	unsigned char *p;
+	size_t len;
+	size_t idlen;
+	size_t textlen;
+	size_t n;
+
+	n = fread(lenbuf, 1, 4, fp);
+	if (n == 0)
+		return 0;
+	if (n != 4)
+		return -1;
+	len = get_le(lenbuf, 4);
+	if (len < ACCT_BIN_HDR_LEN - 4)
+		return -1;
+
+	/* room for the two terminating nul bytes which replace the length fields */
+	if (len + 2 > *bufsz) {
+		char *nb;
+
+		if ((nb = realloc(*buf, len + 2)) == NULL)
+			return -1;
+		*buf = nb;
+		*bufsz = len + 2;
+	}
+	p = (unsigned char *)*buf;
+	if (fread(p, 1, len, fp) != len)
+		return -1;
+
+	rec->ab_time = (time_t)(long long)get_le(p, 8);
+	rec->ab_type = p[8];
+	idlen = get_le(p + 9, 2);
+	if (11 + idlen + 4 > len)
+		return -1;
+	textlen = get_le(p + 11 + idlen, 4);
+	if (15 + idlen + textlen != len)
+		return -1;
+
+	/* move the id down over its length so both strings can be terminated */
+	memmove(p + 10, p + 11, idlen);
+	p[10 + idlen] = '\0';
+	rec->ab_id = (char *)p + 10;
+	memmove(p + 11 + idlen, p + 15 + idlen, textlen);
+	p[11 + idlen + textlen] = '\0';
+	rec->ab_text = (char *)p + 11 + idlen;
+
+	return 1;
+}
+
+/**
+ * @brief
+ *	acct_idx_read - read the next entry of an .idx file
+ *
+ * @param[in]	fp	- file positioned at an entry
+ * @param[out]	ent	- the entry
+ *
+ * @return	int
+ * @retval	1	- an entry was read
+ * @retval	0	- end of file, or a partial entry at the end
+ */
+int
+acct_idx_read(FILE *fp, struct acct_idx_ent *ent)
+{
+	unsigned char p[ACCT_IDX_ENTRY_LEN];
+
+	if (fread(p, 1, ACCT_IDX_ENTRY_LEN, fp) != ACCT_IDX_ENTRY_LEN)
+		return 0;
+	ent->ai_time = (time_t)(long long)get_le(p, 8);
+	ent->ai_offset = (long long)get_le(p + 8, 8);
+	ent->ai_idhash = (unsigned int)get_le(p + 16, 4);
+	return 1;
+}
+
+/**
+ * @brief
+ *	acct_bin_to_text - write a record as a line of the text accounting log
+ *
+ * @param[in]	rec	- the record
+ * @param[in]	out	- where to write it
+ *
+ * @return	int
+ * @retval	0	- success
+ * @retval	-1	- write error
+ */
+int
+acct_bin_to_text(const struct acct_bin_rec *rec, FILE *out)
+{
+	struct tm *ptm;
+	struct tm ltm;
+
+	ptm = localtime_r(&rec->ab_time, &ltm);
+	if (fprintf(out, "%02d/%02d/%04d %02d:%02d:%02d;%c;%s;%s\n",
+		    ptm->tm_mon + 1, ptm->tm_mday, ptm->tm_year + 1900,
+		    ptm->tm_hour, ptm->tm_min, ptm->tm_sec,
+		    (char)rec->ab_type, rec->ab_id, rec->ab_text) < 0)
+		return -1;
+	return 0;
+}
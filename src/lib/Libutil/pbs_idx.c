@@ -39,21 +39,222 @@
 
 #include "pbs_idx.h"
 #include "avltree.h"
+#include <ctype.h>
 #include <stddef.h>
 #include <stdlib.h>
 #include <string.h>
+#include <strings.h>
+
+/*
+ * An index created with PBS_IDX_HASH is still described by an AVL_IX_DESC,
+ * so that the flags can tell the two kinds apart, but its root points to
+ * a chained hash table instead of an AVL tree.
+ */
+#define HASH_IDX_INIT_BUCKETS 64
+
+/* entry in hash index, key is stored inline after the entry */
+typedef struct _hash_ent {
+	struct _hash_ent *next; /* next entry in same bucket */
+	unsigned int hash;	/* precomputed hash of key */
+	void *data;		/* data of entry */
+	char key[1];		/* key of entry, actually of any length */
+} hash_ent;
+
+/* hash table, pointed to by AVL_IX_DESC root for hash index */
+typedef struct _hash_tbl {
+	hash_ent **buckets; /* array of bucket chains */
+	size_t nbuckets;    /* number of buckets, always power of 2 */
+	size_t count;	    /* number of entries in table */
+} hash_tbl;
 
 /* iteration context structure, opaque to application */
 typedef struct _iter_ctx {
 	AVL_IX_DESC *idx; /* pointer to idx */
 	AVL_IX_REC *pkey; /* pointer to key used while iteration */
+	/* below are used only for hash index */
+	hash_ent *hcur;	  /* current entry */
+	hash_ent *hnext;  /* entry to visit after hcur */
+	hash_ent *hdead;  /* entry deleted through ctx, freed on next move */
+	size_t hbucket;	  /* bucket of hnext */
+	int hbykey;	  /* iterate only entries with key of hcur */
 } iter_ctx;
 
+#define IS_HASH_IDX(idx) ((((AVL_IX_DESC *) (idx))->flags & PBS_IDX_HASH) != 0)
+
+/**
+ * @brief
+ *	compute hash of given key for given hash index
+ *
+ * @param[in] - pix - pointer to index descriptor
+ * @param[in] - key - key to hash
+ *
+ * @return unsigned int - FNV-1a hash of key
+ *
+ */
+static unsigned int
+hash_key(AVL_IX_DESC *pix, const void *key)
+{
+	const unsigned char *p = key;
+	unsigned int h = 2166136261U;
+	int i;
+
+	if (pix->keylength != 0) {
+		for (i = 0; i < pix->keylength; i++) {
+			h ^= p[i];
+			h *= 16777619U;
+		}
+	} else if (pix->flags & PBS_IDX_ICASE_CMP) {
+		for (; *p; p++) {
+			h ^= (unsigned char) tolower(*p);
+			h *= 16777619U;
+		}
+	} else {
+		for (; *p; p++) {
+			h ^= *p;
+			h *= 16777619U;
+		}
+	}
+	return h;
+}
+
+/**
+ * @brief
+ *	compare key of hash entry with given key
+ *
+ * @param[in] - pix  - pointer to index descriptor
+ * @param[in] - ent  - hash entry
+ * @param[in] - hash - precomputed hash of key
+ * @param[in] - key  - key to compare
+ *
+ * @return int
+ * @retval 1 - keys are same
+ * @retval 0 - keys are different
+ *
+ */
+static int
+hash_key_eq(AVL_IX_DESC *pix, hash_ent *ent, unsigned int hash, const void *key)
+{
+	if (ent->hash != hash)
+		return 0;
+	if (pix->keylength != 0)
+		return memcmp(ent->key, key, pix->keylength) == 0;
+	if (pix->flags & PBS_IDX_ICASE_CMP)
+		return strcasecmp(ent->key, key) == 0;
+	return strcmp(ent->key, key) == 0;
+}
+
+/**
+ * @brief
+ *	double number of buckets in hash table
+ *
+ * @param[in] - tbl - pointer to hash table
+ *
+ * @return void
+ *
+ * @note
+ *	on allocation failure table is left as is, which only makes
+ *	chains longer
+ *
+ */
+static void
+hash_grow(hash_tbl *tbl)
+{
+	hash_ent **nb;
+	size_t nsz = tbl->nbuckets * 2;
+	size_t i;
+
+	nb = calloc(nsz, sizeof(hash_ent *));
+	if (nb == NULL)
+		return;
+
+	for (i = 0; i < tbl->nbuckets; i++) {
+		hash_ent *ent = tbl->buckets[i];
+
+		while (ent != NULL) {
+			hash_ent *next = ent->next;
+			size_t b = ent->hash & (nsz - 1);
+
+			ent->next = nb[b];
+			nb[b] = ent;
+			ent = next;
+		}
+	}
+	free(tbl->buckets);
+	tbl->buckets = nb;
+	tbl->nbuckets = nsz;
+}
+
+/**
+ * @brief
+ *	find position of first entry with given key in hash index
+ *
+ * @param[in]  - pix  - pointer to index descriptor
+ * @param[in]  - key  - key to find
+ * @param[out] - pprev - link which points to found entry
+ *
+ * @return hash_ent *
+ * @retval !NULL - found entry
+ * @retval NULL  - key not in index
+ *
+ */
+static hash_ent *
+hash_lookup(AVL_IX_DESC *pix, const void *key, hash_ent ***pprev)
+{
+	hash_tbl *tbl = pix->root;
+	unsigned int h = hash_key(pix, key);
+	hash_ent **link = &tbl->buckets[h & (tbl->nbuckets - 1)];
+
+	for (; *link != NULL; link = &(*link)->next) {
+		if (hash_key_eq(pix, *link, h, key)) {
+			if (pprev != NULL)
+				*pprev = link;
+			return *link;
+		}
+	}
+	return NULL;
+}
+
+/**
+ * @brief
+ *	advance iteration context of hash index to next entry
+ *
+ * @param[in] - pctx - pointer to iteration context
+ *
+ * @return int
+ * @retval PBS_IDX_RET_OK   - success, pctx->hcur set to next entry
+ * @retval PBS_IDX_RET_FAIL - no more entries
+ *
+ */
+static int
+hash_iter_next(iter_ctx *pctx)
+{
+	hash_tbl *tbl = pctx->idx->root;
+	hash_ent *ref = pctx->hcur != NULL ? pctx->hcur : pctx->hdead;
+	hash_ent *ent = pctx->hnext;
+
+	if (pctx->hbykey) {
+		/* entries with same key share a bucket, don't leave it */
+		while (ent != NULL && (ref == NULL || !hash_key_eq(pctx->idx, ent, ref->hash, ref->key)))
+			ent = ent->next;
+	} else {
+		while (ent == NULL && ++pctx->hbucket < tbl->nbuckets)
+			ent = tbl->buckets[pctx->hbucket];
+	}
+
+	free(pctx->hdead);
+	pctx->hdead = NULL;
+	pctx->hcur = ent;
+	pctx->hnext = ent != NULL ? ent->next : NULL;
+
+	return ent != NULL ? PBS_IDX_RET_OK : PBS_IDX_RET_FAIL;
+}
+
 /**
  * @brief
  *	Create an empty index
  *
- * @param[in] - flags  - index flags like duplicates allowed, or case insensitive compare
+ * @param[in] - flags  - index flags like duplicates allowed, case insensitive compare
+ *                       or hash index
  * @param[in] - keylen - length of key in index (can be 0 for default size)
  *
  * @return void *
@@ -75,6 +276,25 @@ pbs_idx_create(int flags, int keylen)
 		return NULL;
 	}
 
+	if (flags & PBS_IDX_HASH) {
+		hash_tbl *tbl;
+
+		tbl = malloc(sizeof(hash_tbl));
+		if (tbl == NULL) {
+			free(idx);
+			return NULL;
+		}
+		tbl->buckets = calloc(HASH_IDX_INIT_BUCKETS, sizeof(hash_ent *));
+		if (tbl->buckets == NULL) {
+			free(tbl);
+			free(idx);
+			return NULL;
+		}
+		tbl->nbuckets = HASH_IDX_INIT_BUCKETS;
+		tbl->count = 0;
+		((AVL_IX_DESC *) idx)->root = tbl;
+	}
+
 	return idx;
 }
 
@@ -91,7 +311,24 @@ void
 pbs_idx_destroy(void *idx)
 {
 	if (idx != NULL) {
-		avl_destroy_index(idx);
+		if (IS_HASH_IDX(idx)) {
+			hash_tbl *tbl = ((AVL_IX_DESC *) idx)->root;
+			size_t i;
+
+			for (i = 0; i < tbl->nbuckets; i++) {
+				hash_ent *ent = tbl->buckets[i];
+
+				while (ent != NULL) {
+					hash_ent *next = ent->next;
+
+					free(ent);
+					ent = next;
+				}
+			}
+			free(tbl->buckets);
+			free(tbl);
+		} else
+			avl_destroy_index(idx);
 		free(idx);
 		idx = NULL;
 	}
@@ -118,6 +355,34 @@ pbs_idx_insert(void *idx, void *key, void *data)
 	if (idx == NULL || key == NULL)
 		return PBS_IDX_RET_FAIL;
 
+	if (IS_HASH_IDX(idx)) {
+		AVL_IX_DESC *pix = idx;
+		hash_tbl *tbl = pix->root;
+		unsigned int h = hash_key(pix, key);
+		size_t b = h & (tbl->nbuckets - 1);
+		size_t keysz;
+		hash_ent *ent;
+
+		for (ent = tbl->buckets[b]; ent != NULL; ent = ent->next) {
+			if (hash_key_eq(pix, ent, h, key) &&
+			    (!(pix->flags & PBS_IDX_DUPS_OK) || ent->data == data))
+				return PBS_IDX_RET_FAIL;
+		}
+
+		keysz = pix->keylength != 0 ? (size_t) pix->keylength : strlen(key) + 1;
+		ent = malloc(offsetof(hash_ent, key) + keysz);
+		if (ent == NULL)
+			return PBS_IDX_RET_FAIL;
+		memcpy(ent->key, key, keysz);
+		ent->hash = h;
+		ent->data = data;
+		ent->next = tbl->buckets[b];
+		tbl->buckets[b] = ent;
+		if (++tbl->count > tbl->nbuckets)
+			hash_grow(tbl);
+		return PBS_IDX_RET_OK;
+	}
+
 	pkey = avlkey_create(idx, key);
 	if (pkey == NULL)
 		return PBS_IDX_RET_FAIL;
@@ -151,6 +416,19 @@ pbs_idx_delete(void *idx, void *key)
 	if (idx == NULL || key == NULL)
 		return PBS_IDX_RET_FAIL;
 
+	if (IS_HASH_IDX(idx)) {
+		hash_ent **link;
+		hash_ent *ent;
+
+		ent = hash_lookup(idx, key, &link);
+		if (ent != NULL) {
+			*link = ent->next;
+			free(ent);
+			((hash_tbl *) ((AVL_IX_DESC *) idx)->root)->count--;
+		}
+		return PBS_IDX_RET_OK;
+	}
+
 	pkey = avlkey_create(idx, key);
 	if (pkey == NULL)
 		return PBS_IDX_RET_FAIL;
@@ -178,7 +456,29 @@ pbs_idx_delete_byctx(void *ctx)
 {
 	iter_ctx *pctx = (iter_ctx *) ctx;
 
-	if (pctx == NULL || pctx->idx == NULL || pctx->pkey == NULL)
+	if (pctx == NULL || pctx->idx == NULL)
+		return PBS_IDX_RET_FAIL;
+
+	if (IS_HASH_IDX(pctx->idx)) {
+		hash_tbl *tbl = pctx->idx->root;
+		hash_ent **link;
+
+		if (pctx->hcur == NULL)
+			return PBS_IDX_RET_FAIL;
+		link = &tbl->buckets[pctx->hcur->hash & (tbl->nbuckets - 1)];
+		while (*link != NULL && *link != pctx->hcur)
+			link = &(*link)->next;
+		if (*link == NULL)
+			return PBS_IDX_RET_FAIL;
+		*link = pctx->hcur->next;
+		tbl->count--;
+		/* keep entry around, caller may still hold pointer to its key */
+		pctx->hdead = pctx->hcur;
+		pctx->hcur = NULL;
+		return PBS_IDX_RET_OK;
+	}
+
+	if (pctx->pkey == NULL)
 		return PBS_IDX_RET_FAIL;
 
 	avl_delete_key(pctx->pkey, pctx->idx);
@@ -225,7 +525,19 @@ pbs_idx_find(void *idx, void **key, void **data, void **ctx)
 		if (key)
 			*key = NULL;
 
-		if (pctx->idx != idx || pctx->pkey == NULL)
+		if (pctx->idx != idx)
+			return PBS_IDX_RET_FAIL;
+
+		if (IS_HASH_IDX(idx)) {
+			if (hash_iter_next(pctx) != PBS_IDX_RET_OK)
+				return PBS_IDX_RET_FAIL;
+			*data = pctx->hcur->data;
+			if (key)
+				*key = pctx->hcur->key;
+			return PBS_IDX_RET_OK;
+		}
+
+		if (pctx->pkey == NULL)
 			return PBS_IDX_RET_FAIL;
 
 		if (avl_next_key(pctx->pkey, pctx->idx) != AVL_IX_OK)
@@ -235,6 +547,41 @@ pbs_idx_find(void *idx, void **key, void **data, void **ctx)
 		if (key)
 			*key = &pctx->pkey->key;
 
+		return PBS_IDX_RET_OK;
+	} else if (IS_HASH_IDX(idx)) {
+		hash_tbl *tbl = ((AVL_IX_DESC *) idx)->root;
+		hash_ent *ent = NULL;
+		size_t b = 0;
+		int bykey = 0;
+
+		*data = NULL;
+		if (key != NULL && *key != NULL) {
+			ent = hash_lookup(idx, *key, NULL);
+			if (ent != NULL)
+				b = ent->hash & (tbl->nbuckets - 1);
+			bykey = 1;
+		} else {
+			for (b = 0; b < tbl->nbuckets && ent == NULL; b++)
+				ent = tbl->buckets[b];
+			b--;
+		}
+		if (ent == NULL)
+			return PBS_IDX_RET_FAIL;
+
+		*data = ent->data;
+		if (key != NULL && *key == NULL)
+			*key = ent->key;
+		if (ctx != NULL) {
+			pctx = (iter_ctx *) calloc(1, sizeof(iter_ctx));
+			if (pctx == NULL)
+				return PBS_IDX_RET_FAIL;
+			pctx->idx = idx;
+			pctx->hcur = ent;
+			pctx->hnext = ent->next;
+			pctx->hbucket = b;
+			pctx->hbykey = bykey;
+			*ctx = (void *) pctx;
+		}
 		return PBS_IDX_RET_OK;
 	} else {
 		*data = NULL;
@@ -254,7 +601,7 @@ pbs_idx_find(void *idx, void **key, void **data, void **ctx)
 			if (key != NULL && *key == NULL)
 				*key = &pkey->key;
 			if (ctx != NULL) {
-				pctx = (iter_ctx *) malloc(sizeof(iter_ctx));
+				pctx = (iter_ctx *) calloc(1, sizeof(iter_ctx));
 				if (pctx == NULL) {
 					free(pkey);
 					return PBS_IDX_RET_FAIL;
@@ -287,6 +634,7 @@ pbs_idx_free_ctx(void *ctx)
 	if (ctx != NULL) {
 		iter_ctx *pctx = (iter_ctx *) ctx;
 		free(pctx->pkey);
+		free(pctx->hdead);
 		free(ctx);
 		ctx = NULL;
 	}
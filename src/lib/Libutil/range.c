@@ -721,7 +721,8 @@ range_to_str(range *r)
 	static int size = 0;
 	range *cur_r = NULL;
 	char numbuf[128];
-	int len;
+	int numlen;
+	int len = 0;
 
 	if (r == NULL)
 		return "";
@@ -733,31 +734,37 @@ range_to_str(range *r)
 		}
 		size = INIT_RANGE_ARR_SIZE;
 	}
-	range_str[0] = '\0';
 
+	/*
+	 * Append at a tracked offset rather than with strcat(), which would
+	 * rescan the whole string for each sub-range of a fragmented list.
+	 */
 	for (cur_r = r; cur_r != NULL; cur_r = cur_r->next) {
-		if (cur_r->count > 1)
-			sprintf(numbuf, "%d-%d", cur_r->start, cur_r->end);
+		if (cur_r->step > 1 && cur_r->count > 1)
+			numlen = sprintf(numbuf, "%d-%d:%d,", cur_r->start, cur_r->end, cur_r->step);
+		else if (cur_r->count > 1)
+			numlen = sprintf(numbuf, "%d-%d,", cur_r->start, cur_r->end);
 		else
-			sprintf(numbuf, "%d", cur_r->start);
+			numlen = sprintf(numbuf, "%d,", cur_r->start);
 
-		if (cur_r->step > 1 && cur_r->count > 1 ) {
-			if (pbs_strcat(&range_str, &size, numbuf) == NULL)
-				return "";
-			sprintf(numbuf, ":%d", cur_r->step);
-			if (pbs_strcat(&range_str, &size, numbuf) == NULL)
+		if (len + numlen >= size) {
+			char *tmp;
+			int newsize = size * 2;
+
+			if (newsize < len + numlen)
+				newsize = (len + numlen) * 2;
+			if ((tmp = realloc(range_str, newsize + 1)) == NULL) {
+				log_err(errno, __func__, RANGE_MEM_ERR_MSG);
 				return "";
+			}
+			range_str = tmp;
+			size = newsize;
 		}
-		else
-			if (pbs_strcat(&range_str, &size, numbuf) == NULL)
-				return "";
-
-		if (pbs_strcat(&range_str, &size, ",") == NULL)
-			return "";
+		memcpy(range_str + len, numbuf, numlen);
+		len += numlen;
 	}
-	len = strlen(range_str);
-	if (range_str[len-1] == ',')
-		range_str[len-1] = '\0';
+	/* drop the trailing ',' */
+	range_str[len - 1] = '\0';
 
 	return range_str;
 }
@@ -487,30 +487,87 @@ dep_cleanup(void)
 
 /**
  * @brief
- *	 Scan a list of tasks and return true if one of them matches sid
+ *	qsort() comparison function ordering the process table by session
+ *	(and pid within a session), see mom_get_sample().
+ *
+ * @param[in] a - process table entry
+ * @param[in] b - process table entry
+ *
+ * @return	int
+ * @retval	-1, 0, 1 : standard qsort() cmp
+ */
+static int
+cmp_proc_session(const void *a, const void *b)
+{
+	const proc_stat_t *pa = (const proc_stat_t *)a;
+	const proc_stat_t *pb = (const proc_stat_t *)b;
+
+	if (pa->session != pb->session)
+		return (pa->session < pb->session) ? -1 : 1;
+	if (pa->pid != pb->pid)
+		return (pa->pid < pb->pid) ? -1 : 1;
+	return 0;
+}
+
+/**
+ * @brief
+ *	Find the processes of a session in the process table.  The table is
+ *	sorted by session at the end of mom_get_sample(), so the processes of
+ *	a session are a contiguous range which is found by binary search.
+ *
+ * @param[in]  sid - session id
+ * @param[out] end - set to one past the index of the session's last process
+ *
+ * @return	int
+ * @retval	index of the session's first process (== *end if none)
+ *
+ */
+static int
+session_procs(pid_t sid, int *end)
+{
+	int	lo = 0;
+	int	hi = nproc;
+	int	mid;
+
+	while (lo < hi) {
+		mid = lo + (hi - lo) / 2;
+		if (proc_info[mid].session < sid)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	for (hi = lo; hi < nproc && proc_info[hi].session == sid; hi++)
+		;
+	*end = hi;
+
+	return lo;
+}
+
+/**
+ * @brief
+ *	Check if a task is the first of the job's tasks with its session id,
+ *	so a session shared by several tasks is only counted once.
  *
  * @param[in] pjob - job pointer
- * @param[in] sid - session id
+ * @param[in] ptask - task of the job
  *
  * @return	Bool
  * @retval	TRUE
- * @retval	FALSE	Error
+ * @retval	FALSE
  *
  */
 static int
-injob(job *pjob, pid_t sid)
+first_task_in_session(job *pjob, task *ptask)
 {
-	task	*ptask;
+	task	*pt;
 
-	for (ptask = (task *)GET_NEXT(pjob->ji_tasks);
-		ptask;
-		ptask = (task *)GET_NEXT(ptask->ti_jobtask)) {
-		if (ptask->ti_qs.ti_sid <= 1)
-			continue;
-		if (ptask->ti_qs.ti_sid == sid)
-			return TRUE;
+	for (pt = (task *)GET_NEXT(pjob->ji_tasks);
+		pt != NULL && pt != ptask;
+		pt = (task *)GET_NEXT(pt->ti_jobtask)) {
+		if (pt->ti_qs.ti_sid == ptask->ti_qs.ti_sid)
+			return FALSE;
 	}
-	return FALSE;
+	return TRUE;
 }
 
 /**
@@ -528,6 +585,7 @@ static ulong
 cput_sum(job *pjob)
 {
 	int		i;
+	int		end;
 	ulong		cputime = 0;
 	int		nps = 0;
 	int		active_tasks = 0;
@@ -549,13 +607,10 @@ cput_sum(job *pjob)
 		active_tasks++;
 		tcput = 0;
 		taskprocs = 0;
-		for (i=0; i<nproc; i++) {
+		/* the processes which are part of the task */
+		for (i = session_procs(ptask->ti_qs.ti_sid, &end); i < end; i++) {
 			ps = &proc_info[i];
 
-			/* is this process part of the task? */
-			if (ptask->ti_qs.ti_sid != ps->session)
-				continue;
-
 			nps++;
 			taskprocs++;
 
@@ -693,20 +748,26 @@ static ulong
 mem_sum(job *pjob)
 {
 	int		i;
+	int		end;
 	ulong		segadd;
 	proc_stat_t	*ps;
+	task		*ptask;
 
 	segadd = 0;
 
-	for (i=0; i<nproc; i++) {
+	for (ptask = (task *)GET_NEXT(pjob->ji_tasks);
+		ptask != NULL;
+		ptask = (task *)GET_NEXT(ptask->ti_jobtask)) {
+		if (ptask->ti_qs.ti_sid <= 1 || !first_task_in_session(pjob, ptask))
+			continue;
 
-		ps = &proc_info[i];
+		for (i = session_procs(ptask->ti_qs.ti_sid, &end); i < end; i++) {
+			ps = &proc_info[i];
 
-		if (!injob(pjob, ps->session))
-			continue;
-		segadd += ps->vsize;
-		DBPRT(("%s: pid: %d  pr_size: %lu  total: %lu\n",
-			__func__, ps->pid, (ulong)ps->vsize, segadd))
+			segadd += ps->vsize;
+			DBPRT(("%s: pid: %d  pr_size: %lu  total: %lu\n",
+				__func__, ps->pid, (ulong)ps->vsize, segadd))
+		}
 	}
 
 	return (segadd);
@@ -727,18 +788,23 @@ static ulong
 resi_sum(job *pjob)
 {
 	int		i;
+	int		end;
 	ulong		resisize;
 	proc_stat_t	*ps;
+	task		*ptask;
 
 	resisize = 0;
-	for (i=0; i<nproc; i++) {
-
-		ps = &proc_info[i];
-
-		if (!injob(pjob, ps->session))
+	for (ptask = (task *)GET_NEXT(pjob->ji_tasks);
+		ptask != NULL;
+		ptask = (task *)GET_NEXT(ptask->ti_jobtask)) {
+		if (ptask->ti_qs.ti_sid <= 1 || !first_task_in_session(pjob, ptask))
 			continue;
 
-		resisize += ps->rss * pagesize;
+		for (i = session_procs(ptask->ti_qs.ti_sid, &end); i < end; i++) {
+			ps = &proc_info[i];
+
+			resisize += ps->rss * pagesize;
+		}
 	}
 
 	return (resisize);
@@ -1088,6 +1154,10 @@ mom_get_sample(void)
 	}
 	if (errno != 0 && errno != ENOENT)
 		log_err(errno, __func__, "readdir");
+
+	/* group the processes by session for cput_sum() and friends */
+	qsort(proc_info, nproc, sizeof(proc_stat_t), cmp_proc_session);
+
 	sampletime_ceil = time_last_sample;
 	sprintf(log_buffer,
 		"nprocs:  %d, cantstat:  %d, nomem:  %d, skipped:  %d, "
@@ -1248,6 +1318,7 @@ bld_ptree(pid_t sid)
 {
 	int	myproc_ct;		/* count of processes in a session */
 	int	i, j;
+	int	end;
 
 	if (Proc_lnks == NULL) {
 		Proc_lnks = (pbs_plinks *)malloc(TBL_INC * sizeof(pbs_plinks));
@@ -1261,25 +1332,23 @@ bld_ptree(pid_t sid)
 	 */
 
 	myproc_ct = 0;
-	for (i = 0; i < nproc; i++) {
+	for (i = session_procs(sid, &end); i < end; i++) {
 		if (PBS_PROC_PID(i) <= 1)
 			continue;
-		if ((int)PBS_PROC_SID(i) == sid) {
-			Proc_lnks[myproc_ct].pl_pid = PBS_PROC_PID(i);
-			Proc_lnks[myproc_ct].pl_ppid = PBS_PROC_PPID(i);
-			Proc_lnks[myproc_ct].pl_parent = -1;
-			Proc_lnks[myproc_ct].pl_sib = -1;
-			Proc_lnks[myproc_ct].pl_child = -1;
-			Proc_lnks[myproc_ct].pl_done = 0;
-			if (++myproc_ct == myproc_max) {
-				void * hold;
-
-				myproc_max += TBL_INC;
-				hold = realloc((void *)Proc_lnks,
-					myproc_max*sizeof(pbs_plinks));
-				assert(hold != NULL);
-				Proc_lnks = (pbs_plinks *)hold;
-			}
+		Proc_lnks[myproc_ct].pl_pid = PBS_PROC_PID(i);
+		Proc_lnks[myproc_ct].pl_ppid = PBS_PROC_PPID(i);
+		Proc_lnks[myproc_ct].pl_parent = -1;
+		Proc_lnks[myproc_ct].pl_sib = -1;
+		Proc_lnks[myproc_ct].pl_child = -1;
+		Proc_lnks[myproc_ct].pl_done = 0;
+		if (++myproc_ct == myproc_max) {
+			void * hold;
+
+			myproc_max += TBL_INC;
+			hold = realloc((void *)Proc_lnks,
+				myproc_max*sizeof(pbs_plinks));
+			assert(hold != NULL);
+			Proc_lnks = (pbs_plinks *)hold;
 		}
 	}
 
@@ -4496,11 +4496,24 @@ join_err:
 							goto err;
 					}
 
+					/*
+					 ** Look for any outstanding event, starting at the
+					 ** host that still had one on the previous reply.
+					 ** Sisters mostly answer in order, so a full pass
+					 ** over ji_hosts per reply (quadratic in the number
+					 ** of sisters) is avoided for large jobs.
+					 */
+					if ((pjob->ji_joinscan < 0) ||
+					    (pjob->ji_joinscan >= pjob->ji_numnodes))
+						pjob->ji_joinscan = 0;
 					for (i=0; i<pjob->ji_numnodes; i++) {
-						hnodent *xp = &pjob->ji_hosts[i];
+						int hidx = (pjob->ji_joinscan + i) % pjob->ji_numnodes;
+						hnodent *xp = &pjob->ji_hosts[hidx];
 						if ((ep = (eventent *)GET_NEXT(xp->hn_events))
-							!= NULL)
+							!= NULL) {
+							pjob->ji_joinscan = hidx;
 							break;
+						}
 					}
 
 					if (do_tolerate_node_failures(pjob) &&
@@ -4515,6 +4528,19 @@ join_err:
 						 * All the JOIN messages have come in.
 						 * Call job_join_extra for local MS setup.
 						 */
+						if (pjob->ji_joinstart != 0) {
+							struct timeval tv;
+
+							if (gettimeofday(&tv, NULL) == 0) {
+								log_eventf(PBSEVENT_DEBUG2, PBS_EVENTCLASS_JOB, LOG_INFO, jobid,
+									"all %d sister moms joined in %.3f secs, last was %s",
+									pjob->ji_numnodes - 1,
+									(double)tv.tv_sec + (double)tv.tv_usec * .000001 - pjob->ji_joinstart,
+									(nodeidx > 0 && nodeidx < pjob->ji_numnodes) ?
+									pjob->ji_hosts[nodeidx].hn_host : "unknown");
+							}
+							pjob->ji_joinstart = 0;
+						}
 						rcode = pre_finish_exec(pjob, 1);
 						switch (rcode) {
 						  case PRE_FINISH_SUCCESS_JOB_SETUP_SEND:
@@ -7858,7 +7858,7 @@ main(int argc, char *argv[])
 
 	/* initialize variables */
 
-	if ((jobs_idx = pbs_idx_create(0, 0)) == NULL) {
+	if ((jobs_idx = pbs_idx_create(PBS_IDX_HASH, 0)) == NULL) {
 		log_err(-1, __func__, "Creating jobs index failed!");
 		fprintf(stderr, "Creating jobs index failed!\n");
 		return (-1);
@@ -8208,6 +8208,10 @@ main(int argc, char *argv[])
 
 	tpp_set_app_net_handler(net_down_handler, net_restore_handler);
 
+	/* in the background now, so the log writer thread stays with us */
+	if (pbs_conf.pbs_log_async && (log_set_async(1) != 0))
+		log_err(-1, msg_daemonname, "unable to start log writer thread, logging synchronously");
+
 	if ((tppfd = tpp_init(&tpp_conf)) == -1) {
 		(void) sprintf(log_buffer, "tpp_init failed");
 		log_event(PBSEVENT_SYSTEM | PBSEVENT_ADMIN, PBS_EVENTCLASS_SERVER,
@@ -0,0 +1,1690 @@
+/*
+ * Copyright (C) 1994-2021 Altair Engineering, Inc.
+ * For more information, contact Altair at www.altair.com.
+ *
+ * This file is part of both the OpenPBS software ("OpenPBS")
+ * and the PBS Professional ("PBS Pro") software.
+ *
+ * Open Source License Information:
+ *
+ * OpenPBS is free software. You can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * OpenPBS is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Commercial License Information:
+ *
+ * PBS Pro is commercially licensed software that shares a common core with
+ * the OpenPBS software.  For a copy of the commercial license terms and
+ * conditions, go to: (http://www.pbspro.com/agreement.html) or contact the
+ * Altair Legal Department.
+ *
+ * Altair's dual-license business model allows companies, individuals, and
+ * organizations to create proprietary derivative works of OpenPBS and
+ * distribute them - whether embedded or bundled with other software -
+ * under a commercial license agreement.
+ *
+ * Use of Altair's trademarks, including but not limited to "PBS™",
+ * "OpenPBS®", "PBS Professional®", and "PBS Pro™" and Altair's logos is
+ * subject to Altair's trademark licensing policies.
+ */
+
+
+/**
+ * @file	mom_sim.c
+ *
+ * @brief
+ *	pbs_mom_sim - register many simulated MoMs with a server from a
+ *	single process, for server and scheduler load testing.
+ *
+ * @par
+ *	Each simulated MoM opens its own TPP stream to the server and says
+ *	IS_HELLOSVR with its own port, so the server treats it as a distinct
+ *	MoM even though all of them share one TPP leaf.  The leaf registers
+ *	the rm port (mom port + 1) of every simulated MoM with pbs_comm, so
+ *	streams the server opens to a MoM reach this process as well; the
+ *	local address of such a stream tells which MoM it is for.  A leaf
+ *	registers at most TPP_MAX_LEAF_ADDRS addresses, which bounds the
+ *	number of MoMs one process can simulate; run several processes with
+ *	distinct "-p" and "-N" for more.  Nodes must be created beforehand
+ *	with Mom=<this host> and Port=<mom port>; the "-q" option prints the
+ *	matching qmgr commands.
+ *
+ * @par
+ *	Jobs sent to a simulated MoM are never executed.  They are marked
+ *	running on commit, periodically report resources_used, and send an
+ *	obit once a synthetic runtime drawn from the "-R" distribution has
+ *	elapsed (never beyond the job's requested walltime).
+ */
+
+#include <pbs_config.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <unistd.h>
+#include <errno.h>
+#include <signal.h>
+#include <poll.h>
+#include <time.h>
+#include <math.h>
+#include <ctype.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#include "pbs_ifl.h"
+#include "pbs_internal.h"
+#include "pbs_version.h"
+#include "pbs_error.h"
+#include "libpbs.h"
+#include "libutil.h"
+#include "list_link.h"
+#include "attribute.h"
+#include "server_limits.h"
+#include "job.h"
+#include "batch_request.h"
+#include "dis.h"
+#include "net_connect.h"
+#include "placementsets.h"
+#include "auth.h"
+#include "log.h"
+#include "tpp.h"
+
+#define SIM_DFLT_PORT		20002	/* first mom port, one above each for rm */
+#define SIM_DFLT_NCPUS		8
+#define SIM_DFLT_MEM		"16gb"
+#define SIM_DFLT_UPDATE		60	/* seconds between resources_used updates */
+#define SIM_DFLT_HELLO_RATE	100	/* hellos sent per second */
+#define SIM_HELLO_TIMEOUT	60	/* resend hello if no reply in this time */
+#define SIM_HELLO_RETRY		5	/* wait before re-hello on a lost stream */
+#define SIM_STATS_INTERVAL	10
+
+enum sim_dist {
+	SIM_DIST_FIXED,
+	SIM_DIST_UNIFORM,
+	SIM_DIST_EXP,
+	SIM_DIST_WALLTIME
+};
+
+enum sim_mom_state {
+	SIM_MOM_DOWN,
+	SIM_MOM_HELLO,
+	SIM_MOM_UP
+};
+
+enum sim_job_state {
+	SIM_JOB_TRANSIT,
+	SIM_JOB_RUNNING,
+	SIM_JOB_EXITED
+};
+
+struct sim_mom;
+
+typedef struct sim_job {
+	struct sim_job *next;		/* next job on the same mom */
+	struct sim_mom *mom;
+	char jobid[PBS_MAXSVRJOBID + 1];
+	char *exec_vnode;
+	long runver;
+	long walltime;			/* requested walltime, -1 if none */
+	long ncpus;
+	long long mem_kb;
+	long sid;			/* synthetic session id */
+	time_t start;
+	time_t end;
+	int exitstat;
+	int obit_sent;
+	int heapidx;			/* position in end-time heap, -1 if none */
+	enum sim_job_state state;
+} sim_job;
+
+typedef struct sim_mom {
+	char name[PBS_MAXHOSTNAME + 1];
+	unsigned int port;
+	int stream;
+	enum sim_mom_state state;
+	time_t next_hello;
+	int obit_pending;		/* on the to-flush list */
+	sim_job *jobs;
+} sim_mom;
+
+static char *usage = "[-n moms] [-p first_port] [-H mom_host] [-N prefix] [-v vnodes] [-c ncpus] [-m mem] [-r res=val[,res=val...]] [-R fixed:S|uniform:MIN:MAX|exp:MEAN|walltime] [-u update_secs] [-l hellos_per_sec] [-S seed] [-q]";
+
+static sim_mom *moms;
+static int nmoms = 1;
+static unsigned int first_port = SIM_DFLT_PORT;
+static char *mom_host = NULL;
+static char *prefix = "sim";
+static int nvnodes = 1;
+static int ncpus = SIM_DFLT_NCPUS;
+static char *mem = SIM_DFLT_MEM;
+static char **extra_res;
+static int nextra_res;
+static enum sim_dist dist = SIM_DIST_FIXED;
+static double dist_a = 60;
+static double dist_b = 0;
+static int update_secs = SIM_DFLT_UPDATE;
+static int hello_rate = SIM_DFLT_HELLO_RATE;
+
+static char *server_name;
+static unsigned int server_port;
+
+static sim_mom **strm_map;	/* tpp stream -> simulated mom */
+static int strm_mapsz;
+
+static sim_job **heap;		/* jobs ordered by end time */
+static int heap_used;
+static int heap_size;
+
+static sim_mom **flush_list;	/* moms with obits to send */
+static int nflush;
+
+static volatile sig_atomic_t stop;
+static volatile sig_atomic_t net_up;
+static int net_lost;
+static long next_sid = 100000;
+
+static long nstarted;
+static long nended;
+static long nrunning;
+static int nup;
+
+/**
+ * @brief
+ *	Convert a size string such as "16gb" into kilobytes.
+ *
+ * @param[in]	str - size with an optional b/kb/mb/gb/tb suffix
+ *
+ * @return	long long
+ * @retval	size in kilobytes, -1 if str is malformed
+ */
+static long long
+to_kb(char *str)
+{
+	char *end;
+	long long val;
+
+	val = strtoll(str, &end, 10);
+	if (end == str || val < 0)
+		return -1;
+	switch (tolower(*end)) {
+		case '\0':
+		case 'b':
+			return (val + 1023) / 1024;
+		case 'k':
+			break;
+		case 'm':
+			val <<= 10;
+			break;
+		case 'g':
+			val <<= 20;
+			break;
+		case 't':
+			val <<= 30;
+			break;
+		default:
+			return -1;
+	}
+	return val;
+}
+
+/**
+ * @brief
+ *	Convert a walltime string ([[HH:]MM:]SS) into seconds.
+ *
+ * @param[in]	str - walltime as encoded by the server
+ *
+ * @return	long
+ * @retval	seconds, -1 if str is malformed
+ */
+static long
+walltime_secs(char *str)
+{
+	long secs = 0;
+	char *end;
+
+	for (;;) {
+		long v = strtol(str, &end, 10);
+
+		if (end == str || v < 0)
+			return -1;
+		secs = secs * 60 + v;
+		if (*end == '\0')
+			return secs;
+		if (*end != ':')
+			return -1;
+		str = end + 1;
+	}
+}
+
+/**
+ * @brief
+ *	Parse the "-R" runtime distribution.
+ *
+ * @param[in]	spec - distribution specification
+ *
+ * @return	int
+ * @retval	0 - success
+ * @retval	-1 - malformed specification
+ */
+static int
+parse_dist(char *spec)
+{
+	char *end;
+
+	if (strcmp(spec, "walltime") == 0) {
+		dist = SIM_DIST_WALLTIME;
+		return 0;
+	}
+	if (strncmp(spec, "fixed:", 6) == 0) {
+		dist = SIM_DIST_FIXED;
+		dist_a = strtod(spec + 6, &end);
+		return (end == spec + 6 || *end != '\0' || dist_a < 0) ? -1 : 0;
+	}
+	if (strncmp(spec, "exp:", 4) == 0) {
+		dist = SIM_DIST_EXP;
+		dist_a = strtod(spec + 4, &end);
+		return (end == spec + 4 || *end != '\0' || dist_a <= 0) ? -1 : 0;
+	}
+	if (strncmp(spec, "uniform:", 8) == 0) {
+		dist = SIM_DIST_UNIFORM;
+		dist_a = strtod(spec + 8, &end);
+		if (end == spec + 8 || *end != ':')
+			return -1;
+		spec = end + 1;
+		dist_b = strtod(spec, &end);
+		return (end == spec || *end != '\0' || dist_a < 0 || dist_b < dist_a) ? -1 : 0;
+	}
+	return -1;
+}
+
+/**
+ * @brief
+ *	Draw a runtime for a job from the "-R" distribution.
+ *
+ * @param[in]	pj - job being started
+ *
+ * @return	long
+ * @retval	runtime in seconds
+ */
+static long
+draw_runtime(sim_job *pj)
+{
+	double rt;
+
+	switch (dist) {
+		case SIM_DIST_UNIFORM:
+			rt = dist_a + drand48() * (dist_b - dist_a);
+			break;
+		case SIM_DIST_EXP:
+			rt = -dist_a * log(1.0 - drand48());
+			break;
+		case SIM_DIST_WALLTIME:
+			rt = pj->walltime >= 0 ? pj->walltime : 0;
+			break;
+		default:
+			rt = dist_a;
+	}
+	return (long) rt;
+}
+
+/*
+ * Min-heap of running jobs keyed on end time.
+ */
+static void
+heap_swap(int i, int j)
+{
+	sim_job *t = heap[i];
+
+	heap[i] = heap[j];
+	heap[j] = t;
+	heap[i]->heapidx = i;
+	heap[j]->heapidx = j;
+}
+
+static void
+heap_sift(int i)
+{
+	while (i > 0 && heap[(i - 1) / 2]->end > heap[i]->end) {
+		heap_swap(i, (i - 1) / 2);
+		i = (i - 1) / 2;
+	}
+	for (;;) {
+		int l = 2 * i + 1;
+		int m = i;
+
+		if (l < heap_used && heap[l]->end < heap[m]->end)
+			m = l;
+		if (l + 1 < heap_used && heap[l + 1]->end < heap[m]->end)
+			m = l + 1;
+		if (m == i)
+			break;
+		heap_swap(i, m);
+		i = m;
+	}
+}
+
+static int
+heap_push(sim_job *pj)
+{
+	if (heap_used == heap_size) {
+		int nsize = heap_size ? heap_size * 2 : 1024;
+		sim_job **tmp = realloc(heap, nsize * sizeof(sim_job *));
+
+		if (tmp == NULL)
+			return -1;
+		heap = tmp;
+		heap_size = nsize;
+	}
+	heap[heap_used] = pj;
+	pj->heapidx = heap_used++;
+	heap_sift(pj->heapidx);
+	return 0;
+}
+
+static void
+heap_remove(sim_job *pj)
+{
+	int i = pj->heapidx;
+
+	if (i < 0)
+		return;
+	pj->heapidx = -1;
+	if (--heap_used == i)
+		return;
+	heap[i] = heap[heap_used];
+	heap[i]->heapidx = i;
+	heap_sift(i);
+}
+
+/**
+ * @brief
+ *	Remember which simulated mom owns a tpp stream.
+ *
+ * @param[in]	stream - tpp stream
+ * @param[in]	pm - owning mom, NULL to forget the stream
+ */
+static void
+map_stream(int stream, sim_mom *pm)
+{
+	if (stream >= strm_mapsz) {
+		int nsize = strm_mapsz ? strm_mapsz : 1024;
+		sim_mom **tmp;
+
+		while (nsize <= stream)
+			nsize *= 2;
+		tmp = realloc(strm_map, nsize * sizeof(sim_mom *));
+		if (tmp == NULL) {
+			fprintf(stderr, "pbs_mom_sim: out of memory\n");
+			exit(1);
+		}
+		memset(tmp + strm_mapsz, 0, (nsize - strm_mapsz) * sizeof(sim_mom *));
+		strm_map = tmp;
+		strm_mapsz = nsize;
+	}
+	strm_map[stream] = pm;
+}
+
+static sim_mom *
+find_mom(int stream)
+{
+	if (stream < 0 || stream >= strm_mapsz)
+		return NULL;
+	return strm_map[stream];
+}
+
+/**
+ * @brief
+ *	Find the simulated mom a stream opened by the server is for, from
+ *	the rm port it was opened to.
+ *
+ * @param[in]	stream - tpp stream
+ *
+ * @return	sim_mom *
+ * @retval	the simulated mom
+ * @retval	NULL if the port is not one of ours
+ */
+static sim_mom *
+find_mom_by_addr(int stream)
+{
+	struct sockaddr_in *addr;
+	unsigned int port;
+
+	if ((addr = tpp_localaddr(stream)) == NULL)
+		return NULL;
+	port = ntohs(addr->sin_port);
+	if (port <= first_port || (port - first_port - 1) % 2 != 0 ||
+	    (port - first_port - 1) / 2 >= (unsigned int) nmoms)
+		return NULL;
+	return &moms[(port - first_port - 1) / 2];
+}
+
+static sim_job *
+find_simjob(sim_mom *pm, char *jobid)
+{
+	sim_job *pj;
+
+	for (pj = pm->jobs; pj; pj = pj->next)
+		if (strcmp(pj->jobid, jobid) == 0)
+			return pj;
+	return NULL;
+}
+
+static void
+drop_job(sim_job *pj)
+{
+	sim_job **pp;
+
+	for (pp = &pj->mom->jobs; *pp; pp = &(*pp)->next) {
+		if (*pp == pj) {
+			*pp = pj->next;
+			break;
+		}
+	}
+	if (pj->state == SIM_JOB_RUNNING)
+		nrunning--;
+	heap_remove(pj);
+	free(pj->exec_vnode);
+	free(pj);
+}
+
+/**
+ * @brief
+ *	Close a simulated mom's stream and schedule a new hello.
+ *
+ * @param[in]	pm - simulated mom
+ * @param[in]	now - current time
+ */
+static void
+mom_down(sim_mom *pm, time_t now)
+{
+	sim_job *pj;
+	sim_job *next;
+
+	if (pm->stream >= 0) {
+		map_stream(pm->stream, NULL);
+		tpp_close(pm->stream);
+		pm->stream = -1;
+	}
+	if (pm->state == SIM_MOM_UP)
+		nup--;
+	pm->state = SIM_MOM_DOWN;
+	pm->next_hello = now + SIM_HELLO_RETRY;
+
+	/* jobs never committed are resent by the server */
+	for (pj = pm->jobs; pj; pj = next) {
+		next = pj->next;
+		if (pj->state == SIM_JOB_TRANSIT)
+			drop_job(pj);
+	}
+}
+
+/**
+ * @brief
+ *	Encode one svrattrl entry (see encode_DIS_svrattrl()).
+ */
+static int
+encode_attr(int stream, char *name, char *resc, char *val)
+{
+	int rc;
+	unsigned int len = strlen(name) + strlen(val) + 2;
+
+	if (resc)
+		len += strlen(resc) + 1;
+	if ((rc = diswui(stream, len)) != DIS_SUCCESS ||
+	    (rc = diswst(stream, name)) != DIS_SUCCESS ||
+	    (rc = diswui(stream, resc ? 1 : 0)) != DIS_SUCCESS)
+		return rc;
+	if (resc && (rc = diswst(stream, resc)) != DIS_SUCCESS)
+		return rc;
+	if ((rc = diswst(stream, val)) != DIS_SUCCESS)
+		return rc;
+	return diswui(stream, SET);
+}
+
+/**
+ * @brief
+ *	Encode one job's entry of an IS_RESCUSED or IS_JOBOBIT message, in
+ *	the layout written by send_resc_used().
+ *
+ * @param[in]	stream - tpp stream
+ * @param[in]	pj - job
+ * @param[in]	now - current time
+ *
+ * @return	int
+ * @retval	DIS_SUCCESS on success, DIS error otherwise
+ */
+static int
+encode_job_update(int stream, sim_job *pj, time_t now)
+{
+	int rc;
+	long used;
+	char buf[64];
+
+	used = (pj->state == SIM_JOB_EXITED ? pj->end : now) - pj->start;
+	if (used < 0)
+		used = 0;
+
+	if ((rc = diswst(stream, pj->jobid)) != DIS_SUCCESS ||
+	    (rc = diswsi(stream, 0)) != DIS_SUCCESS ||
+	    (rc = diswsi(stream, pj->state == SIM_JOB_EXITED ? pj->exitstat : 0)) != DIS_SUCCESS ||
+	    (rc = diswsi(stream, (int) pj->runver)) != DIS_SUCCESS ||
+	    (rc = diswui(stream, 5)) != DIS_SUCCESS)
+		return rc;
+
+	sprintf(buf, "%ld", pj->sid);
+	if ((rc = encode_attr(stream, ATTR_session, NULL, buf)) != DIS_SUCCESS)
+		return rc;
+	sprintf(buf, "%02ld:%02ld:%02ld", used / 3600, (used / 60) % 60, used % 60);
+	if ((rc = encode_attr(stream, ATTR_used, "walltime", buf)) != DIS_SUCCESS)
+		return rc;
+	used *= pj->ncpus;
+	sprintf(buf, "%02ld:%02ld:%02ld", used / 3600, (used / 60) % 60, used % 60);
+	if ((rc = encode_attr(stream, ATTR_used, "cput", buf)) != DIS_SUCCESS)
+		return rc;
+	sprintf(buf, "%ld", pj->ncpus);
+	if ((rc = encode_attr(stream, ATTR_used, "ncpus", buf)) != DIS_SUCCESS)
+		return rc;
+	sprintf(buf, "%lldkb", pj->mem_kb);
+	return encode_attr(stream, ATTR_used, "mem", buf);
+}
+
+/**
+ * @brief
+ *	Send resources_used for one job, or for all running jobs of a mom.
+ *
+ * @param[in]	pm - simulated mom
+ * @param[in]	only - single job to report, NULL for all running jobs
+ * @param[in]	now - current time
+ */
+static void
+send_rescused(sim_mom *pm, sim_job *only, time_t now)
+{
+	sim_job *pj;
+	int count = 0;
+
+	if (pm->state != SIM_MOM_UP)
+		return;
+	if (only == NULL) {
+		for (pj = pm->jobs; pj; pj = pj->next)
+			if (pj->state == SIM_JOB_RUNNING)
+				count++;
+		if (count == 0)
+			return;
+	} else
+		count = 1;
+
+	if (is_compose(pm->stream, IS_RESCUSED) != DIS_SUCCESS ||
+	    diswui(pm->stream, count) != DIS_SUCCESS)
+		goto err;
+	for (pj = only ? only : pm->jobs; pj; pj = only ? NULL : pj->next) {
+		if (pj->state != SIM_JOB_RUNNING)
+			continue;
+		if (encode_job_update(pm->stream, pj, now) != DIS_SUCCESS)
+			goto err;
+	}
+	if (dis_flush(pm->stream) != 0)
+		goto err;
+	return;
+
+err:
+	mom_down(pm, now);
+}
+
+/**
+ * @brief
+ *	Send obits for all exited jobs of a mom not yet reported.
+ *
+ * @param[in]	pm - simulated mom
+ * @param[in]	now - current time
+ */
+static void
+send_obits(sim_mom *pm, time_t now)
+{
+	sim_job *pj;
+	int count = 0;
+
+	if (pm->state != SIM_MOM_UP)
+		return;
+	for (pj = pm->jobs; pj; pj = pj->next)
+		if (pj->state == SIM_JOB_EXITED && !pj->obit_sent)
+			count++;
+	if (count == 0)
+		return;
+
+	if (is_compose(pm->stream, IS_JOBOBIT) != DIS_SUCCESS ||
+	    diswui(pm->stream, count) != DIS_SUCCESS)
+		goto err;
+	for (pj = pm->jobs; pj; pj = pj->next) {
+		if (pj->state != SIM_JOB_EXITED || pj->obit_sent)
+			continue;
+		if (encode_job_update(pm->stream, pj, now) != DIS_SUCCESS)
+			goto err;
+		pj->obit_sent = 1;
+	}
+	if (dis_flush(pm->stream) != 0)
+		goto err;
+	return;
+
+err:
+	mom_down(pm, now);
+}
+
+/**
+ * @brief
+ *	Mark a job finished and queue its obit.
+ *
+ * @param[in]	pj - job
+ * @param[in]	exitstat - exit status to report
+ * @param[in]	now - current time
+ */
+static void
+end_job(sim_job *pj, int exitstat, time_t now)
+{
+	if (pj->state != SIM_JOB_RUNNING)
+		return;
+	heap_remove(pj);
+	pj->state = SIM_JOB_EXITED;
+	pj->exitstat = exitstat;
+	pj->end = now;
+	pj->obit_sent = 0;
+	nrunning--;
+	nended++;
+	if (!pj->mom->obit_pending) {
+		pj->mom->obit_pending = 1;
+		flush_list[nflush++] = pj->mom;
+	}
+}
+
+static void
+flush_obits(time_t now)
+{
+	while (nflush > 0) {
+		sim_mom *pm = flush_list[--nflush];
+
+		pm->obit_pending = 0;
+		send_obits(pm, now);
+	}
+}
+
+/**
+ * @brief
+ *	Start a committed job: pick its runtime and report a session id
+ *	so the server moves it to running.
+ *
+ * @param[in]	pj - job
+ * @param[in]	now - current time
+ */
+static void
+start_job(sim_job *pj, time_t now)
+{
+	long rt;
+
+	if (pj->state != SIM_JOB_TRANSIT)
+		return;
+	rt = draw_runtime(pj);
+	pj->exitstat = JOB_EXEC_OK;
+	if (pj->walltime >= 0 && rt > pj->walltime) {
+		/* ends the way a real mom reports a walltime overrun */
+		rt = pj->walltime;
+		pj->exitstat = JOB_EXEC_KILL_WALLTIME;
+	}
+	pj->state = SIM_JOB_RUNNING;
+	pj->sid = next_sid++;
+	pj->start = now;
+	pj->end = now + rt;
+	if (heap_push(pj) != 0) {
+		fprintf(stderr, "pbs_mom_sim: out of memory\n");
+		exit(1);
+	}
+	nrunning++;
+	nstarted++;
+}
+
+static void
+send_reply(int stream, char *msgid, int code, int choice, char *jobid)
+{
+	struct batch_reply reply;
+
+	memset(&reply, 0, sizeof(reply));
+	reply.brp_code = code;
+	reply.brp_choice = choice;
+	if (jobid)
+		pbs_strncpy(reply.brp_un.brp_jid, jobid, sizeof(reply.brp_un.brp_jid));
+	if (encode_DIS_replyTPP(stream, msgid, &reply) == DIS_SUCCESS)
+		dis_flush(stream);
+}
+
+/**
+ * @brief
+ *	Create a job from a QueueJob request.
+ *
+ * @param[in]	pm - simulated mom
+ * @param[in]	stream - tpp stream
+ * @param[out]	implicit - set if the request asks for an implicit commit
+ *
+ * @return	sim_job *
+ * @retval	new job, NULL on a decode or allocation failure
+ */
+static sim_job *
+queue_job(sim_mom *pm, int stream, int *implicit)
+{
+	char jobid[PBS_MAXSVRJOBID + 1];
+	char destin[PBS_MAXSVRJOBID + 1];
+	pbs_list_head attrs;
+	svrattrl *pal;
+	sim_job *pj;
+	sim_job *old;
+	char *extend = NULL;
+	long runcount = 0;
+	int rc;
+
+	CLEAR_HEAD(attrs);
+	if (disrfst(stream, sizeof(jobid), jobid) != DIS_SUCCESS ||
+	    disrfst(stream, sizeof(destin), destin) != DIS_SUCCESS)
+		return NULL;
+	rc = decode_DIS_svrattrl(stream, &attrs);
+	if (rc == DIS_SUCCESS && disrui(stream, &rc) != 0 && rc == DIS_SUCCESS)
+		extend = disrst(stream, &rc);
+	*implicit = extend && strstr(extend, EXTEND_OPT_IMPLICIT_COMMIT);
+	free(extend);
+
+	if (rc != DIS_SUCCESS || (pj = calloc(1, sizeof(sim_job))) == NULL) {
+		free_attrlist(&attrs);
+		return NULL;
+	}
+	pbs_strncpy(pj->jobid, jobid, sizeof(pj->jobid));
+	pj->mom = pm;
+	pj->heapidx = -1;
+	pj->runver = -1;
+	pj->walltime = -1;
+	pj->ncpus = 1;
+	pj->state = SIM_JOB_TRANSIT;
+
+	for (pal = (svrattrl *) GET_NEXT(attrs); pal; pal = (svrattrl *) GET_NEXT(pal->al_link)) {
+		if (strcmp(pal->al_name, ATTR_run_version) == 0)
+			pj->runver = atol(pal->al_value);
+		else if (strcmp(pal->al_name, ATTR_runcount) == 0)
+			runcount = atol(pal->al_value);
+		else if (strcmp(pal->al_name, ATTR_execvnode) == 0) {
+			free(pj->exec_vnode);
+			pj->exec_vnode = strdup(pal->al_value);
+		} else if (strcmp(pal->al_name, ATTR_l) == 0 && pal->al_resc) {
+			if (strcmp(pal->al_resc, "walltime") == 0)
+				pj->walltime = walltime_secs(pal->al_value);
+			else if (strcmp(pal->al_resc, "ncpus") == 0)
+				pj->ncpus = atol(pal->al_value);
+			else if (strcmp(pal->al_resc, "mem") == 0)
+				pj->mem_kb = to_kb(pal->al_value);
+		}
+	}
+	free_attrlist(&attrs);
+	if (pj->runver < 0)
+		pj->runver = runcount;
+	if (pj->mem_kb < 0)
+		pj->mem_kb = 0;
+
+	/* a resent job replaces the copy we already hold */
+	if ((old = find_simjob(pm, jobid)) != NULL)
+		drop_job(old);
+	pj->next = pm->jobs;
+	pm->jobs = pj;
+	return pj;
+}
+
+/**
+ * @brief
+ *	Map a signal name from a SignalJob request to a signal that ends
+ *	the job, or 0 for signals the simulator only acknowledges.
+ */
+static int
+terminating_signal(char *signame)
+{
+	static struct {
+		char *name;
+		int num;
+	} sigs[] = {
+		{"KILL", SIGKILL},
+		{"TERM", SIGTERM},
+		{"INT", SIGINT},
+		{"HUP", SIGHUP},
+		{"QUIT", SIGQUIT},
+		{NULL, 0}
+	};
+	int i;
+
+	if (strncmp(signame, "SIG", 3) == 0)
+		signame += 3;
+	if (isdigit((int) *signame))
+		return atoi(signame);
+	for (i = 0; sigs[i].name; i++)
+		if (strcmp(signame, sigs[i].name) == 0)
+			return sigs[i].num;
+	return 0;
+}
+
+/**
+ * @brief
+ *	Handle a batch request the server sent over tpp (IS_CMD), see
+ *	process_IS_CMD() and dis_request_read().
+ *
+ * @param[in]	pm - simulated mom
+ * @param[in]	stream - tpp stream
+ * @param[in]	now - current time
+ */
+static void
+is_cmd(sim_mom *pm, int stream, time_t now)
+{
+	char *msgid;
+	char user[PBS_MAXUSER + 1];
+	char jobid[PBS_MAXSVRJOBID + 1];
+	char signame[PBS_SIGNAMESZ + 1];
+	int rq_type;
+	int rc;
+	int implicit = 0;
+	sim_job *pj;
+
+	msgid = disrst(stream, &rc);
+	if (rc != DIS_SUCCESS) {
+		free(msgid);
+		return;
+	}
+	if (disrui(stream, &rc) != PBS_BATCH_PROT_TYPE || rc != DIS_SUCCESS)
+		goto done;
+	(void) disrui(stream, &rc);
+	if (rc != DIS_SUCCESS)
+		goto done;
+	rq_type = disrui(stream, &rc);
+	if (rc != DIS_SUCCESS || disrfst(stream, sizeof(user), user) != DIS_SUCCESS)
+		goto done;
+
+	switch (rq_type) {
+		case PBS_BATCH_QueueJob:
+			if ((pj = queue_job(pm, stream, &implicit)) == NULL) {
+				send_reply(stream, msgid, PBSE_SYSTEM, BATCH_REPLY_CHOICE_NULL, NULL);
+				break;
+			}
+			if (implicit) {
+				start_job(pj, now);
+				send_reply(stream, msgid, PBSE_NONE, BATCH_REPLY_CHOICE_Commit, pj->jobid);
+				send_rescused(pm, pj, now);
+			}
+			break;
+
+		case PBS_BATCH_Commit:
+			if (disrfst(stream, sizeof(jobid), jobid) != DIS_SUCCESS)
+				break;
+			if ((pj = find_simjob(pm, jobid)) == NULL) {
+				send_reply(stream, msgid, PBSE_UNKJOBID, BATCH_REPLY_CHOICE_NULL, NULL);
+				break;
+			}
+			start_job(pj, now);
+			send_reply(stream, msgid, PBSE_NONE, BATCH_REPLY_CHOICE_Commit, pj->jobid);
+			send_rescused(pm, pj, now);
+			break;
+
+		/* parts of a job transfer that are not acknowledged over tpp */
+		case PBS_BATCH_JobCred:
+		case PBS_BATCH_jobscript:
+		case PBS_BATCH_RdytoCommit:
+		case PBS_BATCH_ModifyJob_Async:
+			break;
+
+		case PBS_BATCH_DeleteJob:
+			/* manager command and object type, then the job id */
+			(void) disrui(stream, &rc);
+			if (rc == DIS_SUCCESS)
+				(void) disrui(stream, &rc);
+			if (rc != DIS_SUCCESS || disrfst(stream, sizeof(jobid), jobid) != DIS_SUCCESS)
+				break;
+			if ((pj = find_simjob(pm, jobid)) != NULL)
+				drop_job(pj);
+			send_reply(stream, msgid, PBSE_NONE, BATCH_REPLY_CHOICE_NULL, NULL);
+			break;
+
+		case PBS_BATCH_SignalJob:
+			if (disrfst(stream, sizeof(jobid), jobid) != DIS_SUCCESS ||
+			    disrfst(stream, sizeof(signame), signame) != DIS_SUCCESS)
+				break;
+			if ((pj = find_simjob(pm, jobid)) == NULL) {
+				send_reply(stream, msgid, PBSE_UNKJOBID, BATCH_REPLY_CHOICE_NULL, NULL);
+				break;
+			}
+			send_reply(stream, msgid, PBSE_NONE, BATCH_REPLY_CHOICE_NULL, NULL);
+			if ((rc = terminating_signal(signame)) > 0)
+				end_job(pj, 256 + rc, now);
+			break;
+
+		case PBS_BATCH_MessJob:
+		case PBS_BATCH_ModifyJob:
+		case PBS_BATCH_MvJobFile:
+		case PBS_BATCH_Rerun:
+		case PBS_BATCH_CopyFiles:
+		case PBS_BATCH_DelFiles:
+		case PBS_BATCH_CopyFiles_Cred:
+		case PBS_BATCH_DelFiles_Cred:
+		case PBS_BATCH_CopyHookFile:
+		case PBS_BATCH_DelHookFile:
+			send_reply(stream, msgid, PBSE_NONE, BATCH_REPLY_CHOICE_NULL, NULL);
+			break;
+
+		default:
+			send_reply(stream, msgid, PBSE_NOSUP, BATCH_REPLY_CHOICE_NULL, NULL);
+	}
+
+done:
+	free(msgid);
+}
+
+/**
+ * @brief
+ *	Encode the vnodes of a simulated mom in the PS_DIS_V4 layout that
+ *	vn_encode_DIS() produces.
+ */
+static int
+encode_vnodes(int stream, sim_mom *pm, time_t now)
+{
+	char id[PBS_MAXHOSTNAME + 16];
+	char name[256];
+	char cpus[16];
+	int rc;
+	int i;
+	int j;
+
+	sprintf(cpus, "%d", ncpus);
+	if ((rc = diswui(stream, PS_DIS_V4)) != DIS_SUCCESS ||
+	    (rc = diswsl(stream, (long) now)) != DIS_SUCCESS ||
+	    (rc = diswui(stream, nvnodes > 1 ? nvnodes + 1 : 1)) != DIS_SUCCESS)
+		return rc;
+
+	if (nvnodes > 1) {
+		/* the natural vnode holds no resources of its own */
+		if ((rc = diswst(stream, pm->name)) != DIS_SUCCESS ||
+		    (rc = diswui(stream, 2)) != DIS_SUCCESS ||
+		    (rc = diswst(stream, "resources_available.ncpus")) != DIS_SUCCESS ||
+		    (rc = diswst(stream, "0")) != DIS_SUCCESS ||
+		    (rc = diswsi(stream, 0)) != DIS_SUCCESS ||
+		    (rc = diswsi(stream, 0)) != DIS_SUCCESS ||
+		    (rc = diswst(stream, "resources_available.mem")) != DIS_SUCCESS ||
+		    (rc = diswst(stream, "0kb")) != DIS_SUCCESS ||
+		    (rc = diswsi(stream, 0)) != DIS_SUCCESS ||
+		    (rc = diswsi(stream, 0)) != DIS_SUCCESS)
+			return rc;
+	}
+
+	for (i = 0; i < nvnodes; i++) {
+		if (nvnodes > 1)
+			snprintf(id, sizeof(id), "%s[%d]", pm->name, i);
+		else
+			pbs_strncpy(id, pm->name, sizeof(id));
+		if ((rc = diswst(stream, id)) != DIS_SUCCESS ||
+		    (rc = diswui(stream, 2 + nextra_res)) != DIS_SUCCESS ||
+		    (rc = diswst(stream, "resources_available.ncpus")) != DIS_SUCCESS ||
+		    (rc = diswst(stream, cpus)) != DIS_SUCCESS ||
+		    (rc = diswsi(stream, 0)) != DIS_SUCCESS ||
+		    (rc = diswsi(stream, 0)) != DIS_SUCCESS ||
+		    (rc = diswst(stream, "resources_available.mem")) != DIS_SUCCESS ||
+		    (rc = diswst(stream, mem)) != DIS_SUCCESS ||
+		    (rc = diswsi(stream, 0)) != DIS_SUCCESS ||
+		    (rc = diswsi(stream, 0)) != DIS_SUCCESS)
+			return rc;
+		for (j = 0; j < nextra_res; j++) {
+			char *eq = strchr(extra_res[j], '=');
+
+			snprintf(name, sizeof(name), "resources_available.%.*s",
+				 (int) (eq - extra_res[j]), extra_res[j]);
+			if ((rc = diswst(stream, name)) != DIS_SUCCESS ||
+			    (rc = diswst(stream, eq + 1)) != DIS_SUCCESS ||
+			    (rc = diswsi(stream, 0)) != DIS_SUCCESS ||
+			    (rc = diswsi(stream, 0)) != DIS_SUCCESS)
+				return rc;
+		}
+	}
+	return DIS_SUCCESS;
+}
+
+/**
+ * @brief
+ *	Answer IS_REPLYHELLO with IS_REGISTERMOM and the update that the
+ *	server expects to follow it in the same message, as registermom()
+ *	and state_to_server() do for a real mom.
+ *
+ * @param[in]	pm - simulated mom
+ * @param[in]	now - current time
+ */
+static void
+register_mom(sim_mom *pm, time_t now)
+{
+	int s = pm->stream;
+	int count = 0;
+	sim_job *pj;
+
+	for (pj = pm->jobs; pj; pj = pj->next)
+		if (pj->state != SIM_JOB_TRANSIT)
+			count++;
+
+	if (is_compose(s, IS_REGISTERMOM) != DIS_SUCCESS || diswui(s, count) != DIS_SUCCESS)
+		goto err;
+	for (pj = pm->jobs; pj; pj = pj->next) {
+		if (pj->state == SIM_JOB_TRANSIT)
+			continue;
+		if (diswst(s, pj->jobid) != DIS_SUCCESS ||
+		    diswsi(s, JOB_SUBSTATE_RUNNING) != DIS_SUCCESS ||
+		    diswsl(s, pj->runver) != DIS_SUCCESS ||
+		    diswsi(s, 0) != DIS_SUCCESS ||
+		    diswst(s, pj->exec_vnode ? pj->exec_vnode : "") != DIS_SUCCESS)
+			goto err;
+	}
+
+	if (diswui(s, 0) != DIS_SUCCESS ||			/* node state */
+	    diswui(s, ncpus * nvnodes) != DIS_SUCCESS ||	/* phy cpus */
+	    diswui(s, ncpus * nvnodes) != DIS_SUCCESS ||	/* avail cpus */
+	    diswull(s, (u_Long) to_kb(mem) * nvnodes) != DIS_SUCCESS ||
+	    diswst(s, "linux") != DIS_SUCCESS ||
+	    encode_vnodes(s, pm, now) != DIS_SUCCESS ||
+	    diswst(s, PBS_VERSION) != DIS_SUCCESS ||
+	    dis_flush(s) != 0)
+		goto err;
+
+	if (pm->state != SIM_MOM_UP)
+		nup++;
+	pm->state = SIM_MOM_UP;
+
+	/* anything the server did not acknowledge before is reported again */
+	for (pj = pm->jobs; pj; pj = pj->next)
+		pj->obit_sent = 0;
+	send_obits(pm, now);
+	return;
+
+err:
+	mom_down(pm, now);
+}
+
+/**
+ * @brief
+ *	Make a stream the server opened to a simulated mom that mom's
+ *	stream, as the server now uses it for the mom.  A mom which is not
+ *	up says hello on it, as a real mom does when the server reaches out
+ *	first.
+ *
+ * @param[in]	pm - simulated mom
+ * @param[in]	stream - stream opened by the server
+ * @param[in]	now - current time
+ */
+static void
+adopt_stream(sim_mom *pm, int stream, time_t now)
+{
+	if (pm->stream >= 0 && pm->stream != stream) {
+		map_stream(pm->stream, NULL);
+		tpp_close(pm->stream);
+	}
+	pm->stream = stream;
+	map_stream(stream, pm);
+
+	if (pm->state == SIM_MOM_UP)
+		return;
+	pm->next_hello = now + SIM_HELLO_TIMEOUT;
+	pm->state = SIM_MOM_HELLO;
+	if (is_compose(stream, IS_HELLOSVR) == DIS_SUCCESS &&
+	    diswui(stream, pm->port) == DIS_SUCCESS)
+		dis_flush(stream);
+}
+
+/**
+ * @brief
+ *	Read and dispatch one inter-server message on a simulated mom's
+ *	stream.
+ *
+ * @param[in]	stream - tpp stream with data
+ * @param[in]	now - current time
+ */
+static void
+do_tpp(int stream, time_t now)
+{
+	sim_mom *pm;
+	sim_job *pj;
+	char *jobid;
+	int proto;
+	int command;
+	int rc;
+	int n;
+
+	DIS_tpp_funcs();
+	pm = find_mom(stream);
+	proto = disrsi(stream, &rc);
+	if (rc != DIS_SUCCESS) {
+		/* stream closed by the server */
+		if (pm)
+			mom_down(pm, now);
+		else
+			tpp_close(stream);
+		return;
+	}
+	(void) disrsi(stream, &rc);
+	if (rc == DIS_SUCCESS && pm == NULL && (pm = find_mom_by_addr(stream)) != NULL)
+		adopt_stream(pm, stream, now);
+	if (rc != DIS_SUCCESS || proto != IS_PROTOCOL || pm == NULL) {
+		tpp_eom(stream);
+		return;
+	}
+	command = disrsi(stream, &rc);
+	if (rc != DIS_SUCCESS) {
+		tpp_eom(stream);
+		return;
+	}
+
+	switch (command) {
+		case IS_REPLYHELLO:
+			register_mom(pm, now);
+			break;
+
+		case IS_CMD:
+			is_cmd(pm, stream, now);
+			break;
+
+		case IS_OBITREPLY:
+			/* acknowledged, then rejected obits; both are done */
+			for (n = 0; n < 2 && rc == DIS_SUCCESS; n++) {
+				unsigned int njobs = disrui(stream, &rc);
+
+				while (rc == DIS_SUCCESS && njobs-- > 0) {
+					jobid = disrst(stream, &rc);
+					if (rc == DIS_SUCCESS && (pj = find_simjob(pm, jobid)) != NULL &&
+					    pj->state == SIM_JOB_EXITED)
+						drop_job(pj);
+					free(jobid);
+				}
+			}
+			break;
+
+		case IS_DISCARD_JOB:
+			jobid = disrst(stream, &rc);
+			if (rc != DIS_SUCCESS) {
+				free(jobid);
+				break;
+			}
+			n = disrsi(stream, &rc);
+			if (rc != DIS_SUCCESS)
+				n = -1;
+			if ((pj = find_simjob(pm, jobid)) != NULL && (n == -1 || pj->runver == n))
+				drop_job(pj);
+			if (is_compose(stream, IS_DISCARD_DONE) == DIS_SUCCESS &&
+			    diswst(stream, jobid) == DIS_SUCCESS &&
+			    diswsi(stream, n) == DIS_SUCCESS)
+				dis_flush(stream);
+			free(jobid);
+			break;
+
+		case IS_SHUTDOWN:
+			stop = 1;
+			break;
+
+		default:
+			break;
+	}
+	if (pm->stream == stream)
+		tpp_eom(stream);
+}
+
+/**
+ * @brief
+ *	Open a new stream for a simulated mom and say hello.
+ *
+ * @param[in]	pm - simulated mom
+ * @param[in]	now - current time
+ */
+static void
+send_hello(sim_mom *pm, time_t now)
+{
+	int s;
+
+	if (pm->stream >= 0) {
+		map_stream(pm->stream, NULL);
+		tpp_close(pm->stream);
+		pm->stream = -1;
+	}
+	pm->next_hello = now + SIM_HELLO_TIMEOUT;
+	pm->state = SIM_MOM_HELLO;
+
+	if ((s = tpp_open_new(server_name, server_port)) < 0)
+		return;
+	if (is_compose(s, IS_HELLOSVR) != DIS_SUCCESS ||
+	    diswui(s, pm->port) != DIS_SUCCESS ||
+	    dis_flush(s) != 0) {
+		tpp_close(s);
+		return;
+	}
+	pm->stream = s;
+	map_stream(s, pm);
+}
+
+static void
+net_down_handler(void *data)
+{
+	net_up = 0;
+	net_lost = 1;
+}
+
+static void
+net_restore_handler(void *data)
+{
+	net_up = 1;
+}
+
+static void
+stop_handler(int sig)
+{
+	stop = 1;
+}
+
+/**
+ * @brief
+ *	Split "-r" resources into extra_res.
+ */
+static int
+parse_res(char *list)
+{
+	char *tok;
+	char *save = NULL;
+
+	for (tok = strtok_r(list, ",", &save); tok; tok = strtok_r(NULL, ",", &save)) {
+		char **tmp;
+		char *eq = strchr(tok, '=');
+
+		if (eq == NULL || eq == tok || eq[1] == '\0')
+			return -1;
+		if ((tmp = realloc(extra_res, (nextra_res + 1) * sizeof(char *))) == NULL)
+			return -1;
+		extra_res = tmp;
+		extra_res[nextra_res++] = tok;
+	}
+	return 0;
+}
+
+/**
+ * @brief
+ *	Event loop: say hello for moms that are down, end jobs whose
+ *	runtime has elapsed, send periodic updates and serve the server's
+ *	requests.
+ *
+ * @param[in]	tpp_fd - descriptor from tpp_init()
+ */
+static void
+run(int tpp_fd)
+{
+	time_t now = time(NULL);
+	time_t last_update = now;
+	time_t last_stats = now;
+	time_t last_tick = now;
+	int next_mom = 0;
+	int tokens = hello_rate;
+	int i;
+
+	while (!stop) {
+		struct pollfd pfd;
+		int s;
+		int pending = 0;
+
+		now = time(NULL);
+
+		if (net_lost) {
+			net_lost = 0;
+			for (i = 0; i < nmoms; i++)
+				if (moms[i].state != SIM_MOM_DOWN)
+					mom_down(&moms[i], now);
+		}
+
+		/* rate-limited hellos, walking the moms round-robin */
+		if (now != last_tick) {
+			tokens = hello_rate;
+			last_tick = now;
+		}
+		for (i = 0; net_up && i < nmoms && tokens > 0; i++) {
+			sim_mom *pm = &moms[next_mom];
+
+			next_mom = (next_mom + 1) % nmoms;
+			if (pm->state != SIM_MOM_UP && pm->next_hello <= now) {
+				send_hello(pm, now);
+				tokens--;
+			}
+		}
+		for (i = 0; i < nmoms && !pending; i++)
+			if (moms[i].state != SIM_MOM_UP && moms[i].next_hello <= now)
+				pending = 1;
+
+		while (heap_used > 0 && heap[0]->end <= now)
+			end_job(heap[0], heap[0]->exitstat, now);
+		flush_obits(now);
+
+		if (update_secs > 0 && now - last_update >= update_secs) {
+			for (i = 0; i < nmoms; i++)
+				send_rescused(&moms[i], NULL, now);
+			last_update = now;
+		}
+
+		if (now - last_stats >= SIM_STATS_INTERVAL) {
+			printf("%ld: moms up %d/%d, jobs running %ld, started %ld, ended %ld\n",
+			       (long) now, nup, nmoms, nrunning, nstarted, nended);
+			fflush(stdout);
+			last_stats = now;
+		}
+
+		pfd.fd = tpp_fd;
+		pfd.events = POLLIN;
+		pfd.revents = 0;
+		if (poll(&pfd, 1, pending ? 100 : 1000) < 0 && errno != EINTR)
+			break;
+
+		now = time(NULL);
+		while ((s = tpp_poll()) >= 0)
+			do_tpp(s, now);
+		flush_obits(now);
+	}
+}
+
+/**
+ * @brief
+ *	Append "addr:port" to a comma separated list of TPP node names
+ *	unless it is in the list already.
+ *
+ * @param[in,out]	names - list, reallocated
+ * @param[in]	addr - address
+ * @param[in]	port - port
+ * @param[in,out]	naddrs - incremented if appended
+ *
+ * @return	int
+ * @retval	0 on success
+ * @retval	-1 on out of memory
+ */
+static int
+add_leaf_name(char **names, char *addr, unsigned int port, int *naddrs)
+{
+	char nm[PBS_MAXHOSTNAME + 16];
+	size_t len = *names ? strlen(*names) : 0;
+	char *tmp;
+	char *p;
+	int n;
+
+	n = snprintf(nm, sizeof(nm), "%s:%u", addr, port);
+	for (p = *names; p && (p = strstr(p, nm)) != NULL; p += n)
+		if ((p == *names || p[-1] == ',') && (p[n] == ',' || p[n] == '\0'))
+			return 0;
+	if ((tmp = realloc(*names, len + n + 2)) == NULL)
+		return -1;
+	sprintf(tmp + len, "%s%s", len ? "," : "", nm);
+	*names = tmp;
+	(*naddrs)++;
+	return 0;
+}
+
+/**
+ * @brief
+ *	Make the TPP node names of the leaf.  The rm port of the first mom
+ *	goes first, at every address of this host as for a real MoM, so it
+ *	is the leaf's source address.  The rm ports of the other moms are
+ *	only added at the addresses of the mom host, which is where the
+ *	server opens its streams to them.
+ *
+ * @param[in]	all_ips - comma separated addresses of this host
+ * @param[out]	naddrs - number of addresses in the names
+ *
+ * @return	char *
+ * @retval	comma separated addr:port names, to be freed by the caller
+ * @retval	NULL on failure
+ */
+static char *
+mk_leaf_names(char *all_ips, int *naddrs)
+{
+	struct addrinfo hints;
+	struct addrinfo *res = NULL;
+	struct addrinfo *ai;
+	char addr[INET_ADDRSTRLEN];
+	char *names = NULL;
+	char *tok;
+	char *save = NULL;
+	int i;
+
+	*naddrs = 0;
+	for (tok = strtok_r(all_ips, ",", &save); tok; tok = strtok_r(NULL, ",", &save))
+		if (add_leaf_name(&names, tok, moms[0].port + 1, naddrs) != 0)
+			goto err;
+
+	memset(&hints, 0, sizeof(hints));
+	hints.ai_family = AF_INET;
+	hints.ai_socktype = SOCK_STREAM;
+	if (getaddrinfo(mom_host, NULL, &hints, &res) != 0)
+		goto err;
+	for (i = 1; i < nmoms; i++) {
+		for (ai = res; ai; ai = ai->ai_next) {
+			if (inet_ntop(AF_INET, &((struct sockaddr_in *) ai->ai_addr)->sin_addr, addr, sizeof(addr)) == NULL ||
+			    add_leaf_name(&names, addr, moms[i].port + 1, naddrs) != 0)
+				goto err;
+		}
+	}
+	freeaddrinfo(res);
+	return names;
+
+err:
+	if (res)
+		freeaddrinfo(res);
+	free(names);
+	return NULL;
+}
+
+/**
+ * @brief
+ *	Print the qmgr commands creating the nodes of the simulated moms.
+ */
+static void
+print_qmgr(void)
+{
+	int i;
+
+	for (i = 0; i < nmoms; i++)
+		printf("create node %s Mom=%s,Port=%u\n", moms[i].name, mom_host, moms[i].port);
+}
+
+int
+main(int argc, char *argv[])
+{
+	int c;
+	int errflg = 0;
+	int qmgr_only = 0;
+	long seed = -1;
+	int tpp_fd;
+	int i;
+	char *p;
+	char *leaf_names;
+	int naddrs;
+	char my_hostname[PBS_MAXHOSTNAME + 1];
+	struct tpp_config tpp_conf;
+
+	PRINT_VERSION_AND_EXIT(argc, argv);
+
+	if (set_msgdaemonname("pbs_mom_sim")) {
+		fprintf(stderr, "Out of memory\n");
+		return 1;
+	}
+	set_logfile(stderr);
+
+	while ((c = getopt(argc, argv, "n:p:H:N:v:c:m:r:R:u:l:S:q")) != EOF) {
+		switch (c) {
+			case 'n':
+				nmoms = strtol(optarg, &p, 10);
+				if (*p != '\0' || nmoms < 1)
+					errflg = 1;
+				break;
+			case 'p':
+				first_port = strtoul(optarg, &p, 10);
+				if (*p != '\0' || first_port < 1)
+					errflg = 1;
+				break;
+			case 'H':
+				mom_host = optarg;
+				break;
+			case 'N':
+				prefix = optarg;
+				break;
+			case 'v':
+				nvnodes = strtol(optarg, &p, 10);
+				if (*p != '\0' || nvnodes < 1)
+					errflg = 1;
+				break;
+			case 'c':
+				ncpus = strtol(optarg, &p, 10);
+				if (*p != '\0' || ncpus < 0)
+					errflg = 1;
+				break;
+			case 'm':
+				mem = optarg;
+				if (to_kb(mem) < 0)
+					errflg = 1;
+				break;
+			case 'r':
+				if (parse_res(optarg) != 0)
+					errflg = 1;
+				break;
+			case 'R':
+				if (parse_dist(optarg) != 0)
+					errflg = 1;
+				break;
+			case 'u':
+				update_secs = strtol(optarg, &p, 10);
+				if (*p != '\0' || update_secs < 0)
+					errflg = 1;
+				break;
+			case 'l':
+				hello_rate = strtol(optarg, &p, 10);
+				if (*p != '\0' || hello_rate < 1)
+					errflg = 1;
+				break;
+			case 'S':
+				seed = strtol(optarg, &p, 10);
+				if (*p != '\0')
+					errflg = 1;
+				break;
+			case 'q':
+				qmgr_only = 1;
+				break;
+			default:
+				errflg = 1;
+		}
+	}
+
+	if (errflg || optind != argc || first_port + 2UL * (nmoms - 1) + 1 > 65535) {
+		fprintf(stderr, "usage: %s %s\n", argv[0], usage);
+		fprintf(stderr, "       %s --version\n", argv[0]);
+		return 2;
+	}
+
+	if (mom_host == NULL) {
+		if (gethostname(my_hostname, sizeof(my_hostname) - 1) < 0) {
+			fprintf(stderr, "%s: unable to get hostname\n", argv[0]);
+			return 1;
+		}
+		my_hostname[sizeof(my_hostname) - 1] = '\0';
+		mom_host = my_hostname;
+	}
+
+	if ((moms = calloc(nmoms, sizeof(sim_mom))) == NULL ||
+	    (flush_list = calloc(nmoms, sizeof(sim_mom *))) == NULL) {
+		fprintf(stderr, "Out of memory\n");
+		return 1;
+	}
+	for (i = 0; i < nmoms; i++) {
+		snprintf(moms[i].name, sizeof(moms[i].name), "%s%d", prefix, i);
+		moms[i].port = first_port + 2 * i;
+		moms[i].stream = -1;
+		moms[i].state = SIM_MOM_DOWN;
+	}
+
+	if (qmgr_only) {
+		print_qmgr();
+		return 0;
+	}
+
+	srand48(seed >= 0 ? seed : (long) time(NULL) ^ getpid());
+
+	if (pbs_loadconf(0) == 0) {
+		fprintf(stderr, "%s: Configuration error\n", argv[0]);
+		return 1;
+	}
+	set_log_conf(pbs_conf.pbs_leaf_name, pbs_conf.pbs_mom_node_name,
+		     pbs_conf.locallog, pbs_conf.syslogfac,
+		     pbs_conf.syslogsvr, pbs_conf.pbs_log_highres_timestamp);
+
+	server_port = pbs_conf.batch_service_port;
+	if (pbs_conf.pbs_primary)
+		server_name = parse_servername(pbs_conf.pbs_primary, &server_port);
+	else if (pbs_conf.pbs_server_host_name)
+		server_name = parse_servername(pbs_conf.pbs_server_host_name, &server_port);
+	else
+		server_name = parse_servername(pbs_conf.pbs_server_name, &server_port);
+	if (server_name == NULL || (server_name = strdup(server_name)) == NULL) {
+		fprintf(stderr, "%s: unable to determine the server name\n", argv[0]);
+		return 1;
+	}
+
+	if (load_auths(AUTH_SERVER)) {
+		fprintf(stderr, "%s: failed to load auth lib\n", argv[0]);
+		return 1;
+	}
+
+	/*
+	 * all simulated moms share one leaf, named after the mom host and
+	 * registered at the rm port of every mom so the server can reach each
+	 */
+	if ((p = get_all_ips(mom_host, log_buffer, sizeof(log_buffer) - 1)) == NULL) {
+		fprintf(stderr, "%s\n", log_buffer);
+		fprintf(stderr, "%s: unable to determine TPP node name\n", argv[0]);
+		return 1;
+	}
+	if ((leaf_names = mk_leaf_names(p, &naddrs)) == NULL) {
+		fprintf(stderr, "%s: unable to make the TPP node names of %s\n", argv[0], mom_host);
+		return 1;
+	}
+	free(p);
+	if (naddrs > TPP_MAX_LEAF_ADDRS) {
+		fprintf(stderr, "%s: %d moms need %d leaf addresses, more than the %d a leaf can have; "
+			"run several simulators with distinct -p and -N\n",
+			argv[0], nmoms, naddrs, TPP_MAX_LEAF_ADDRS);
+		return 1;
+	}
+	if (set_tpp_config(&pbs_conf, &tpp_conf, leaf_names, first_port + 1, pbs_conf.pbs_leaf_routers) == -1) {
+		fprintf(stderr, "%s: error setting TPP config\n", argv[0]);
+		return 1;
+	}
+	free(leaf_names);
+	tpp_set_app_net_handler(net_down_handler, net_restore_handler);
+	if ((tpp_fd = tpp_init(&tpp_conf)) == -1) {
+		fprintf(stderr, "%s: tpp_init failed\n", argv[0]);
+		return 1;
+	}
+
+	signal(SIGPIPE, SIG_IGN);
+	signal(SIGINT, stop_handler);
+	signal(SIGTERM, stop_handler);
+
+	printf("simulating %d moms (%d vnodes each) for server %s:%u\n",
+	       nmoms, nvnodes, server_name, server_port);
+	fflush(stdout);
+
+	run(tpp_fd);
+
+	for (i = 0; i < nmoms; i++)
+		if (moms[i].stream >= 0)
+			tpp_close(moms[i].stream);
+	tpp_shutdown();
+	unload_auths();
+	return 0;
+}
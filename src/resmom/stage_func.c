@@ -50,7 +50,11 @@
 #include <string.h>
 #include <time.h>
 #include <sys/wait.h>
+#include <sys/time.h>
 #include <dirent.h>
+#ifndef WIN32
+#include <unistd.h>
+#endif
 #include "tpp.h"
 #include "pbs_ifl.h"
 #include "list_link.h"
@@ -1409,6 +1413,165 @@ is_pbs_rcp_path(void)
 	return (0);
 }
 #endif
+
+#ifndef WIN32
+/**
+ * @brief
+ *	local_copy
+ *	copy a regular file within MoM's process instead of
+ *	running the cp command.  The data is moved with copy_file_range()
+ *	where available, read()/write() otherwise.  Like "cp -p", the mode
+ *	and times of the source are preserved.
+ *
+ * @par
+ *	The data is written to a temporary file next to the target which is
+ *	renamed over the target once complete, so a failed copy never leaves
+ *	a truncated target behind.  A target which is the source itself is
+ *	refused, it must not be truncated (the stage out source is removed
+ *	after a successful copy).
+ *
+ * @param[in]	from - source file
+ * @param[in]	to - destination file or directory
+ *
+ * @return	int
+ * @retval	0	copy succeeded
+ * @retval	-1	copy not done (not a regular file, same file, or it
+ *			failed), caller should fall back to running cp which
+ *			also reports the error
+ *
+ * @note
+ *	This is called by the staging child process which already runs as the
+ *	job owner.
+ */
+static int
+local_copy(char *from, char *to)
+{
+	char		target[MAXPATHLEN+1];
+	char		resolved[MAXPATHLEN+1];
+	char		tmpname[MAXPATHLEN+1];
+	char		*base;
+	char		*slash;
+	char		buf[65536];
+	struct stat	sb;
+	struct stat	db;
+	struct timeval	tv[2];
+	struct timeval	start;
+	struct timeval	end;
+	off_t		total = 0;
+	ssize_t		n;
+	int		sfd;
+	int		dfd;
+	int		rc = -1;
+
+	if ((sfd = open(from, O_RDONLY)) == -1)
+		return -1;
+	if ((fstat(sfd, &sb) == -1) || !S_ISREG(sb.st_mode)) {
+		close(sfd);
+		return -1;
+	}
+
+	/* copying into a directory, keep the name of the source */
+	if ((stat(to, &db) == 0) && S_ISDIR(db.st_mode)) {
+		if ((base = strrchr(from, '/')) != NULL)
+			base++;
+		else
+			base = from;
+		if (snprintf(target, sizeof(target), "%s/%s", to, base) >= (int)sizeof(target)) {
+			close(sfd);
+			return -1;
+		}
+	} else
+		pbs_strncpy(target, to, sizeof(target));
+
+	/* an existing target is replaced where it really is, not a symlink to it */
+	if (stat(target, &db) == 0) {
+		if ((db.st_dev == sb.st_dev) && (db.st_ino == sb.st_ino)) {
+			log_eventf(PBSEVENT_DEBUG3, PBS_EVENTCLASS_FILE, LOG_DEBUG, __func__,
+				"%s and %s are the same file", from, target);
+			close(sfd);
+			return -1;
+		}
+		if (!S_ISREG(db.st_mode) || (realpath(target, resolved) == NULL)) {
+			close(sfd);
+			return -1;
+		}
+		pbs_strncpy(target, resolved, sizeof(target));
+	}
+
+	/* temporary file in the directory of the target */
+	if ((slash = strrchr(target, '/')) != NULL)
+		n = snprintf(tmpname, sizeof(tmpname), "%.*s/.pbs_stage.XXXXXX",
+			(int) (slash - target), target);
+	else
+		n = snprintf(tmpname, sizeof(tmpname), ".pbs_stage.XXXXXX");
+	if ((n >= (ssize_t) sizeof(tmpname)) || ((dfd = mkstemp(tmpname)) == -1)) {
+		close(sfd);
+		return -1;
+	}
+
+	gettimeofday(&start, NULL);
+#ifdef HAVE_COPY_FILE_RANGE
+	while ((n = copy_file_range(sfd, NULL, dfd, NULL, 1024 * 1024 * 1024, 0)) > 0)
+		total += n;
+	if (n == 0)
+		goto local_copy_done;
+	if ((total != 0) ||
+		((errno != ENOSYS) && (errno != EXDEV) && (errno != EINVAL) && (errno != EOPNOTSUPP)))
+		goto local_copy_out;
+	/* not supported for these files, fall back to read()/write() */
+#endif
+	while ((n = read(sfd, buf, sizeof(buf))) > 0) {
+		char	*p = buf;
+		ssize_t	w;
+
+		while (n > 0) {
+			if ((w = write(dfd, p, n)) == -1) {
+				if (errno == EINTR)
+					continue;
+				goto local_copy_out;
+			}
+			p += w;
+			n -= w;
+			total += w;
+		}
+	}
+	if (n == -1)
+		goto local_copy_out;
+
+#ifdef HAVE_COPY_FILE_RANGE
+local_copy_done:
+#endif
+	if (fchmod(dfd, sb.st_mode & 07777) == -1)
+		goto local_copy_out;
+	tv[0].tv_sec = sb.st_atime;
+	tv[0].tv_usec = 0;
+	tv[1].tv_sec = sb.st_mtime;
+	tv[1].tv_usec = 0;
+	if (futimes(dfd, tv) == -1)
+		goto local_copy_out;
+	rc = 0;
+
+local_copy_out:
+	if (close(dfd) == -1)
+		rc = -1;
+	close(sfd);
+
+	if ((rc == 0) && (rename(tmpname, target) == -1))
+		rc = -1;
+	if (rc != 0) {
+		(void) unlink(tmpname);
+		return rc;
+	}
+
+	gettimeofday(&end, NULL);
+	log_eventf(PBSEVENT_DEBUG3, PBS_EVENTCLASS_FILE, LOG_DEBUG, __func__,
+		"copied %s to %s, %lld bytes in %ld usecs", from, target,
+		(long long) total,
+		(long) ((end.tv_sec - start.tv_sec) * 1000000 + (end.tv_usec - start.tv_usec)));
+	return rc;
+}
+#endif
+
 /**
  * @brief
  *	sys_copy
@@ -1640,6 +1803,10 @@ sys_copy(int dir, int rmtflg, char *owner, char *src, struct rqfpair *pair, int
 			else
 				ag1 = "-rp";
 
+			/* regular files are copied without running cp */
+			if ((loop == 1) && (local_copy(ag2, ag3) == 0))
+				return (0);
+
 			/* remote, try scp */
 		} else if (pbs_conf.scp_path != NULL && (loop % 2) == 1) {
 			ag0 = pbs_conf.scp_path;
@@ -6222,6 +6222,14 @@ start_exec(job *pjob)
 			pjob->ji_extended.ji_ext.ji_stderr = pjob->ji_ports[1];
 		}
 
+		if (com == IM_JOIN_JOB) {
+			struct timeval tv;
+
+			if (gettimeofday(&tv, NULL) == 0)
+				pjob->ji_joinstart = (double)tv.tv_sec + (double)tv.tv_usec * .000001;
+			pjob->ji_joinscan = 0;
+		}
+
 		for (i = 1; i < nodenum; i++) {
 			np = &pjob->ji_hosts[i];
 
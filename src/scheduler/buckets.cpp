@@ -55,6 +55,7 @@
 #include "sort.h"
 #include "node_partition.h"
 #include "check.h"
+#include "cycle_profile.h"
 #include <log.h>
 #include "pbs_internal.h"
 
@@ -394,6 +395,7 @@ char *create_node_bucket_name(status *policy, node_bucket *nb) {
  */
 node_bucket **
 create_node_buckets(status *policy, node_info **nodes, queue_info **queues, unsigned int flags) {
+	phase_timer timer(PHASE_BUCKETS);
 	int i;
 	int j = 0;
 	node_bucket **buckets = NULL;
@@ -643,11 +645,10 @@ bucket_match(chunk_map **cmap, resource_resv *resresv, schd_error *err)
 	sinfo = resresv->server;
 
 	for (i = 0; cmap[i] != NULL; i++) {
-		if (cmap[i]->bkt_cnts != NULL) {
-			for (j = 0; cmap[i]->bkt_cnts[j] != NULL; j++) {
+		if (cmap[i]->bkt_cnts != NULL && cmap[i]->bkt_cnts[0] != NULL) {
+			pbs_bitmap_assign(cmap[i]->node_bits, zeromap);
+			for (j = 0; cmap[i]->bkt_cnts[j] != NULL; j++)
 				set_working_bucket_to_truth(cmap[i]->bkt_cnts[j]->bkt);
-				pbs_bitmap_assign(cmap[i]->node_bits, zeromap);
-			}
 		}
 	}
 
@@ -1057,6 +1058,7 @@ find_correct_buckets(status *policy, node_bucket **buckets, resource_resv *resre
 nspec **
 check_node_buckets(status *policy, server_info *sinfo, queue_info *qinfo, resource_resv *resresv, schd_error *err)
 {
+	phase_timer timer(PHASE_BUCKETS);
 	node_partition **nodepart = NULL;
 
 	if (policy == NULL || sinfo == NULL || resresv == NULL || err == NULL)
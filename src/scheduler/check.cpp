@@ -101,6 +101,7 @@
 #include "resource.h"
 #include "buckets.h"
 #include "pbs_bitmap.h"
+#include "cycle_profile.h"
 
 
 /**
@@ -698,6 +699,7 @@ nspec **
 is_ok_to_run(status *policy, server_info *sinfo,
 	queue_info *qinfo, resource_resv *resresv, unsigned int flags, schd_error *perr)
 {
+	phase_timer timer(PHASE_IS_OK_TO_RUN);
 	enum sched_error_code rc = SE_NONE;			/* Return Code */
 	schd_resource	*res = NULL;		/* resource list to check */
 	int		endtime = 0;		/* end time of job if started now */
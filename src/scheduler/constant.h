@@ -176,7 +176,8 @@ enum thread_task_type
 	TS_FREE_ND_INFO,
 	TS_DUP_RESRESV,
 	TS_QUERY_JOB_INFO,
-	TS_FREE_RESRESV
+	TS_FREE_RESRESV,
+	TS_SORT_RESRESV
 };
 
 /* return codes for is_ok_to_run_* functions
@@ -311,6 +312,9 @@ enum sort_type
 #endif
 
 
+/* most asynchronous runs send_run_job() queues before sending them */
+#define MAX_RUNJOB_LIST 128
+
 /* Reservation related constants */
 #define MAXVNODELIST 100
 
@@ -0,0 +1,285 @@
+/*
+ * Copyright (C) 1994-2021 Altair Engineering, Inc.
+ * For more information, contact Altair at www.altair.com.
+ *
+ * This file is part of both the OpenPBS software ("OpenPBS")
+ * and the PBS Professional ("PBS Pro") software.
+ *
+ * Open Source License Information:
+ *
+ * OpenPBS is free software. You can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * OpenPBS is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Commercial License Information:
+ *
+ * PBS Pro is commercially licensed software that shares a common core with
+ * the OpenPBS software.  For a copy of the commercial license terms and
+ * conditions, go to: (http://www.pbspro.com/agreement.html) or contact the
+ * Altair Legal Department.
+ *
+ * Altair's dual-license business model allows companies, individuals, and
+ * organizations to create proprietary derivative works of OpenPBS and
+ * distribute them - whether embedded or bundled with other software -
+ * under a commercial license agreement.
+ *
+ * Use of Altair's trademarks, including but not limited to "PBS™",
+ * "OpenPBS®", "PBS Professional®", and "PBS Pro™" and Altair's logos is
+ * subject to Altair's trademark licensing policies.
+ */
+
+
+/**
+ * @file    cycle_profile.cpp
+ *
+ * @brief
+ * 		cycle_profile.cpp - timers and counters for the phases of a scheduling cycle
+ *
+ *	The statistics of each cycle are logged at the end of it and written to
+ *	METRICS_FILE in sched_priv in the Prometheus text format, so a monitoring
+ *	agent can collect them and alert on cycle time regressions.
+ *
+ * Functions included are:
+ * 	profile_cycle_start()
+ * 	profile_job_considered()
+ * 	profile_cycle_end()
+ * 	get_phase_stat()
+ * 	phase_name()
+ *
+ */
+#include <pbs_config.h>
+
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <log.h>
+#include "config.h"
+#include "cycle_profile.h"
+
+/* number of slowest jobs of a cycle which are reported */
+#define PROFILE_SLOWEST_JOBS 10
+
+static const char *phase_names[PHASE_HIGH] = {
+	"query",
+	"sort",
+	"buckets",
+	"is_ok_to_run",
+	"eval_selspec",
+	"calendar",
+	"preempt",
+	"run_request",
+	"end_cycle"
+};
+
+static phase_stat phase_stats[PHASE_HIGH];
+static std::chrono::steady_clock::time_point cycle_start;
+static long jobs_considered;
+static long jobs_run;
+/* slowest jobs of the cycle, kept as a min-heap on the time taken */
+static std::vector<std::pair<double, std::string>> slowest_jobs;
+
+/**
+ * @brief
+ *		account the time since construction to the phase
+ */
+phase_timer::~phase_timer()
+{
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+	phase_stats[phase].secs += elapsed.count();
+	phase_stats[phase].count++;
+}
+
+/**
+ * @brief
+ *		profile_cycle_start - reset the statistics at the start of a cycle
+ *
+ * @return	void
+ */
+void
+profile_cycle_start(void)
+{
+	for (auto &ps : phase_stats) {
+		ps.secs = 0;
+		ps.count = 0;
+	}
+	jobs_considered = 0;
+	jobs_run = 0;
+	slowest_jobs.clear();
+	cycle_start = std::chrono::steady_clock::now();
+}
+
+/**
+ * @brief
+ *		profile_job_considered - account the time the main loop took to
+ *		consider a job and remember it if it is one of the slowest
+ *
+ * @param[in]	name	-	name of the job
+ * @param[in]	secs	-	time taken
+ * @param[in]	ran	-	was the job run?
+ *
+ * @return	void
+ */
+void
+profile_job_considered(const std::string& name, double secs, bool ran)
+{
+	auto cmp = [](const std::pair<double, std::string>& a, const std::pair<double, std::string>& b) {
+		return a.first > b.first;
+	};
+
+	jobs_considered++;
+	if (ran)
+		jobs_run++;
+
+	if (slowest_jobs.size() < PROFILE_SLOWEST_JOBS) {
+		slowest_jobs.emplace_back(secs, name);
+		std::push_heap(slowest_jobs.begin(), slowest_jobs.end(), cmp);
+	} else if (secs > slowest_jobs.front().first) {
+		std::pop_heap(slowest_jobs.begin(), slowest_jobs.end(), cmp);
+		slowest_jobs.back() = std::make_pair(secs, name);
+		std::push_heap(slowest_jobs.begin(), slowest_jobs.end(), cmp);
+	}
+}
+
+/**
+ * @brief
+ *		write the statistics of the cycle to METRICS_FILE
+ *
+ * @param[in]	cycle_secs	-	duration of the cycle
+ * @param[in]	jobs	-	slowest jobs, slowest first
+ *
+ * @return	void
+ */
+static void
+write_metrics(double cycle_secs, const std::vector<std::pair<double, std::string>>& jobs)
+{
+	const char *tmpfile = METRICS_FILE ".new";
+	FILE *fp;
+	int i;
+
+	if ((fp = fopen(tmpfile, "w")) == NULL) {
+		log_eventf(PBSEVENT_DEBUG2, PBS_EVENTCLASS_FILE, LOG_DEBUG, METRICS_FILE,
+			   "Unable to open %s: %s", tmpfile, strerror(errno));
+		return;
+	}
+
+	fprintf(fp, "# HELP pbs_sched_cycle_seconds Duration of the last scheduling cycle.\n");
+	fprintf(fp, "# TYPE pbs_sched_cycle_seconds gauge\n");
+	fprintf(fp, "pbs_sched_cycle_seconds %.6f\n", cycle_secs);
+	fprintf(fp, "# HELP pbs_sched_cycle_end_time Time the last scheduling cycle ended.\n");
+	fprintf(fp, "# TYPE pbs_sched_cycle_end_time gauge\n");
+	fprintf(fp, "pbs_sched_cycle_end_time %ld\n", (long) time(NULL));
+	fprintf(fp, "# HELP pbs_sched_cycle_jobs_considered Jobs considered to run in the last cycle.\n");
+	fprintf(fp, "# TYPE pbs_sched_cycle_jobs_considered gauge\n");
+	fprintf(fp, "pbs_sched_cycle_jobs_considered %ld\n", jobs_considered);
+	fprintf(fp, "# HELP pbs_sched_cycle_jobs_run Jobs run in the last cycle.\n");
+	fprintf(fp, "# TYPE pbs_sched_cycle_jobs_run gauge\n");
+	fprintf(fp, "pbs_sched_cycle_jobs_run %ld\n", jobs_run);
+
+	fprintf(fp, "# HELP pbs_sched_phase_seconds Time spent in a phase of the last cycle, nested phases overlap.\n");
+	fprintf(fp, "# TYPE pbs_sched_phase_seconds gauge\n");
+	for (i = 0; i < PHASE_HIGH; i++)
+		fprintf(fp, "pbs_sched_phase_seconds{phase=\"%s\"} %.6f\n", phase_names[i], phase_stats[i].secs);
+	fprintf(fp, "# HELP pbs_sched_phase_calls Times a phase was entered in the last cycle.\n");
+	fprintf(fp, "# TYPE pbs_sched_phase_calls gauge\n");
+	for (i = 0; i < PHASE_HIGH; i++)
+		fprintf(fp, "pbs_sched_phase_calls{phase=\"%s\"} %ld\n", phase_names[i], phase_stats[i].count);
+
+	fprintf(fp, "# HELP pbs_sched_slow_job_seconds Time taken to consider the slowest jobs of the last cycle.\n");
+	fprintf(fp, "# TYPE pbs_sched_slow_job_seconds gauge\n");
+	for (i = 0; i < static_cast<int>(jobs.size()); i++)
+		fprintf(fp, "pbs_sched_slow_job_seconds{rank=\"%d\",job=\"%s\"} %.6f\n",
+			i + 1, jobs[i].second.c_str(), jobs[i].first);
+
+	if (fclose(fp) != 0 || rename(tmpfile, METRICS_FILE) != 0) {
+		log_eventf(PBSEVENT_DEBUG2, PBS_EVENTCLASS_FILE, LOG_DEBUG, METRICS_FILE,
+			   "Unable to write %s: %s", METRICS_FILE, strerror(errno));
+		unlink(tmpfile);
+	}
+}
+
+/**
+ * @brief
+ *		profile_cycle_end - log the statistics of the cycle and write
+ *		them to METRICS_FILE
+ *
+ * @return	void
+ */
+void
+profile_cycle_end(void)
+{
+	std::chrono::duration<double> cycle_secs = std::chrono::steady_clock::now() - cycle_start;
+	std::vector<std::pair<double, std::string>> jobs(slowest_jobs);
+	char buf[LOG_BUF_SIZE];
+	int len;
+	int i;
+
+	std::sort(jobs.begin(), jobs.end(),
+		  [](const std::pair<double, std::string>& a, const std::pair<double, std::string>& b) {
+			  return a.first > b.first;
+		  });
+
+	if (will_log_event(PBSEVENT_DEBUG2)) {
+		len = snprintf(buf, sizeof(buf), "Cycle took %.3f secs, %ld jobs considered, %ld run;",
+			       cycle_secs.count(), jobs_considered, jobs_run);
+		for (i = 0; i < PHASE_HIGH && len < static_cast<int>(sizeof(buf)); i++)
+			len += snprintf(buf + len, sizeof(buf) - len, " %s=%.3f/%ld",
+					phase_names[i], phase_stats[i].secs, phase_stats[i].count);
+		log_event(PBSEVENT_DEBUG2, PBS_EVENTCLASS_SCHED, LOG_DEBUG, "cycle_profile", buf);
+
+		if (!jobs.empty()) {
+			len = snprintf(buf, sizeof(buf), "Slowest jobs:");
+			for (i = 0; i < static_cast<int>(jobs.size()) && len < static_cast<int>(sizeof(buf)); i++)
+				len += snprintf(buf + len, sizeof(buf) - len, " %s=%.6f",
+						jobs[i].second.c_str(), jobs[i].first);
+			log_event(PBSEVENT_DEBUG2, PBS_EVENTCLASS_SCHED, LOG_DEBUG, "cycle_profile", buf);
+		}
+	}
+
+	write_metrics(cycle_secs.count(), jobs);
+}
+
+/**
+ * @brief
+ *		get_phase_stat - statistics of a phase for the current or, between
+ *		cycles, the last cycle
+ *
+ * @param[in]	phase	-	phase to get
+ *
+ * @return	const phase_stat&
+ */
+const phase_stat&
+get_phase_stat(enum sched_phase phase)
+{
+	return phase_stats[phase];
+}
+
+/**
+ * @brief
+ *		phase_name - printable name of a phase
+ *
+ * @param[in]	phase	-	phase to name
+ *
+ * @return	const char *
+ */
+const char *
+phase_name(enum sched_phase phase)
+{
+	return phase_names[phase];
+}
@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 1994-2021 Altair Engineering, Inc.
+ * For more information, contact Altair at www.altair.com.
+ *
+ * This file is part of both the OpenPBS software ("OpenPBS")
+ * and the PBS Professional ("PBS Pro") software.
+ *
+ * Open Source License Information:
+ *
+ * OpenPBS is free software. You can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * OpenPBS is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Commercial License Information:
+ *
+ * PBS Pro is commercially licensed software that shares a common core with
+ * the OpenPBS software.  For a copy of the commercial license terms and
+ * conditions, go to: (http://www.pbspro.com/agreement.html) or contact the
+ * Altair Legal Department.
+ *
+ * Altair's dual-license business model allows companies, individuals, and
+ * organizations to create proprietary derivative works of OpenPBS and
+ * distribute them - whether embedded or bundled with other software -
+ * under a commercial license agreement.
+ *
+ * Use of Altair's trademarks, including but not limited to "PBS™",
+ * "OpenPBS®", "PBS Professional®", and "PBS Pro™" and Altair's logos is
+ * subject to Altair's trademark licensing policies.
+ */
+
+#ifndef	_CYCLE_PROFILE_H
+#define	_CYCLE_PROFILE_H
+
+#include <chrono>
+#include <string>
+
+/* phases of a scheduling cycle which are timed, times of nested phases overlap */
+enum sched_phase {
+	PHASE_QUERY,		/* query_server() */
+	PHASE_SORT,		/* sort_jobs() */
+	PHASE_BUCKETS,		/* create_node_buckets() and check_node_buckets() */
+	PHASE_IS_OK_TO_RUN,	/* is_ok_to_run() */
+	PHASE_EVAL_SELSPEC,	/* eval_selspec() */
+	PHASE_CALENDAR,		/* add_job_to_calendar() */
+	PHASE_PREEMPT,		/* find_and_preempt_jobs() */
+	PHASE_RUN_REQUEST,	/* send_run_job() */
+	PHASE_END_CYCLE,	/* end_cycle_tasks() */
+	PHASE_HIGH
+};
+
+struct phase_stat {
+	double secs;	/* time spent in the phase this cycle */
+	long count;	/* number of times the phase was entered this cycle */
+};
+
+/*
+ * Times one phase from construction to destruction, use as a local
+ * at the top of the function being timed
+ */
+class phase_timer {
+	enum sched_phase phase;
+	std::chrono::steady_clock::time_point start;
+public:
+	explicit phase_timer(enum sched_phase p) : phase(p), start(std::chrono::steady_clock::now()) {}
+	~phase_timer();
+	phase_timer(const phase_timer&) = delete;
+	phase_timer& operator=(const phase_timer&) = delete;
+};
+
+/*
+ *	profile_cycle_start - reset the statistics at the start of a cycle
+ */
+void profile_cycle_start(void);
+
+/*
+ *	profile_job_considered - account the time taken to consider a job
+ */
+void profile_job_considered(const std::string& name, double secs, bool ran);
+
+/*
+ *	profile_cycle_end - log the statistics of the cycle and write them to METRICS_FILE
+ */
+void profile_cycle_end(void);
+
+/*
+ *	get_phase_stat - statistics of a phase for the current/last cycle
+ */
+const phase_stat& get_phase_stat(enum sched_phase phase);
+
+/*
+ *	phase_name - printable name of a phase
+ */
+const char *phase_name(enum sched_phase phase);
+
+#endif	/* _CYCLE_PROFILE_H */
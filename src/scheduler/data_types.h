@@ -138,6 +138,7 @@ typedef struct th_data_free_ninfo th_data_free_ninfo;
 typedef struct th_data_dup_resresv th_data_dup_resresv;
 typedef struct th_data_query_jinfo th_data_query_jinfo;
 typedef struct th_data_free_resresv th_data_free_resresv;
+typedef struct th_data_sort_resresv th_data_sort_resresv;
 
 
 #ifdef NAS
@@ -245,6 +246,14 @@ struct th_data_free_resresv
 	int eidx;
 };
 
+struct th_data_sort_resresv
+{
+	bool set_keys:1;		/* cache the job_sort_key values before sorting */
+	resource_resv **resresv_arr;
+	int sidx;
+	int eidx;
+};
+
 struct schd_error
 {
 	enum sched_error_code error_code;	/* scheduler error code (see constant.h) */
@@ -815,6 +824,7 @@ class resource_resv
 	int resresv_ind;		   /* resource_resv index in all_resresv array */
 	timed_event *run_event;		   /* run event in calendar */
 	timed_event *end_event;		   /* end event in calendar */
+	std::vector<sch_resource_t> sort_keys; /* job_sort_key values cached by sort_jobs() */
 
 	explicit resource_resv(const std::string& rname);
 	~resource_resv();
@@ -76,6 +76,10 @@
 #include <stdlib.h>
 #include <string.h>
 #include <errno.h>
+#include <unistd.h>
+
+#include <string>
+#include <unordered_map>
 
 #include <log.h>
 
@@ -481,15 +485,16 @@ update_usage_on_run(resource_resv *resresv)
 void
 decay_fairshare_tree(group_info *root)
 {
-	if (root == NULL)
-		return;
-
-	decay_fairshare_tree(root->sibling);
-	decay_fairshare_tree(root->child);
+	/* walk sibling chains iteratively: the unknown group can have a very
+	 * large number of children and recursing on each would blow the stack
+	 */
+	for (group_info *g = root; g != NULL; g = g->sibling) {
+		decay_fairshare_tree(g->child);
 
-	root->usage *= conf.fairshare_decay_factor;
-	if (root->usage < FAIRSHARE_MIN_USAGE)
-		root->usage = FAIRSHARE_MIN_USAGE;
+		g->usage *= conf.fairshare_decay_factor;
+		if (g->usage < FAIRSHARE_MIN_USAGE)
+			g->usage = FAIRSHARE_MIN_USAGE;
+	}
 }
 
 /**
@@ -547,6 +552,11 @@ compare_path(std::vector<group_info *>& gp1, std::vector<group_info *>& gp2)
  *		write_usage - write the usage information to the usage file
  *		      This function uses a recursive helper function
  *
+ * @par
+ *		The usage is written to a temporary file which is then renamed
+ *		over the usage file, so a crash while writing never leaves a
+ *		truncated usage file behind.
+ *
  * @param[in]	filename	-	usage file
  * @param[in]	fhead	-	Pointer to fairshare_head structure.
  *
@@ -558,6 +568,8 @@ write_usage(const char *filename, fairshare_head *fhead)
 {
 	FILE *fp;		/* file pointer to usage file */
 	struct group_node_header head;
+	std::string tmpname;
+	int err;
 
 	if (fhead == NULL)
 		return 0;
@@ -565,8 +577,9 @@ write_usage(const char *filename, fairshare_head *fhead)
 	if (filename == NULL)
 		filename = USAGE_FILE;
 
-	if ((fp = fopen(filename, "wb")) == NULL) {
-		sprintf(log_buffer, "Error opening file %s", filename);
+	tmpname = std::string(filename) + ".new";
+	if ((fp = fopen(tmpname.c_str(), "wb")) == NULL) {
+		sprintf(log_buffer, "Error opening file %s", tmpname.c_str());
 		log_err(errno, "write_usage", log_buffer);
 		return 0;
 	}
@@ -587,7 +600,18 @@ write_usage(const char *filename, fairshare_head *fhead)
 	fwrite(&fhead->last_decay, sizeof(time_t), 1, fp);
 
 	rec_write_usage(fhead->root, fp);
-	fclose(fp);
+
+	err = ferror(fp);
+	if (fflush(fp) != 0 || fsync(fileno(fp)) != 0)
+		err = 1;
+	if (fclose(fp) != 0)
+		err = 1;
+	if (err || rename(tmpname.c_str(), filename) != 0) {
+		sprintf(log_buffer, "Error writing file %s", filename);
+		log_err(errno, "write_usage", log_buffer);
+		unlink(tmpname.c_str());
+		return 0;
+	}
 	return 1;
 }
 
@@ -607,27 +631,93 @@ rec_write_usage(group_info *root, FILE *fp)
 {
 	struct group_node_usage_v2 grp;	/* used to write out usage info */
 
-	if (root == NULL)
-		return;
-
-	/* only write out leaves of the tree (fairshare entities)
-	 * usage defaults to 1 so don't bother writing those out either
-	 * It is possible that the unknown group is empty.  Don't want to write it out
-	 */
+	/* siblings are walked iteratively, see decay_fairshare_tree() */
+	for (group_info *g = root; g != NULL; g = g->sibling) {
+		/* only write out leaves of the tree (fairshare entities)
+		 * usage defaults to 1 so don't bother writing those out either
+		 * It is possible that the unknown group is empty.  Don't want to write it out
+		 */
 #ifdef NAS /* localmod 043 */
-	if (root->child == NULL) {
+		if (g->child == NULL) {
 #else
-	if (root->usage != 1 && root->child == NULL && root->name != UNKNOWN_GROUP_NAME) {
+		if (g->usage != 1 && g->child == NULL && g->name != UNKNOWN_GROUP_NAME) {
 #endif /* localmod 043 */
-		memset(&grp, 0, sizeof(struct group_node_usage_v2));
-		snprintf(grp.name, sizeof(grp.name), "%s", root->name.c_str());
-		grp.usage = root->usage;
+			memset(&grp, 0, sizeof(struct group_node_usage_v2));
+			snprintf(grp.name, sizeof(grp.name), "%s", g->name.c_str());
+			grp.usage = g->usage;
 
-		fwrite(&grp, sizeof(struct group_node_usage_v2), 1, fp);
+			fwrite(&grp, sizeof(struct group_node_usage_v2), 1, fp);
+		}
+
+		rec_write_usage(g->child, fp);
+	}
+}
+
+/**
+ * @brief
+ *		index_fairshare_tree - map the names of all the group_infos in a
+ *			       fairshare tree to the group_infos
+ *
+ * @param[in]	root	-	the root of the current subtree
+ * @param[out]	idx	-	the index to add to
+ *
+ * @return nothing
+ *
+ */
+static void
+index_fairshare_tree(group_info *root, std::unordered_map<std::string, group_info *>& idx)
+{
+	for (group_info *g = root; g != NULL; g = g->sibling) {
+		idx.emplace(g->name, g);
+		index_fairshare_tree(g->child, idx);
 	}
+}
+
+/**
+ * @brief
+ *		find_usage_ginfo - find the group_info for a usage file entry.
+ *			   Like find_alloc_ginfo(), but uses an index of the tree
+ *			   and leaves the calc_fair_share_perc() of the unknown
+ *			   group to the caller, so reading a usage file with many
+ *			   entities does not take quadratic time.
+ *
+ * @param[in]	name	-	name of the entity
+ * @param[in]	alloc	-	allocate the entity in the unknown group if not found
+ * @param[in]	root	-	root of the fairshare tree
+ * @param[in,out]	idx	-	index of the tree
+ * @param[out]	added	-	set to true if a group_info was allocated
+ *
+ * @return	the found or allocated group_info
+ * @retval	NULL	: not found
+ *
+ */
+static group_info *
+find_usage_ginfo(const char *name, bool alloc, group_info *root,
+	std::unordered_map<std::string, group_info *>& idx, bool *added)
+{
+	group_info *ginfo;
+	group_info *unknown;
 
-	rec_write_usage(root->sibling, fp);
-	rec_write_usage(root->child, fp);
+	auto it = idx.find(name);
+	if (it != idx.end())
+		return it->second;
+	if (!alloc)
+		return NULL;
+
+	it = idx.find(UNKNOWN_GROUP_NAME);
+	unknown = (it != idx.end()) ? it->second : NULL;
+	if (unknown == NULL)
+		return find_alloc_ginfo(name, root);
+
+	if ((ginfo = new group_info(name)) == NULL)
+		return NULL;
+
+	ginfo->shares = 1;
+	add_child(ginfo, unknown);
+	idx.emplace(ginfo->name, ginfo);
+	*added = true;
+
+	return ginfo;
 }
 
 /**
@@ -710,13 +800,16 @@ read_usage_v1(FILE *fp, group_info *root)
 {
 	struct group_node_usage_v1 grp;
 	group_info *ginfo;
+	std::unordered_map<std::string, group_info *> idx;
+	bool added = false;
 
 	if (fp == NULL)
 		return 0;
+	index_fairshare_tree(root, idx);
 	memset(&grp, 0, sizeof(struct group_node_usage_v1));
 	while (fread(&grp, sizeof(struct group_node_usage_v1), 1, fp)) {
 		if (grp.usage >= 0 && is_valid_pbs_name(grp.name, USAGE_NAME_MAX)) {
-			ginfo = find_alloc_ginfo(grp.name, root);
+			ginfo = find_usage_ginfo(grp.name, true, root, idx, &added);
 			if (ginfo != NULL) {
 				ginfo->usage = grp.usage;
 				ginfo->temp_usage = grp.usage;
@@ -736,6 +829,9 @@ read_usage_v1(FILE *fp, group_info *root)
 				  "fairshare usage", "Invalid entity");
 	}
 
+	if (added)
+		calc_fair_share_perc(idx[UNKNOWN_GROUP_NAME]->child, UNSPECIFIED);
+
 	return 1;
 }
 
@@ -756,20 +852,20 @@ read_usage_v2(FILE *fp, int flags, group_info *root)
 {
 	struct group_node_usage_v2 grp;
 	group_info *ginfo;
+	std::unordered_map<std::string, group_info *> idx;
+	bool added = false;
 
 	if (fp == NULL)
 		return 0;
 
+	index_fairshare_tree(root, idx);
 	memset(&grp, 0, sizeof(struct group_node_usage_v2));
 	while (fread(&grp, sizeof(struct group_node_usage_v2), 1, fp)) {
 		if (grp.usage >= 0 && is_valid_pbs_name(grp.name, USAGE_NAME_MAX)) {
 			/* if we're trimming the tree, don't add any new nodes which are not
 			 * already in the resource_group file
 			 */
-			if (flags & FS_TRIM)
-				ginfo = find_group_info(grp.name, root);
-			else
-				ginfo = find_alloc_ginfo(grp.name, root);
+			ginfo = find_usage_ginfo(grp.name, !(flags & FS_TRIM), root, idx, &added);
 
 			if (ginfo != NULL) {
 				ginfo->usage = grp.usage;
@@ -790,6 +886,9 @@ read_usage_v2(FILE *fp, int flags, group_info *root)
 				  "fairshare usage", "Invalid entity");
 	}
 
+	if (added)
+		calc_fair_share_perc(idx[UNKNOWN_GROUP_NAME]->child, UNSPECIFIED);
+
 	return 1;
 }
 
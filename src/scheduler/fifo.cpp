@@ -96,6 +96,7 @@
 #include "multi_threading.h"
 #include "pbs_python.h"
 #include "libpbs.h"
+#include "cycle_profile.h"
 
 #ifdef NAS
 #include "site_code.h"
@@ -539,7 +540,9 @@ intermediate_schedule(int sd, const sched_cmd *cmd)
 	int cycle_cnt = 0; /* count of cycles run */
 
 	do {
+		profile_cycle_start();
 		ret = scheduling_cycle(sd, cmd);
+		profile_cycle_end();
 
 		/* don't restart cycle if :- */
 
@@ -599,7 +602,7 @@ scheduling_cycle(int sd, const sched_cmd *cmd)
 	else
 		send_job_attr_updates = 0;
 
-	update_cycle_status(cstat, 0);
+	update_cycle_status(cstat, fixed_cycle_time);
 
 #ifdef NAS /* localmod 030 */
 	do_soft_cycle_interrupt = 0;
@@ -742,7 +745,13 @@ get_high_prio_cmd(int *is_conn_lost, sched_cmd *high_prior_cmd)
 {
 	int i;
 	sched_cmd cmd;
-	svr_conn_t **svr_conns = get_conn_svr_instances(clust_secondary_sock);
+	svr_conn_t **svr_conns;
+
+	/* not connected to a server, e.g. replaying a captured universe */
+	if (clust_secondary_sock < 0)
+		return 0;
+
+	svr_conns = get_conn_svr_instances(clust_secondary_sock);
 	if (svr_conns == NULL) {
 		log_event(PBSEVENT_SCHED, PBS_EVENTCLASS_SCHED, LOG_ERR, __func__,
 			"Unable to fetch secondary connections");
@@ -857,6 +866,7 @@ main_sched_loop(status *policy, int sd, server_info *sinfo, schd_error **rerr)
 		int should_use_buckets;		/* Should use node buckets for a job */
 		unsigned int flags = NO_FLAGS;	/* flags to is_ok_to_run @see is_ok_to_run() */
 		auto qinfo = njob->job->queue;
+		auto job_start = std::chrono::steady_clock::now();
 
 #ifdef NAS /* localmod 030 */
 		if (check_for_cycle_interrupt(1)) {
@@ -1099,6 +1109,9 @@ main_sched_loop(status *policy, int sd, server_info *sinfo, schd_error **rerr)
 
 		/* send any attribute updates to server that we've collected */
 		send_job_updates(sd, njob);
+
+		std::chrono::duration<double> job_secs = std::chrono::steady_clock::now() - job_start;
+		profile_job_considered(njob->name, job_secs.count(), rc == SUCCESS);
 	}
 
 	*rerr = err;
@@ -1119,6 +1132,10 @@ main_sched_loop(status *policy, int sd, server_info *sinfo, schd_error **rerr)
 void
 end_cycle_tasks(server_info *sinfo)
 {
+	/* runs still queued in send_run_job() go out before the cycle ends */
+	send_run_job_list();
+
+	phase_timer timer(PHASE_END_CYCLE);
 	/* keep track of update used resources for fairshare */
 	if (sinfo != NULL && sinfo->policy->fair_share)
 		create_prev_job_info(sinfo->running_jobs);
@@ -1849,6 +1866,7 @@ int
 add_job_to_calendar(int pbs_sd, status *policy, server_info *sinfo,
 	resource_resv *topjob, int use_buckets)
 {
+	phase_timer timer(PHASE_CALENDAR);
 	server_info *nsinfo;		/* dup'd universe to simulate in */
 	resource_resv *njob;		/* the topjob in the dup'd universe */
 	resource_resv *bjob;		/* job pointer which becomes the topjob*/
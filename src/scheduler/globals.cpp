@@ -186,6 +186,9 @@ struct schedattrs sc_attrs;
 
 time_t last_attr_updates = 0;
 
+/* if set, used as the current time of every cycle instead of the clock (replay) */
+time_t fixed_cycle_time = 0;
+
 int send_job_attr_updates = 1;
 
 /* primary socket descriptor to the server pool */
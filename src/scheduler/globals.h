@@ -110,6 +110,8 @@ extern struct schedattrs sc_attrs;
 
 extern time_t last_attr_updates;    /* timestamp of the last time attr updates were sent */
 
+extern time_t fixed_cycle_time;	/* if set, used as the current time of every cycle */
+
 extern int send_job_attr_updates;
 
 extern int clust_primary_sock;
@@ -125,6 +125,7 @@
 #include "attribute.h"
 #include "multi_threading.h"
 #include "libpbs.h"
+#include "cycle_profile.h"
 
 #ifdef NAS
 #include "site_code.h"
@@ -2946,6 +2947,7 @@ struct preempt_ordering *schd_get_preempt_order(resource_resv *resresv)
 int
 find_and_preempt_jobs(status *policy, int pbs_sd, resource_resv *hjob, server_info *sinfo, schd_error *err)
 {
+	phase_timer timer(PHASE_PREEMPT);
 
 	int i = 0;
 	int *jobs = NULL;
@@ -3120,6 +3122,65 @@ find_and_preempt_jobs(status *policy, int pbs_sd, resource_resv *hjob, server_in
 	return rc;
 }
 
+/**
+ * @brief
+ * 		check if there is at least one running job in the real universe
+ *		which select_index_to_preempt() would pick for the high priority job.
+ *		The first pass of the simulation in find_jobs_to_preempt() looks at
+ *		a copy of these same jobs with the same error, so when nothing is
+ *		found here, we can skip duplicating the universe altogether.
+ *
+ * @param[in]	policy		-	policy info
+ * @param[in]	hjob		-	the high priority job
+ * @param[in]	sinfo		-	the server of the jobs to preempt
+ * @param[in]	targets		-	preempt_targets of hjob (or NULL)
+ * @param[in]	full_err	-	reasons hjob can not run
+ * @param[in]	fail_list	-	list of jobs which preemption has failed
+ *
+ * @return	int
+ * @retval	1	: a candidate exists (or we could not tell due to an error)
+ * @retval	0	: no job can be selected for preemption
+ */
+static int
+has_preempt_candidates(status *policy, resource_resv *hjob, server_info *sinfo,
+	char **targets, schd_error *full_err, int *fail_list)
+{
+	resource_resv **cjobs;
+	resource_resv **csubset;
+	schd_error *err;
+	int found = 0;
+
+	if (targets != NULL)
+		cjobs = resource_resv_filter(sinfo->running_jobs,
+			count_array(sinfo->running_jobs),
+			preempt_job_set_filter, (void *) targets, NO_FLAGS);
+	else
+		cjobs = sinfo->running_jobs;
+
+	if (cjobs == NULL)
+		return 1;
+
+	err = dup_schd_error(full_err);	/* only first element */
+	if (err == NULL) {
+		if (cjobs != sinfo->running_jobs)
+			free(cjobs);
+		return 1;
+	}
+
+	csubset = filter_preemptable_jobs(cjobs, hjob, err);
+	if (csubset != NULL) {
+		if (select_index_to_preempt(policy, hjob, csubset, 0, err, fail_list) != NO_JOB_FOUND)
+			found = 1;
+		free(csubset);
+	}
+
+	free_schd_error(err);
+	if (cjobs != sinfo->running_jobs)
+		free(cjobs);
+
+	return found;
+}
+
 
 /**
  * @brief
@@ -3294,6 +3355,14 @@ find_jobs_to_preempt(status *policy, resource_resv *hjob, server_info *sinfo, in
 		}
 	}
 
+	if (!has_preempt_candidates(policy, hjob, sinfo, preempt_targets_list, full_err, fail_list)) {
+		log_event(PBSEVENT_DEBUG2, PBS_EVENTCLASS_JOB, LOG_INFO, hjob->name, "Found no preemptable candidates");
+		free_schd_error_list(full_err);
+		free(pjobs);
+		free_string_array(preempt_targets_list);
+		return NULL;
+	}
+
 	/* use locally dup'd copy of sinfo so we don't modify the original */
 	if ((nsinfo = dup_server_info(sinfo)) == NULL) {
 		free_schd_error_list(full_err);
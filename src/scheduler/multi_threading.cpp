@@ -59,6 +59,7 @@
 #include "fifo.h"
 #include "resource_resv.h"
 #include "multi_threading.h"
+#include "sort.h"
 
 /**
  * @brief	create the thread id key & set it for the main thread
@@ -294,6 +295,11 @@ worker(void *tid)
 				log_event(PBSEVENT_DEBUG3, PBS_EVENTCLASS_SCHED, LOG_DEBUG, __func__, buf);
 				free_resource_resv_array_chunk(static_cast<th_data_free_resresv *>(work->thread_data));
 				break;
+			case TS_SORT_RESRESV:
+				snprintf(buf, sizeof(buf), "Thread %d calling sort_resresv_array_chunk()", ntid);
+				log_event(PBSEVENT_DEBUG3, PBS_EVENTCLASS_SCHED, LOG_DEBUG, __func__, buf);
+				sort_resresv_array_chunk(static_cast<th_data_sort_resresv *>(work->thread_data));
+				break;
 			default:
 				log_event(PBSEVENT_ERROR, PBS_EVENTCLASS_SCHED, LOG_ERR, __func__,
 						"Invalid task type passed to worker thread");
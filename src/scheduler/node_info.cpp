@@ -148,6 +148,7 @@
 #include "pbs_bitmap.h"
 #include "pbs_license.h"
 #include "multi_threading.h"
+#include "cycle_profile.h"
 #ifdef NAS
 #include "site_code.h"
 #endif
@@ -2222,6 +2223,7 @@ eval_selspec(status *policy, selspec *spec, place *placespec,
 	node_info **ninfo_arr, node_partition **nodepart, resource_resv *resresv,
 	unsigned int flags, nspec ***nspec_arr, schd_error *err)
 {
+	phase_timer timer(PHASE_EVAL_SELSPEC);
 	int tot_nodes = -1;
 	place *pl;
 	int can_fit = 0;
@@ -204,6 +204,26 @@ pbs_bitmap_get_bit(pbs_bitmap *pbm, unsigned long bit)
 	return (pbm->bits[long_ind] & b) ? 1 : 0;
 }
 
+/**
+ * @brief find the lowest on bit in a non-zero long
+ * @param word - the long to look at
+ * @return int
+ * @retval index of the lowest on bit
+ */
+static inline int
+lowest_on_bit(unsigned long word)
+{
+#ifdef __GNUC__
+	return __builtin_ctzl(word);
+#else
+	int i;
+
+	for (i = 0; !(word & (1UL << i)); i++)
+		;
+	return i;
+#endif
+}
+
 /**
  * @brief starting at a bit, get the next on bit
  * @param pbm - the bitmap
@@ -211,13 +231,16 @@ pbs_bitmap_get_bit(pbs_bitmap *pbm, unsigned long bit)
  * @return int
  * @retval number of next on bit
  * @retval -1 if there isn't a next on bit
+ *
+ * @par The bitmap is scanned a long at a time, so walking all the on bits
+ *	of a sparse bitmap costs about one instruction per 64 nodes.
  */
 int
 pbs_bitmap_next_on_bit(pbs_bitmap *pbm, unsigned long start_bit)
 {
 	unsigned long long_ind;
-	long bit;
-	size_t i;
+	unsigned long bit;
+	unsigned long word;
 
 	if (pbm == NULL)
 		return -1;
@@ -228,33 +251,19 @@ pbs_bitmap_next_on_bit(pbs_bitmap *pbm, unsigned long start_bit)
 	long_ind = start_bit / BYTES_TO_BITS(sizeof(unsigned long));
 	bit = start_bit % BYTES_TO_BITS(sizeof(unsigned long));
 
-	/* special case - look at first long that contains start_bit */
-	if (pbm->bits[long_ind] != 0) {
-		for (i = bit + 1; i < BYTES_TO_BITS(sizeof(unsigned long)); i++) {
-			if (pbm->bits[long_ind] & (1UL << i)) {
-				return (long_ind * BYTES_TO_BITS(sizeof(unsigned long)) + i);
-			}
-		}
-
-		/* didn't find an on bit after start_bit_index in the long that contained start_bit */
-		if (long_ind < pbm->num_longs) {
-			long_ind++;
-		}
-	}
-
-	for( ; long_ind < pbm->num_longs && pbm->bits[long_ind] == 0; long_ind++)
-		;
-
-	if (long_ind == pbm->num_longs)
-		return -1;
+	/* special case - mask off start_bit and the bits before it in its long */
+	if (bit == BYTES_TO_BITS(sizeof(unsigned long)) - 1)
+		word = 0;
+	else
+		word = pbm->bits[long_ind] & (~0UL << (bit + 1));
 
-	for (i = 0 ; i < BYTES_TO_BITS(sizeof(unsigned long)) ; i++) {
-		if (pbm->bits[long_ind] & (1UL << i)) {
-			return (long_ind * BYTES_TO_BITS(sizeof(unsigned long)) + i);
-		}
+	while (word == 0) {
+		if (++long_ind >= pbm->num_longs)
+			return -1;
+		word = pbm->bits[long_ind];
 	}
 
-	return -1;
+	return (long_ind * BYTES_TO_BITS(sizeof(unsigned long)) + lowest_on_bit(word));
 }
 
 /**
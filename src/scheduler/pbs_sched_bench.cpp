@@ -0,0 +1,1065 @@
+/*
+ * Copyright (C) 1994-2021 Altair Engineering, Inc.
+ * For more information, contact Altair at www.altair.com.
+ *
+ * This file is part of both the OpenPBS software ("OpenPBS")
+ * and the PBS Professional ("PBS Pro") software.
+ *
+ * Open Source License Information:
+ *
+ * OpenPBS is free software. You can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * OpenPBS is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Commercial License Information:
+ *
+ * PBS Pro is commercially licensed software that shares a common core with
+ * the OpenPBS software.  For a copy of the commercial license terms and
+ * conditions, go to: (http://www.pbspro.com/agreement.html) or contact the
+ * Altair Legal Department.
+ *
+ * Altair's dual-license business model allows companies, individuals, and
+ * organizations to create proprietary derivative works of OpenPBS and
+ * distribute them - whether embedded or bundled with other software -
+ * under a commercial license agreement.
+ *
+ * Use of Altair's trademarks, including but not limited to "PBS™",
+ * "OpenPBS®", "PBS Professional®", and "PBS Pro™" and Altair's logos is
+ * subject to Altair's trademark licensing policies.
+ */
+
+/**
+ * @file	pbs_sched_bench.cpp
+ *
+ * @brief
+ *	Microbenchmarks for the hot paths of the scheduler and the libraries
+ *	underneath it.  A synthetic universe of vnodes and jobs of the size
+ *	given on the command line is generated and the IFL stat calls of the
+ *	scheduler are redirected to it, so query_server() and everything
+ *	after it run without a server.  The library benchmarks (DIS, pbs_idx,
+ *	ranges, attribute encode/decode and TPP packets) run in memory.
+ *
+ *	Each benchmark is run for enough iterations to take at least the
+ *	minimum time and is reported in nanoseconds per operation.
+ */
+#include <pbs_config.h> /* the master config generated by configure */
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "attribute.h"
+#include "buckets.h"
+#include "data_types.h"
+#include "dis.h"
+#include "fifo.h"
+#include "globals.h"
+#include "libpbs.h"
+#include "libutil.h"
+#include "limits_if.h"
+#include "log.h"
+#include "misc.h"
+#include "node_info.h"
+#include "pbs_error.h"
+#include "pbs_idx.h"
+#include "pbs_ifl.h"
+#include "pbs_license.h"
+#include "pbs_version.h"
+#include "range.h"
+#include "resource.h"
+#include "resource_resv.h"
+#include "server_info.h"
+#include "sort.h"
+#include "tpp_internal.h"
+
+#define BENCH_SD 0	/* connection handle handed to the scheduler code */
+#define BENCH_FD 0	/* descriptor of the in-memory DIS channel */
+#define NCPUS_PER_NODE 16
+
+static const char usage[] =
+	"[-j jobs] [-n nodes] [-b filter] [-t min_secs] [-d sched_priv] [-l]";
+
+/**
+ * State handed to a benchmark.  The benchmark does its setup, then loops
+ * while keep_running() returns true doing one operation per pass.  Work
+ * which should not be counted is bracketed by pause() and resume().
+ */
+class bench_state {
+public:
+	explicit bench_state(long n) : iterations(n) {}
+
+	bool keep_running()
+	{
+		if (done == 0)
+			start = std::chrono::steady_clock::now();
+		if (done == iterations) {
+			elapsed += std::chrono::steady_clock::now() - start;
+			return false;
+		}
+		done++;
+		return true;
+	}
+	void pause() { elapsed += std::chrono::steady_clock::now() - start; }
+	void resume() { start = std::chrono::steady_clock::now(); }
+	void skip(const char *why) { skipped = why; }
+
+	const long iterations;
+	long done = 0;			/* iterations started */
+	const char *skipped = NULL;	/* why the benchmark could not run */
+	std::chrono::duration<double> elapsed{0};
+
+private:
+	std::chrono::steady_clock::time_point start;
+};
+
+typedef void (*bench_fn)(bench_state &);
+
+/* size of the synthetic universe */
+static int num_jobs = 1000;
+static int num_nodes = 100;
+
+/* the synthetic universe the stat calls are answered from */
+static struct {
+	struct batch_status *server;
+	struct batch_status *sched;
+	struct batch_status *queue;
+	struct batch_status *vnode;
+	struct batch_status *resource;
+	struct batch_status *job;
+} universe;
+
+/* the universe as the scheduler sees it at the start of a cycle */
+static server_info *bench_sinfo = NULL;
+static std::vector<resource_resv *> queued_jobs;
+
+/**
+ * @brief	add an attribute to the end of a batch status object
+ *
+ * @param[in,out]	bs - object to add to
+ * @param[in]	name - attribute name
+ * @param[in]	resource - resource name or NULL
+ * @param[in]	fmt - printf style format of the value
+ *
+ * @return void
+ */
+static void
+add_attr(struct batch_status *bs, const char *name, const char *resource, const char *fmt, ...)
+{
+	struct attrl **tail;
+	struct attrl *attr;
+	char buf[256];
+	va_list ap;
+
+	va_start(ap, fmt);
+	vsnprintf(buf, sizeof(buf), fmt, ap);
+	va_end(ap);
+
+	for (tail = &bs->attribs; *tail != NULL; tail = &(*tail)->next)
+		;
+	attr = new_attrl();
+	attr->name = strdup(name);
+	if (resource != NULL)
+		attr->resource = strdup(resource);
+	attr->value = strdup(buf);
+	*tail = attr;
+}
+
+/**
+ * @brief	append a new object to a batch status list
+ *
+ * @param[in,out]	tail - where the object goes, advanced past it
+ * @param[in]	fmt - printf style format of the name
+ *
+ * @return	struct batch_status *
+ * @retval	the new object
+ */
+static struct batch_status *
+add_object(struct batch_status ***tail, const char *fmt, ...)
+{
+	struct batch_status *bs;
+	char buf[PBS_MAXSVRJOBID + 1];
+	va_list ap;
+
+	va_start(ap, fmt);
+	vsnprintf(buf, sizeof(buf), fmt, ap);
+	va_end(ap);
+
+	bs = static_cast<struct batch_status *>(calloc(1, sizeof(struct batch_status)));
+	if (bs == NULL) {
+		fprintf(stderr, "out of memory\n");
+		exit(1);
+	}
+	bs->name = strdup(buf);
+	**tail = bs;
+	*tail = &bs->next;
+
+	return bs;
+}
+
+/**
+ * @brief	generate the synthetic universe
+ *
+ *	Every fourth job runs on one cpu of a vnode in the first half of the
+ *	vnodes while there is room, the rest are queued with a mix of select
+ *	statements.  Half of the queued jobs ask for exclusive placement so
+ *	they are placed with node buckets on the idle half.
+ *	A user and group run limit is set so check_limits() has work to do.
+ *
+ * @param[in]	now - time the universe is generated for
+ *
+ * @return void
+ */
+static void
+build_universe(time_t now)
+{
+	static const struct {
+		const char *name;
+		int type;
+		int flags;
+	} resources[] = {
+		{"cput", ATR_TYPE_LONG, READ_WRITE | ATR_DFLAG_MOM | ATR_DFLAG_ALTRUN},
+		{"mem", ATR_TYPE_SIZE, READ_WRITE | ATR_DFLAG_MOM | ATR_DFLAG_RASSN | ATR_DFLAG_ANASSN | ATR_DFLAG_CVTSLT},
+		{"walltime", ATR_TYPE_LONG, READ_WRITE | ATR_DFLAG_MOM | ATR_DFLAG_ALTRUN},
+		{"soft_walltime", ATR_TYPE_LONG, MGR_ONLY_SET | ATR_DFLAG_ALTRUN},
+		{"min_walltime", ATR_TYPE_LONG, READ_WRITE | ATR_DFLAG_ALTRUN},
+		{"max_walltime", ATR_TYPE_LONG, READ_WRITE | ATR_DFLAG_ALTRUN},
+		{"ncpus", ATR_TYPE_LONG, READ_WRITE | ATR_DFLAG_MOM | ATR_DFLAG_RASSN | ATR_DFLAG_ANASSN | ATR_DFLAG_CVTSLT},
+		{"nodect", ATR_TYPE_LONG, READ_ONLY | ATR_DFLAG_MGWR | ATR_DFLAG_RASSN},
+		{"arch", ATR_TYPE_STR, READ_WRITE | ATR_DFLAG_CVTSLT | ATR_DFLAG_MOM},
+		{"host", ATR_TYPE_STR, READ_WRITE | ATR_DFLAG_CVTSLT},
+		{"vnode", ATR_TYPE_STR, READ_WRITE | ATR_DFLAG_CVTSLT},
+		{"aoe", ATR_TYPE_ARST, READ_WRITE | ATR_DFLAG_CVTSLT},
+		{"eoe", ATR_TYPE_ARST, READ_WRITE | ATR_DFLAG_CVTSLT},
+		{"preempt_targets", ATR_TYPE_ARST, READ_WRITE},
+		{"select", ATR_TYPE_STR, READ_WRITE},
+		{"place", ATR_TYPE_STR, READ_WRITE | ATR_DFLAG_MOM},
+	};
+	struct batch_status **tail;
+	struct batch_status *bs;
+	std::vector<int> assigned(num_nodes, 0);
+
+	tail = &universe.resource;
+	for (const auto &r : resources) {
+		bs = add_object(&tail, "%s", r.name);
+		add_attr(bs, ATTR_RESC_TYPE, NULL, "%d", r.type);
+		add_attr(bs, ATTR_RESC_FLAG, NULL, "%d", r.flags);
+	}
+
+	tail = &universe.server;
+	bs = add_object(&tail, "bench");
+	add_attr(bs, ATTR_status, NULL, "Active");
+	add_attr(bs, ATTR_max_run, NULL, "[u:PBS_GENERIC=%d]", std::max(num_jobs / 8, 1));
+	add_attr(bs, ATTR_max_run_res, "ncpus", "[g:PBS_GENERIC=%d]", std::max(num_nodes * NCPUS_PER_NODE / 2, 1));
+
+	tail = &universe.sched;
+	bs = add_object(&tail, "%s", PBS_DFLT_SCHED_NAME);
+	add_attr(bs, ATTR_scheduling, NULL, "True");
+
+	tail = &universe.queue;
+	bs = add_object(&tail, "workq");
+	add_attr(bs, ATTR_qtype, NULL, "Execution");
+	add_attr(bs, ATTR_enable, NULL, "True");
+	add_attr(bs, ATTR_start, NULL, "True");
+
+	tail = &universe.job;
+	for (int i = 0; i < num_jobs; i++) {
+		int node = (i / 4) % ((num_nodes + 1) / 2);
+		bool running = i % 4 == 0 && assigned[node] < NCPUS_PER_NODE;
+		int chunks = running ? 1 : i % 4 + 1;
+		int ncpus = running ? 1 : 1 << (i % 3);
+		const char *place = (!running && i % 2) ? "excl" : "free";
+
+		bs = add_object(&tail, "%d.bench", i);
+		add_attr(bs, ATTR_N, NULL, "job%d", i);
+		add_attr(bs, ATTR_state, NULL, running ? "R" : "Q");
+		add_attr(bs, ATTR_substate, NULL, "%d", running ? 42 : 10);
+		add_attr(bs, ATTR_euser, NULL, "user%d", i % 16);
+		add_attr(bs, ATTR_egroup, NULL, "group%d", i % 4);
+		add_attr(bs, ATTR_project, NULL, "_pbs_project_default");
+		add_attr(bs, ATTR_p, NULL, "%d", i % 7);
+		add_attr(bs, ATTR_qtime, NULL, "%ld", (long) (now - num_jobs + i));
+		add_attr(bs, ATTR_etime, NULL, "%ld", (long) (now - num_jobs + i));
+		add_attr(bs, ATTR_SchedSelect, NULL, "%d:ncpus=%d:mem=%dgb", chunks, ncpus, ncpus);
+		add_attr(bs, ATTR_l, "select", "%d:ncpus=%d:mem=%dgb", chunks, ncpus, ncpus);
+		add_attr(bs, ATTR_l, "place", "%s", place);
+		add_attr(bs, ATTR_l, "ncpus", "%d", chunks * ncpus);
+		add_attr(bs, ATTR_l, "mem", "%dgb", chunks * ncpus);
+		add_attr(bs, ATTR_l, "nodect", "%d", chunks);
+		add_attr(bs, ATTR_l, "walltime", "01:00:00");
+		if (running) {
+			assigned[node]++;
+			add_attr(bs, ATTR_stime, NULL, "%ld", (long) (now - 60));
+			add_attr(bs, ATTR_execvnode, NULL, "(node%d:ncpus=1:mem=1gb)", node);
+		}
+	}
+
+	tail = &universe.vnode;
+	for (int i = 0; i < num_nodes; i++) {
+		bs = add_object(&tail, "node%d", i);
+		add_attr(bs, ATTR_NODE_Mom, NULL, "node%d", i);
+		add_attr(bs, ATTR_NODE_Port, NULL, "15002");
+		add_attr(bs, ATTR_NODE_state, NULL, "free");
+		add_attr(bs, ATTR_NODE_ntype, NULL, "PBS");
+		add_attr(bs, ATTR_NODE_Sharing, NULL, "default_shared");
+		add_attr(bs, ATTR_NODE_License, NULL, ND_LIC_locked_str);
+		add_attr(bs, ATTR_rescavail, "arch", "linux");
+		add_attr(bs, ATTR_rescavail, "host", "node%d", i);
+		add_attr(bs, ATTR_rescavail, "vnode", "node%d", i);
+		add_attr(bs, ATTR_rescavail, "ncpus", "%d", NCPUS_PER_NODE);
+		add_attr(bs, ATTR_rescavail, "mem", "%dgb", NCPUS_PER_NODE);
+		add_attr(bs, ATTR_rescassn, "ncpus", "%d", assigned[i]);
+		add_attr(bs, ATTR_rescassn, "mem", "%dgb", assigned[i]);
+	}
+}
+
+/**
+ * @brief	copy universe objects the way a server would return them
+ *
+ * @param[in]	bs - universe list
+ * @param[in]	id - name of the object to return, NULL or "" for all
+ *
+ * @return	struct batch_status *
+ * @retval	copy of the selected objects, freed by pbs_statfree()
+ */
+static struct batch_status *
+bench_stat(struct batch_status *bs, const char *id)
+{
+	struct batch_status *head = NULL;
+	struct batch_status **tail = &head;
+
+	pbs_errno = PBSE_NONE;
+
+	for (; bs != NULL; bs = bs->next) {
+		struct attrl **atail;
+
+		if (id != NULL && *id != '\0' && strcmp(bs->name, id) != 0)
+			continue;
+
+		*tail = static_cast<struct batch_status *>(calloc(1, sizeof(struct batch_status)));
+		(*tail)->name = strdup(bs->name);
+		atail = &(*tail)->attribs;
+		for (auto attr = bs->attribs; attr != NULL; attr = attr->next) {
+			*atail = dup_attrl(attr);
+			atail = &(*atail)->next;
+		}
+		tail = &(*tail)->next;
+	}
+
+	return head;
+}
+
+/*
+ * Replacements for the IFL calls made by the scheduler.  All jobs are in
+ * the one queue, so the queue selection criteria need not be looked at.
+ */
+
+static struct batch_status *
+bench_statserver(int c, struct attrl *attrib, char *extend)
+{
+	return bench_stat(universe.server, NULL);
+}
+
+static struct batch_status *
+bench_statsched(int c, struct attrl *attrib, char *extend)
+{
+	return bench_stat(universe.sched, NULL);
+}
+
+static struct batch_status *
+bench_statrsc(int c, char *id, struct attrl *attrib, char *extend)
+{
+	return bench_stat(universe.resource, id);
+}
+
+static struct batch_status *
+bench_statque(int c, char *id, struct attrl *attrib, char *extend)
+{
+	return bench_stat(universe.queue, id);
+}
+
+static struct batch_status *
+bench_statvnode(int c, char *id, struct attrl *attrib, char *extend)
+{
+	return bench_stat(universe.vnode, id);
+}
+
+static struct batch_status *
+bench_statresv(int c, char *id, struct attrl *attrib, char *extend)
+{
+	pbs_errno = PBSE_NONE;
+	return NULL;
+}
+
+static struct batch_status *
+bench_selstat(int c, struct attropl *attrib, struct attrl *rattrib, char *extend)
+{
+	return bench_stat(universe.job, NULL);
+}
+
+static char *
+bench_geterrmsg(int c)
+{
+	return NULL;
+}
+
+static int
+bench_alterjob(int c, char *jobid, struct attrl *attrib, char *extend)
+{
+	return 0;
+}
+
+static int
+bench_manager(int c, int command, int objtype, char *objname, struct attropl *attrib, char *extend)
+{
+	return 0;
+}
+
+/**
+ * @brief	free a server_info returned by query_server()
+ *
+ *	The fairshare tree belongs to the scheduler, not the server_info.
+ *
+ * @param[in]	sinfo - server to free
+ *
+ * @return void
+ */
+static void
+release_server(server_info *sinfo)
+{
+	sinfo->fstree = NULL;
+	free_server(sinfo);
+}
+
+static void
+bm_query_server(bench_state &st)
+{
+	while (st.keep_running()) {
+		server_info *sinfo = query_server(&cstat, BENCH_SD);
+
+		st.pause();
+		if (sinfo == NULL) {
+			st.skip("query_server failed");
+			return;
+		}
+		release_server(sinfo);
+		st.resume();
+	}
+}
+
+static void
+bm_dup_server_info(bench_state &st)
+{
+	while (st.keep_running()) {
+		server_info *nsinfo = dup_server_info(bench_sinfo);
+
+		free_server(nsinfo);
+	}
+}
+
+static void
+bm_sort_jobs(bench_state &st)
+{
+	std::mt19937 rng(1);
+
+	while (st.keep_running()) {
+		st.pause();
+		std::shuffle(bench_sinfo->jobs, bench_sinfo->jobs + bench_sinfo->sc.total, rng);
+		for (int i = 0; i < bench_sinfo->num_queues; i++) {
+			queue_info *qinfo = bench_sinfo->queues[i];
+
+			std::shuffle(qinfo->jobs, qinfo->jobs + qinfo->sc.total, rng);
+		}
+		st.resume();
+		sort_jobs(bench_sinfo->policy, bench_sinfo);
+	}
+}
+
+static void
+bm_check_limits(bench_state &st)
+{
+	schd_error *err = new_schd_error();
+
+	for (long i = 0; st.keep_running(); i++) {
+		resource_resv *rr = queued_jobs[i % queued_jobs.size()];
+
+		clear_schd_error(err);
+		check_limits(bench_sinfo, rr->job->queue, rr, err, CHECK_LIMIT);
+	}
+	free_schd_error(err);
+}
+
+static void
+bm_eval_selspec(bench_state &st)
+{
+	schd_error *err = new_schd_error();
+
+	for (long i = 0; st.keep_running(); i++) {
+		resource_resv *rr = queued_jobs[i % queued_jobs.size()];
+		nspec **ns = NULL;
+
+		clear_schd_error(err);
+		eval_selspec(bench_sinfo->policy, rr->select, rr->place_spec,
+			     bench_sinfo->unassoc_nodes, NULL, rr, NO_FLAGS, &ns, err);
+		free_nspecs(ns);
+	}
+	free_schd_error(err);
+}
+
+static void
+bm_bucket_match(bench_state &st)
+{
+	std::vector<std::pair<resource_resv *, chunk_map **>> cmaps;
+	schd_error *err = new_schd_error();
+
+	if (bench_sinfo->buckets != NULL) {
+		for (auto rr : queued_jobs) {
+			chunk_map **cmap;
+
+			clear_schd_error(err);
+			cmap = find_correct_buckets(bench_sinfo->policy, bench_sinfo->buckets, rr, err);
+			if (cmap != NULL)
+				cmaps.emplace_back(rr, cmap);
+		}
+	}
+	if (cmaps.empty()) {
+		st.skip("no jobs are placed with buckets");
+		free_schd_error(err);
+		return;
+	}
+
+	for (long i = 0; st.keep_running(); i++) {
+		auto &cm = cmaps[i % cmaps.size()];
+
+		clear_schd_error(err);
+		bucket_match(cm.second, cm.first, err);
+	}
+
+	for (auto &cm : cmaps)
+		free_chunk_map_array(cm.second);
+	free_schd_error(err);
+}
+
+/*
+ * An in-memory DIS transport: everything sent on BENCH_FD is appended to
+ * the wire buffer and reads are served from it.
+ */
+static pbs_tcp_chan_t *bench_chan = NULL;
+static std::string wire;
+static size_t wire_pos = 0;
+
+static pbs_tcp_chan_t *
+bench_get_chan(int fd)
+{
+	return bench_chan;
+}
+
+static int
+bench_set_chan(int fd, pbs_tcp_chan_t *chan)
+{
+	bench_chan = chan;
+	return 0;
+}
+
+static int
+bench_send(int fd, void *data, int len)
+{
+	wire.append(static_cast<char *>(data), len);
+	return len;
+}
+
+static int
+bench_recv(int fd, void *data, int len)
+{
+	if (wire_pos + len > wire.size())
+		return -2;
+	memcpy(data, wire.data() + wire_pos, len);
+	wire_pos += len;
+	return len;
+}
+
+/**
+ * @brief	point the DIS transport at the in-memory wire
+ *
+ * @return void
+ */
+static void
+setup_dis(void)
+{
+	pfn_transport_get_chan = bench_get_chan;
+	pfn_transport_set_chan = bench_set_chan;
+	pfn_transport_send = bench_send;
+	pfn_transport_recv = bench_recv;
+	dis_setup_chan(BENCH_FD, bench_get_chan);
+}
+
+static void
+bm_dis_encode_attrl(bench_state &st)
+{
+	while (st.keep_running()) {
+		wire.clear();
+		encode_DIS_attrl(BENCH_FD, universe.job->attribs);
+		dis_flush(BENCH_FD);
+	}
+}
+
+static void
+bm_dis_decode_attrl(bench_state &st)
+{
+	wire.clear();
+	encode_DIS_attrl(BENCH_FD, universe.job->attribs);
+	dis_flush(BENCH_FD);
+
+	while (st.keep_running()) {
+		struct attrl *attribs = NULL;
+
+		wire_pos = 0;
+		dis_reset_buf(BENCH_FD, DIS_READ_BUF);
+		if (decode_DIS_attrl(BENCH_FD, &attribs) != DIS_SUCCESS) {
+			st.skip("decode_DIS_attrl failed");
+			return;
+		}
+		free_attrl_list(attribs);
+	}
+}
+
+/**
+ * @brief	make the job ids used as index keys
+ *
+ * @return	std::vector<std::string>
+ */
+static std::vector<std::string>
+make_keys(void)
+{
+	std::vector<std::string> keys;
+
+	for (int i = 0; i < num_jobs; i++)
+		keys.push_back(std::to_string(i) + ".bench");
+	return keys;
+}
+
+static void
+bench_idx_insert(bench_state &st, int flags)
+{
+	auto keys = make_keys();
+	void *idx = pbs_idx_create(flags, 0);
+
+	for (long i = 0; st.keep_running(); i++) {
+		if (i > 0 && i % keys.size() == 0) {
+			st.pause();
+			pbs_idx_destroy(idx);
+			idx = pbs_idx_create(flags, 0);
+			st.resume();
+		}
+		pbs_idx_insert(idx, const_cast<char *>(keys[i % keys.size()].c_str()), &keys);
+	}
+	pbs_idx_destroy(idx);
+}
+
+static void
+bench_idx_find(bench_state &st, int flags)
+{
+	auto keys = make_keys();
+	void *idx = pbs_idx_create(flags, 0);
+
+	for (auto &k : keys)
+		pbs_idx_insert(idx, const_cast<char *>(k.c_str()), &k);
+
+	for (long i = 0; st.keep_running(); i++) {
+		void *key = const_cast<char *>(keys[i % keys.size()].c_str());
+		void *data;
+
+		pbs_idx_find(idx, &key, &data, NULL);
+	}
+	pbs_idx_destroy(idx);
+}
+
+static void
+bm_idx_insert(bench_state &st)
+{
+	bench_idx_insert(st, 0);
+}
+
+static void
+bm_idx_find(bench_state &st)
+{
+	bench_idx_find(st, 0);
+}
+
+static void
+bm_idx_hash_insert(bench_state &st)
+{
+	bench_idx_insert(st, PBS_IDX_HASH);
+}
+
+static void
+bm_idx_hash_find(bench_state &st)
+{
+	bench_idx_find(st, PBS_IDX_HASH);
+}
+
+static void
+bm_range_parse(bench_state &st)
+{
+	std::string str = "0-" + std::to_string(num_jobs - 1) + ":3," +
+			  std::to_string(num_jobs) + "-" + std::to_string(2 * num_jobs);
+
+	while (st.keep_running())
+		free_range_list(range_parse(const_cast<char *>(str.c_str())));
+}
+
+static void
+bm_range_add_remove(bench_state &st)
+{
+	range *r = new_range(0, num_jobs - 1, 1, num_jobs, NULL);
+
+	for (long i = 0; st.keep_running(); i++) {
+		int val = (i * 7919) % num_jobs;
+
+		range_remove_value(&r, val);
+		range_add_value(&r, val, ENABLE_SUBRANGE_STEPPING);
+	}
+	free_range_list(r);
+}
+
+static void
+bm_range_to_str(bench_state &st)
+{
+	range *r = new_range(0, num_jobs - 1, 1, num_jobs, NULL);
+
+	/* punch holes so the string has many subranges */
+	for (int i = 0; i < num_jobs; i += 5)
+		range_remove_value(&r, i);
+
+	while (st.keep_running())
+		range_to_str(r);
+	free_range_list(r);
+}
+
+static void
+bm_attr_size(bench_state &st)
+{
+	attribute attr;
+	pbs_list_head head;
+
+	memset(&attr, 0, sizeof(attr));
+	CLEAR_HEAD(head);
+	while (st.keep_running()) {
+		decode_size(&attr, const_cast<char *>(ATTR_l), const_cast<char *>("mem"), const_cast<char *>("16gb"));
+		encode_size(&attr, &head, const_cast<char *>(ATTR_l), const_cast<char *>("mem"), ATR_ENCODE_CLIENT, NULL);
+		free_attrlist(&head);
+	}
+}
+
+static void
+bm_attr_long(bench_state &st)
+{
+	attribute attr;
+	pbs_list_head head;
+
+	memset(&attr, 0, sizeof(attr));
+	CLEAR_HEAD(head);
+	while (st.keep_running()) {
+		decode_l(&attr, const_cast<char *>(ATTR_l), const_cast<char *>("ncpus"), const_cast<char *>("128"));
+		encode_l(&attr, &head, const_cast<char *>(ATTR_l), const_cast<char *>("ncpus"), ATR_ENCODE_CLIENT, NULL);
+		free_attrlist(&head);
+	}
+}
+
+static void
+bm_attr_str(bench_state &st)
+{
+	attribute attr;
+	pbs_list_head head;
+
+	memset(&attr, 0, sizeof(attr));
+	CLEAR_HEAD(head);
+	while (st.keep_running()) {
+		decode_str(&attr, const_cast<char *>(ATTR_euser), NULL, const_cast<char *>("user0"));
+		encode_str(&attr, &head, const_cast<char *>(ATTR_euser), NULL, ATR_ENCODE_CLIENT, NULL);
+		free_attrlist(&head);
+		free_str(&attr);
+	}
+}
+
+static void
+bm_tpp_pkt(bench_state &st)
+{
+	char payload[1024];
+	std::vector<char> buf;
+
+	memset(payload, 'x', sizeof(payload));
+	for (long i = 0; st.keep_running(); i++) {
+		tpp_data_pkt_hdr_t *dhdr = NULL;
+		tpp_data_pkt_hdr_t rhdr;
+		tpp_packet_t *pkt;
+		tpp_chunk_t *chunk;
+
+		/* build a data packet the way tpp_send() does */
+		pkt = tpp_bld_pkt(NULL, NULL, sizeof(tpp_data_pkt_hdr_t), 1, (void **) &dhdr);
+		memset(dhdr, 0, sizeof(tpp_data_pkt_hdr_t));
+		dhdr->type = TPP_DATA;
+		dhdr->src_sd = htonl(i);
+		dhdr->src_magic = htonl(1);
+		dhdr->dest_sd = htonl(i + 1);
+		dhdr->totlen = htonl(sizeof(payload));
+		tpp_bld_pkt(pkt, payload, sizeof(payload), 1, NULL);
+		dhdr->ntotlen = htonl(pkt->totlen);
+
+		/* flatten it as the transport would put it on the wire */
+		buf.clear();
+		for (chunk = static_cast<tpp_chunk_t *>(GET_NEXT(pkt->chunks)); chunk != NULL;
+		     chunk = static_cast<tpp_chunk_t *>(GET_NEXT(chunk->chunk_link)))
+			buf.insert(buf.end(), chunk->data, chunk->data + chunk->len);
+		tpp_free_pkt(pkt);
+
+		/* and parse it back as the receiving side does */
+		if (tpp_validate_hdr(-1, buf.data()) != 0) {
+			st.skip("tpp_validate_hdr failed");
+			return;
+		}
+		memcpy(&rhdr, buf.data(), sizeof(rhdr));
+		if (ntohl(rhdr.ntotlen) != buf.size() || ntohl(rhdr.dest_sd) != (unsigned int) (i + 1) ||
+		    ntohl(rhdr.totlen) != buf.size() - sizeof(rhdr)) {
+			st.skip("tpp packet did not parse back");
+			return;
+		}
+	}
+}
+
+static const struct {
+	const char *name;
+	bench_fn fn;
+	bool needs_universe;	/* runs on the scheduler's view of the universe */
+} benchmarks[] = {
+	{"query_server", bm_query_server, true},
+	{"dup_server_info", bm_dup_server_info, true},
+	{"sort_jobs", bm_sort_jobs, true},
+	{"check_limits", bm_check_limits, true},
+	{"eval_selspec", bm_eval_selspec, true},
+	{"bucket_match", bm_bucket_match, true},
+	{"dis_encode_attrl", bm_dis_encode_attrl, false},
+	{"dis_decode_attrl", bm_dis_decode_attrl, false},
+	{"pbs_idx_insert", bm_idx_insert, false},
+	{"pbs_idx_find", bm_idx_find, false},
+	{"pbs_idx_hash_insert", bm_idx_hash_insert, false},
+	{"pbs_idx_hash_find", bm_idx_hash_find, false},
+	{"range_parse", bm_range_parse, false},
+	{"range_add_remove", bm_range_add_remove, false},
+	{"range_to_str", bm_range_to_str, false},
+	{"attr_size", bm_attr_size, false},
+	{"attr_long", bm_attr_long, false},
+	{"attr_str", bm_attr_str, false},
+	{"tpp_pkt", bm_tpp_pkt, false},
+};
+
+/**
+ * @brief	run a benchmark for at least the minimum time and report it
+ *
+ *	The iteration count starts at one and grows towards the count
+ *	predicted to take the minimum time, as Google Benchmark does.
+ *
+ * @param[in]	name - benchmark name
+ * @param[in]	fn - benchmark
+ * @param[in]	min_time - minimum seconds to run for
+ *
+ * @return void
+ */
+static void
+run_benchmark(const char *name, bench_fn fn, double min_time)
+{
+	long n = 1;
+
+	for (;;) {
+		bench_state st(n);
+
+		fn(st);
+		if (st.skipped != NULL) {
+			printf("%-24s %12s   skipped: %s\n", name, "", st.skipped);
+			return;
+		}
+		if (st.elapsed.count() >= min_time || n >= 1000000000L) {
+			printf("%-24s %12ld %14.1f ns/op\n", name, n, st.elapsed.count() * 1e9 / n);
+			return;
+		}
+		if (st.elapsed.count() <= 0)
+			n *= 10;
+		else
+			n = std::min(n * 10, std::max(n + 1, static_cast<long>(n * min_time * 1.4 / st.elapsed.count())));
+	}
+}
+
+/**
+ * @brief	set up the scheduler against the synthetic universe
+ *
+ * @return	int
+ * @retval	0 on success
+ * @retval	1 on failure
+ */
+static int
+setup_scheduler(void)
+{
+	if (!update_resource_defs(BENCH_SD)) {
+		fprintf(stderr, "Unable to load resource definitions\n");
+		return 1;
+	}
+	if (!set_validate_sched_attrs(BENCH_SD)) {
+		fprintf(stderr, "Unable to set the scheduler attributes\n");
+		return 1;
+	}
+
+	update_cycle_status(cstat, fixed_cycle_time);
+	if ((bench_sinfo = query_server(&cstat, BENCH_SD)) == NULL) {
+		fprintf(stderr, "query_server failed on the synthetic universe\n");
+		return 1;
+	}
+	if (init_scheduling_cycle(bench_sinfo->policy, BENCH_SD, bench_sinfo) == 0) {
+		fprintf(stderr, "init_scheduling_cycle failed\n");
+		return 1;
+	}
+	for (int i = 0; bench_sinfo->jobs[i] != NULL; i++) {
+		if (in_runnable_state(bench_sinfo->jobs[i]))
+			queued_jobs.push_back(bench_sinfo->jobs[i]);
+	}
+	if (queued_jobs.empty()) {
+		fprintf(stderr, "no queued jobs in the synthetic universe\n");
+		return 1;
+	}
+	printf("universe: %d vnodes, %d jobs, %zu queued\n",
+	       bench_sinfo->num_nodes, bench_sinfo->sc.total, queued_jobs.size());
+
+	return 0;
+}
+
+int
+main(int argc, char *argv[])
+{
+	int c;
+	int errflg = 0;
+	char *filter = NULL;
+	char *priv_dir = NULL;
+	double min_time = 0.5;
+	bool list = false;
+	bool need_universe = false;
+
+	PRINT_VERSION_AND_EXIT(argc, argv);
+
+	if (set_msgdaemonname(const_cast<char *>("pbs_sched_bench"))) {
+		fprintf(stderr, "Out of memory\n");
+		return 1;
+	}
+
+	while ((c = getopt(argc, argv, "j:n:b:t:d:l")) != EOF) {
+		switch (c) {
+			case 'j':
+				num_jobs = atoi(optarg);
+				if (num_jobs < 1)
+					errflg = 1;
+				break;
+			case 'n':
+				num_nodes = atoi(optarg);
+				if (num_nodes < 1)
+					errflg = 1;
+				break;
+			case 'b':
+				filter = optarg;
+				break;
+			case 't':
+				min_time = atof(optarg);
+				if (min_time <= 0)
+					errflg = 1;
+				break;
+			case 'd':
+				priv_dir = optarg;
+				break;
+			case 'l':
+				list = true;
+				break;
+			default:
+				errflg = 1;
+		}
+	}
+
+	if (errflg || optind != argc) {
+		fprintf(stderr, "usage: %s %s\n", argv[0], usage);
+		fprintf(stderr, "       %s --version\n", argv[0]);
+		return 1;
+	}
+
+	if (list) {
+		for (const auto &b : benchmarks)
+			printf("%s\n", b.name);
+		return 0;
+	}
+
+	for (const auto &b : benchmarks) {
+		if (b.needs_universe && (filter == NULL || strstr(b.name, filter) != NULL))
+			need_universe = true;
+	}
+
+	if (pbs_loadconf(0) == 0) {
+		fprintf(stderr, "%s: unable to read the PBS configuration\n", argv[0]);
+		return 1;
+	}
+
+	if (pbs_client_thread_init_thread_context() != 0) {
+		fprintf(stderr, "%s: unable to initialize thread context\n", argv[0]);
+		return 1;
+	}
+
+	if (priv_dir != NULL && chdir(priv_dir) == -1) {
+		perror(priv_dir);
+		return 1;
+	}
+
+	fixed_cycle_time = time(NULL);
+	build_universe(fixed_cycle_time);
+	setup_dis();
+
+	if (need_universe) {
+		sc_name = PBS_DFLT_SCHED_NAME;
+		dflt_sched = 1;
+		pfn_pbs_statserver = bench_statserver;
+		pfn_pbs_statsched = bench_statsched;
+		pfn_pbs_statrsc = bench_statrsc;
+		pfn_pbs_statque = bench_statque;
+		pfn_pbs_statvnode = bench_statvnode;
+		pfn_pbs_statresv = bench_statresv;
+		pfn_pbs_selstat = bench_selstat;
+		pfn_pbs_geterrmsg = bench_geterrmsg;
+		pfn_pbs_asyalterjob = bench_alterjob;
+		pfn_pbs_manager = bench_manager;
+
+		if (schedinit(-1) != 0) {
+			fprintf(stderr, "%s: scheduler initialization failed\n", argv[0]);
+			return 1;
+		}
+		if (setup_scheduler() != 0)
+			return 1;
+	}
+
+	printf("%-24s %12s %17s\n", "benchmark", "iterations", "time");
+	for (const auto &b : benchmarks) {
+		if (filter == NULL || strstr(b.name, filter) != NULL)
+			run_benchmark(b.name, b.fn, min_time);
+	}
+
+	return 0;
+}
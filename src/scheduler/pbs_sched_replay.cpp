@@ -0,0 +1,966 @@
+/*
+ * Copyright (C) 1994-2021 Altair Engineering, Inc.
+ * For more information, contact Altair at www.altair.com.
+ *
+ * This file is part of both the OpenPBS software ("OpenPBS")
+ * and the PBS Professional ("PBS Pro") software.
+ *
+ * Open Source License Information:
+ *
+ * OpenPBS is free software. You can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * OpenPBS is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Commercial License Information:
+ *
+ * PBS Pro is commercially licensed software that shares a common core with
+ * the OpenPBS software.  For a copy of the commercial license terms and
+ * conditions, go to: (http://www.pbspro.com/agreement.html) or contact the
+ * Altair Legal Department.
+ *
+ * Altair's dual-license business model allows companies, individuals, and
+ * organizations to create proprietary derivative works of OpenPBS and
+ * distribute them - whether embedded or bundled with other software -
+ * under a commercial license agreement.
+ *
+ * Use of Altair's trademarks, including but not limited to "PBS™",
+ * "OpenPBS®", "PBS Professional®", and "PBS Pro™" and Altair's logos is
+ * subject to Altair's trademark licensing policies.
+ */
+
+/**
+ * @file	pbs_sched_replay.cpp
+ *
+ * @brief
+ *	Offline scheduler benchmark.  With -C the batch status the scheduler
+ *	queries each cycle (server, scheduler, queues, vnodes, reservations,
+ *	resource definitions and jobs) is captured from a live server into a
+ *	file.  Without -C such a capture is loaded and scheduling cycles are
+ *	run against it with the IFL calls of the scheduler redirected to the
+ *	capture: stat calls are answered from it and run, preempt, alter and
+ *	other requests are recorded instead of being sent.  Every cycle starts
+ *	from the same captured universe at the captured time, so runs are
+ *	deterministic and need no server or network.
+ *
+ *	The sched_config, resource_group, usage and other files are read from
+ *	the sched_priv directory given with -d, e.g. one saved by pbs_snapshot.
+ *	The cycles run in a private copy of that directory which is removed
+ *	on exit, so the fairshare usage, metrics and other files the cycles
+ *	write never change the snapshot and every run starts from it again.
+ */
+#include <pbs_config.h> /* the master config generated by configure */
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "attribute.h"
+#include "cycle_profile.h"
+#include "fifo.h"
+#include "globals.h"
+#include "libpbs.h"
+#include "libutil.h"
+#include "log.h"
+#include "pbs_error.h"
+#include "pbs_ifl.h"
+#include "pbs_version.h"
+#include "resource.h"
+#include "sched_cmds.h"
+
+#define REPLAY_MAGIC "# pbs_sched_replay capture"
+#define REPLAY_SD 0 /* connection handle handed to the scheduler code */
+
+static const char usage[] =
+	"-C capture_file [-s server]\n"
+	"       pbs_sched_replay -f capture_file -d sched_priv [-n cycles] [-o actions_file] [-L logfile] [-t threads]";
+
+/* the captured universe */
+static struct {
+	time_t time;
+	struct batch_status *server;
+	struct batch_status *sched;
+	struct batch_status *queue;
+	struct batch_status *vnode;
+	struct batch_status *resv;
+	struct batch_status *resource;
+	struct batch_status *job;
+} capture;
+
+static FILE *actions_fp = NULL; /* where requests the scheduler makes are recorded */
+static int cur_cycle = 0;	/* cycle being replayed */
+static int num_run = 0;		/* jobs run in the current cycle */
+static int num_preempt = 0;	/* jobs preempted in the current cycle */
+static char preempt_method = 'S'; /* how preempted jobs are reported to be preempted */
+
+/**
+ * @brief	write a string to a capture file escaping the characters which
+ *		delimit fields and records
+ *
+ * @param[in]	fp - capture file
+ * @param[in]	str - string to write, NULL is written as an empty string
+ *
+ * @return void
+ */
+static void
+write_escaped(FILE *fp, const char *str)
+{
+	if (str == NULL)
+		return;
+
+	for (; *str != '\0'; str++) {
+		switch (*str) {
+			case '\\':
+				fputs("\\\\", fp);
+				break;
+			case '\t':
+				fputs("\\t", fp);
+				break;
+			case '\n':
+				fputs("\\n", fp);
+				break;
+			default:
+				fputc(*str, fp);
+		}
+	}
+}
+
+/**
+ * @brief	undo write_escaped() in place
+ *
+ * @param[in,out]	str - string to unescape
+ *
+ * @return void
+ */
+static void
+unescape(char *str)
+{
+	char *out = str;
+
+	for (; *str != '\0'; str++) {
+		if (*str == '\\' && str[1] != '\0') {
+			str++;
+			if (*str == 't')
+				*out++ = '\t';
+			else if (*str == 'n')
+				*out++ = '\n';
+			else
+				*out++ = *str;
+		} else
+			*out++ = *str;
+	}
+	*out = '\0';
+}
+
+/**
+ * @brief	write one batch status list to a capture file
+ *
+ *	Each object is a line "<type><TAB><name>" followed by a line
+ *	"<TAB><attribute><TAB><resource><TAB><value>" per attribute.
+ *
+ * @param[in]	fp - capture file
+ * @param[in]	type - object type the list is recorded under
+ * @param[in]	bs - batch status list, freed here
+ *
+ * @return	int
+ * @retval	number of objects written
+ */
+static int
+write_section(FILE *fp, const char *type, struct batch_status *bs)
+{
+	int count = 0;
+
+	for (auto cur = bs; cur != NULL; cur = cur->next) {
+		fprintf(fp, "%s\t", type);
+		write_escaped(fp, cur->name);
+		fputc('\n', fp);
+		for (auto attr = cur->attribs; attr != NULL; attr = attr->next) {
+			fputc('\t', fp);
+			write_escaped(fp, attr->name);
+			fputc('\t', fp);
+			write_escaped(fp, attr->resource);
+			fputc('\t', fp);
+			write_escaped(fp, attr->value);
+			fputc('\n', fp);
+		}
+		count++;
+	}
+	pbs_statfree(bs);
+
+	return count;
+}
+
+/**
+ * @brief	capture what the scheduler queries from a server into a file
+ *
+ * @param[in]	server - server to connect to, NULL for the default
+ * @param[in]	file - capture file to create
+ *
+ * @return	int
+ * @retval	0 on success
+ * @retval	1 on failure
+ */
+static int
+capture_universe(char *server, const char *file)
+{
+	int sd;
+	FILE *fp;
+	int njobs;
+
+	if ((sd = pbs_connect(server)) < 0) {
+		fprintf(stderr, "Unable to connect to server %s: %s\n",
+			server ? server : pbs_server, pbs_errno ? pbse_to_txt(pbs_errno) : "");
+		return 1;
+	}
+
+	if ((fp = fopen(file, "w")) == NULL) {
+		perror(file);
+		pbs_disconnect(sd);
+		return 1;
+	}
+
+	fprintf(fp, "%s\n@time\t%ld\n", REPLAY_MAGIC, (long) time(NULL));
+	write_section(fp, "server", pbs_statserver(sd, NULL, NULL));
+	write_section(fp, "sched", pbs_statsched(sd, NULL, NULL));
+	write_section(fp, "resource", pbs_statrsc(sd, NULL, NULL, const_cast<char *>("p")));
+	write_section(fp, "queue", pbs_statque(sd, NULL, NULL, NULL));
+	write_section(fp, "vnode", pbs_statvnode(sd, NULL, NULL, NULL));
+	write_section(fp, "resv", pbs_statresv(sd, NULL, NULL, NULL));
+	njobs = write_section(fp, "job", pbs_selstat(sd, NULL, NULL, const_cast<char *>("S")));
+
+	pbs_disconnect(sd);
+	if (fclose(fp) != 0) {
+		perror(file);
+		return 1;
+	}
+	printf("captured %d jobs to %s\n", njobs, file);
+
+	return 0;
+}
+
+/**
+ * @brief	read a capture file written by capture_universe()
+ *
+ * @param[in]	file - capture file
+ *
+ * @return	int
+ * @retval	0 on success
+ * @retval	1 on failure
+ */
+static int
+load_capture(const char *file)
+{
+	FILE *fp;
+	char *buf = NULL;
+	int bufsize = 0;
+	int lineno = 0;
+	struct batch_status **head;		/* list for the type of object read */
+	struct batch_status **section = NULL;	/* list objects are being added to */
+	struct batch_status **tail = NULL;	/* where the next object of the list goes */
+	struct attrl **atail = NULL;		/* where the next attribute of the object goes */
+
+	if ((fp = fopen(file, "r")) == NULL) {
+		perror(file);
+		return 1;
+	}
+
+	while (pbs_fgets(&buf, &bufsize, fp) != NULL) {
+		char *fields[3];
+		char *p;
+		int i;
+
+		lineno++;
+		buf[strcspn(buf, "\n")] = '\0';
+
+		if (lineno == 1) {
+			if (strcmp(buf, REPLAY_MAGIC) != 0)
+				goto bad;
+			continue;
+		}
+		if (buf[0] == '\0' || buf[0] == '#')
+			continue;
+
+		if (buf[0] != '\t') {
+			struct batch_status *bs;
+
+			if ((p = strchr(buf, '\t')) == NULL)
+				goto bad;
+			*p++ = '\0';
+
+			if (strcmp(buf, "@time") == 0) {
+				capture.time = strtol(p, NULL, 10);
+				continue;
+			}
+
+			if (strcmp(buf, "server") == 0)
+				head = &capture.server;
+			else if (strcmp(buf, "sched") == 0)
+				head = &capture.sched;
+			else if (strcmp(buf, "resource") == 0)
+				head = &capture.resource;
+			else if (strcmp(buf, "queue") == 0)
+				head = &capture.queue;
+			else if (strcmp(buf, "vnode") == 0)
+				head = &capture.vnode;
+			else if (strcmp(buf, "resv") == 0)
+				head = &capture.resv;
+			else if (strcmp(buf, "job") == 0)
+				head = &capture.job;
+			else
+				goto bad;
+			if (head != section) {
+				/* objects of a type normally come together, find the end only on a switch */
+				section = head;
+				for (tail = head; *tail != NULL; tail = &(*tail)->next)
+					;
+			}
+
+			if ((bs = static_cast<struct batch_status *>(calloc(1, sizeof(struct batch_status)))) == NULL)
+				goto nomem;
+			unescape(p);
+			if ((bs->name = strdup(p)) == NULL) {
+				free(bs);
+				goto nomem;
+			}
+			*tail = bs;
+			tail = &bs->next;
+			atail = &bs->attribs;
+			continue;
+		}
+
+		if (atail == NULL)
+			goto bad;
+
+		p = buf + 1;
+		for (i = 0; i < 3; i++) {
+			fields[i] = p;
+			if (i < 2) {
+				if ((p = strchr(p, '\t')) == NULL)
+					goto bad;
+				*p++ = '\0';
+			}
+			unescape(fields[i]);
+		}
+
+		if ((*atail = new_attrl()) == NULL)
+			goto nomem;
+		(*atail)->name = strdup(fields[0]);
+		if (fields[1][0] != '\0')
+			(*atail)->resource = strdup(fields[1]);
+		(*atail)->value = strdup(fields[2]);
+		if ((*atail)->name == NULL || (*atail)->value == NULL)
+			goto nomem;
+		atail = &(*atail)->next;
+	}
+
+	free(buf);
+	fclose(fp);
+
+	if (lineno == 0) {
+		fprintf(stderr, "%s: empty capture file\n", file);
+		return 1;
+	}
+	return 0;
+
+bad:
+	fprintf(stderr, "%s: line %d: not a pbs_sched_replay capture\n", file, lineno);
+	free(buf);
+	fclose(fp);
+	return 1;
+
+nomem:
+	fprintf(stderr, "%s: out of memory\n", file);
+	free(buf);
+	fclose(fp);
+	return 1;
+}
+
+/**
+ * @brief	find the value of an attribute in an attribute list
+ *
+ * @param[in]	attribs - attribute list
+ * @param[in]	name - attribute name
+ * @param[in]	resource - resource name or NULL
+ *
+ * @return	char *
+ * @retval	value of the attribute
+ * @retval	NULL if the attribute is not in the list
+ */
+static char *
+find_value(struct attrl *attribs, const char *name, const char *resource)
+{
+	for (; attribs != NULL; attribs = attribs->next) {
+		if (strcmp(attribs->name, name) != 0)
+			continue;
+		if (resource == NULL || *resource == '\0') {
+			if (attribs->resource == NULL)
+				return attribs->value;
+		} else if (attribs->resource != NULL && strcmp(attribs->resource, resource) == 0)
+			return attribs->value;
+	}
+
+	return NULL;
+}
+
+/**
+ * @brief	copy captured objects the way a server would return them
+ *
+ * @param[in]	bs - captured list
+ * @param[in]	id - name of the object to return, NULL or "" for all
+ * @param[in]	criteria - selection criteria (pbs_selstat), or NULL
+ * @param[in]	rattrib - attributes to return, NULL for all
+ *
+ * @return	struct batch_status *
+ * @retval	copy of the selected objects, freed by pbs_statfree()
+ * @retval	NULL if none matched or out of memory (pbs_errno set)
+ */
+static struct batch_status *
+replay_stat(struct batch_status *bs, const char *id, struct attropl *criteria, struct attrl *rattrib)
+{
+	struct batch_status *head = NULL;
+	struct batch_status **tail = &head;
+	std::unordered_set<std::string> wanted;
+
+	pbs_errno = PBSE_NONE;
+
+	for (auto ra = rattrib; ra != NULL; ra = ra->next)
+		wanted.insert(ra->name);
+
+	for (; bs != NULL; bs = bs->next) {
+		struct batch_status *nbs;
+		struct attrl **atail;
+		bool match = true;
+
+		if (id != NULL && *id != '\0' && strcmp(bs->name, id) != 0)
+			continue;
+
+		for (auto c = criteria; c != NULL && match; c = c->next) {
+			/* selecting on the destination means the queue the job is in */
+			const char *name = strcmp(c->name, ATTR_q) == 0 ? ATTR_queue : c->name;
+			char *val = find_value(bs->attribs, name, c->resource);
+			bool eq = val != NULL && c->value != NULL && strcmp(val, c->value) == 0;
+
+			if ((c->op == EQ && !eq) || (c->op == NE && eq))
+				match = false;
+		}
+		if (!match)
+			continue;
+
+		if ((nbs = static_cast<struct batch_status *>(calloc(1, sizeof(struct batch_status)))) == NULL)
+			goto nomem;
+		*tail = nbs;
+		tail = &nbs->next;
+		if ((nbs->name = strdup(bs->name)) == NULL)
+			goto nomem;
+
+		atail = &nbs->attribs;
+		for (auto attr = bs->attribs; attr != NULL; attr = attr->next) {
+			if (!wanted.empty() && wanted.find(attr->name) == wanted.end())
+				continue;
+			if ((*atail = dup_attrl(attr)) == NULL)
+				goto nomem;
+			atail = &(*atail)->next;
+		}
+	}
+
+	return head;
+
+nomem:
+	pbs_statfree(head);
+	pbs_errno = PBSE_SYSTEM;
+	return NULL;
+}
+
+/*
+ * Replacements for the IFL calls made by the scheduler.  The connection
+ * handle is ignored, there is only the capture to talk to.
+ */
+
+static struct batch_status *
+replay_statserver(int c, struct attrl *attrib, char *extend)
+{
+	return replay_stat(capture.server, NULL, NULL, attrib);
+}
+
+static struct batch_status *
+replay_statsched(int c, struct attrl *attrib, char *extend)
+{
+	return replay_stat(capture.sched, NULL, NULL, attrib);
+}
+
+static struct batch_status *
+replay_statrsc(int c, char *id, struct attrl *attrib, char *extend)
+{
+	return replay_stat(capture.resource, id, NULL, attrib);
+}
+
+static struct batch_status *
+replay_statque(int c, char *id, struct attrl *attrib, char *extend)
+{
+	return replay_stat(capture.queue, id, NULL, attrib);
+}
+
+static struct batch_status *
+replay_statvnode(int c, char *id, struct attrl *attrib, char *extend)
+{
+	return replay_stat(capture.vnode, id, NULL, attrib);
+}
+
+static struct batch_status *
+replay_statresv(int c, char *id, struct attrl *attrib, char *extend)
+{
+	return replay_stat(capture.resv, id, NULL, attrib);
+}
+
+static struct batch_status *
+replay_selstat(int c, struct attropl *attrib, struct attrl *rattrib, char *extend)
+{
+	return replay_stat(capture.job, NULL, attrib, rattrib);
+}
+
+static char *
+replay_geterrmsg(int c)
+{
+	return NULL;
+}
+
+/**
+ * @brief	record a request the scheduler made in the actions file
+ *
+ * @param[in]	fmt - printf style format of the request
+ *
+ * @return void
+ */
+static void
+record(const char *fmt, ...)
+{
+	va_list ap;
+
+	pbs_errno = PBSE_NONE;
+	if (actions_fp == NULL)
+		return;
+
+	fprintf(actions_fp, "%d ", cur_cycle);
+	va_start(ap, fmt);
+	vfprintf(actions_fp, fmt, ap);
+	va_end(ap);
+	fputc('\n', actions_fp);
+}
+
+static int
+replay_runjob(int c, char *jobid, char *location, char *extend)
+{
+	num_run++;
+	record("run %s %s", jobid, location ? location : "");
+	return 0;
+}
+
+static struct batch_deljob_status *
+replay_runjoblist(int c, char **jobids, char **locations, int numjids, char *extend)
+{
+	for (int i = 0; i < numjids; i++)
+		replay_runjob(c, jobids[i], locations[i], extend);
+	pbs_errno = PBSE_NONE;
+	return NULL;
+}
+
+static int
+replay_alterjob(int c, char *jobid, struct attrl *attrib, char *extend)
+{
+	for (; attrib != NULL; attrib = attrib->next)
+		record("alter %s %s%s%s=%s", jobid, attrib->name,
+		       attrib->resource ? "." : "", attrib->resource ? attrib->resource : "",
+		       attrib->value ? attrib->value : "");
+	return 0;
+}
+
+static int
+replay_sigjob(int c, char *jobid, char *sig, char *extend)
+{
+	record("signal %s %s", jobid, sig);
+	return 0;
+}
+
+static int
+replay_movejob(int c, char *jobid, char *destin, char *extend)
+{
+	record("move %s %s", jobid, destin ? destin : "");
+	return 0;
+}
+
+static int
+replay_confirmresv(int c, char *resvid, char *location, unsigned long start, char *extend)
+{
+	record("confirm %s %lu %s", resvid, start, location ? location : "");
+	return 0;
+}
+
+static int
+replay_manager(int c, int command, int objtype, char *objname, struct attropl *attrib, char *extend)
+{
+	record("manager %d %d %s", command, objtype, objname ? objname : "");
+	return 0;
+}
+
+static preempt_job_info *
+replay_preempt_jobs(int c, char **preempt_jobs_list)
+{
+	preempt_job_info *reply;
+	int count = 0;
+
+	while (preempt_jobs_list[count] != NULL)
+		count++;
+
+	if ((reply = static_cast<preempt_job_info *>(calloc(count + 1, sizeof(preempt_job_info)))) == NULL) {
+		pbs_errno = PBSE_SYSTEM;
+		return NULL;
+	}
+
+	for (int i = 0; i < count; i++) {
+		pbs_strncpy(reply[i].job_id, preempt_jobs_list[i], sizeof(reply[i].job_id));
+		reply[i].order[0] = preempt_method;
+		num_preempt++;
+		record("preempt %s %c", preempt_jobs_list[i], preempt_method);
+	}
+
+	return reply;
+}
+
+/**
+ * @brief	point the IFL calls the scheduler makes at the capture
+ *
+ * @return void
+ */
+static void
+redirect_ifl(void)
+{
+	pfn_pbs_statserver = replay_statserver;
+	pfn_pbs_statsched = replay_statsched;
+	pfn_pbs_statrsc = replay_statrsc;
+	pfn_pbs_statque = replay_statque;
+	pfn_pbs_statvnode = replay_statvnode;
+	pfn_pbs_statresv = replay_statresv;
+	pfn_pbs_selstat = replay_selstat;
+	pfn_pbs_geterrmsg = replay_geterrmsg;
+	pfn_pbs_runjob = replay_runjob;
+	pfn_pbs_asyrunjob = replay_runjob;
+	pfn_pbs_asyrunjob_ack = replay_runjob;
+	pfn_pbs_runjoblist = replay_runjoblist;
+	pfn_pbs_asyalterjob = replay_alterjob;
+	pfn_pbs_sigjob = replay_sigjob;
+	pfn_pbs_movejob = replay_movejob;
+	pfn_pbs_confirmresv = replay_confirmresv;
+	pfn_pbs_manager = replay_manager;
+	pfn_pbs_preempt_jobs = replay_preempt_jobs;
+}
+
+/**
+ * @brief	remove a temporary directory made by copy_priv_dir() and the
+ *		files in it
+ *
+ * @param[in]	path - directory to remove
+ *
+ * @return void
+ */
+static void
+remove_priv_dir(const std::string& path)
+{
+	struct dirent *de;
+	DIR *dir;
+
+	if ((dir = opendir(path.c_str())) != NULL) {
+		while ((de = readdir(dir)) != NULL)
+			if (strcmp(de->d_name, ".") != 0 && strcmp(de->d_name, "..") != 0)
+				unlink((path + "/" + de->d_name).c_str());
+		closedir(dir);
+	}
+	rmdir(path.c_str());
+}
+
+/**
+ * @brief	copy the regular files of a sched_priv directory into a new
+ *		temporary directory
+ *
+ * @param[in]	src - sched_priv directory to copy
+ *
+ * @return	std::string
+ * @retval	path of the temporary directory
+ * @retval	empty string on failure
+ */
+static std::string
+copy_priv_dir(const char *src)
+{
+	const char *tmpdir = getenv("TMPDIR");
+	std::string dst = std::string(tmpdir != NULL ? tmpdir : "/tmp") + "/pbs_sched_replay.XXXXXX";
+	std::vector<char> buf(dst.begin(), dst.end());
+	char data[BUFSIZ];
+	struct dirent *de;
+	struct stat sb;
+	DIR *dir;
+	int err = 0;
+
+	buf.push_back('\0');
+	if (mkdtemp(buf.data()) == NULL) {
+		perror(dst.c_str());
+		return "";
+	}
+	dst = buf.data();
+
+	if ((dir = opendir(src)) == NULL) {
+		perror(src);
+		rmdir(dst.c_str());
+		return "";
+	}
+	while (!err && (de = readdir(dir)) != NULL) {
+		std::string from = std::string(src) + "/" + de->d_name;
+		std::string to = dst + "/" + de->d_name;
+		int ifd, ofd;
+		ssize_t n = 0;
+
+		if (stat(from.c_str(), &sb) == -1 || !S_ISREG(sb.st_mode))
+			continue;
+		if ((ifd = open(from.c_str(), O_RDONLY)) == -1) {
+			perror(from.c_str());
+			err = 1;
+			break;
+		}
+		if ((ofd = open(to.c_str(), O_WRONLY | O_CREAT | O_EXCL, sb.st_mode & 0777)) == -1) {
+			perror(to.c_str());
+			close(ifd);
+			err = 1;
+			break;
+		}
+		while ((n = read(ifd, data, sizeof(data))) > 0)
+			if (write(ofd, data, n) != n) {
+				n = -1;
+				break;
+			}
+		if (close(ofd) != 0)
+			n = -1;
+		if (n < 0) {
+			perror(to.c_str());
+			err = 1;
+		}
+		close(ifd);
+	}
+	closedir(dir);
+
+	if (err) {
+		remove_priv_dir(dst);
+		return "";
+	}
+	return dst;
+}
+
+/**
+ * @brief	run scheduling cycles against a capture and report their times
+ *
+ * @param[in]	ncycles - number of cycles to run
+ *
+ * @return	int
+ * @retval	0 on success
+ * @retval	1 on failure
+ */
+static int
+replay_cycles(int ncycles)
+{
+	sched_cmd cmd = {SCH_SCHEDULE_NEW, NULL};
+	std::vector<double> times;
+	double total = 0;
+	struct batch_status *ss;
+	char *order;
+
+	if ((ss = bs_find(capture.sched, sc_name)) != NULL &&
+	    (order = find_value(ss->attribs, ATTR_sched_preempt_order, NULL)) != NULL &&
+	    strchr("SCRD", order[0]) != NULL)
+		preempt_method = order[0] == 'R' ? 'Q' : order[0];
+
+	fixed_cycle_time = capture.time;
+
+	if (!update_resource_defs(REPLAY_SD)) {
+		fprintf(stderr, "Unable to load resource definitions from the capture\n");
+		return 1;
+	}
+	if (!set_validate_sched_attrs(REPLAY_SD)) {
+		fprintf(stderr, "Scheduler %s not found in the capture\n", sc_name);
+		return 1;
+	}
+
+	for (cur_cycle = 1; cur_cycle <= ncycles; cur_cycle++) {
+		num_run = num_preempt = 0;
+
+		auto start = std::chrono::steady_clock::now();
+		profile_cycle_start();
+		scheduling_cycle(REPLAY_SD, &cmd);
+		profile_cycle_end();
+		std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+		times.push_back(elapsed.count());
+		total += elapsed.count();
+		printf("cycle %d: %.3f secs, %d jobs run, %d jobs preempted\n",
+		       cur_cycle, elapsed.count(), num_run, num_preempt);
+		for (int i = 0; i < PHASE_HIGH; i++) {
+			auto& ps = get_phase_stat(static_cast<enum sched_phase>(i));
+			printf("\t%-14s %10.3f secs %8ld calls\n",
+			       phase_name(static_cast<enum sched_phase>(i)), ps.secs, ps.count);
+		}
+	}
+
+	std::sort(times.begin(), times.end());
+	printf("%d cycles: min %.3f median %.3f max %.3f mean %.3f secs\n",
+	       ncycles, times.front(), times[times.size() / 2], times.back(), total / ncycles);
+
+	return 0;
+}
+
+int
+main(int argc, char *argv[])
+{
+	int c;
+	int errflg = 0;
+	char *capture_out = NULL;
+	char *capture_in = NULL;
+	char *server = NULL;
+	char *priv_dir = NULL;
+	char *actions_file = NULL;
+	std::string work_dir;
+	std::string log_path;
+	int ncycles = 1;
+	int nthreads = -1;
+	int rc;
+
+	PRINT_VERSION_AND_EXIT(argc, argv);
+
+	if (set_msgdaemonname(const_cast<char *>("pbs_sched_replay"))) {
+		fprintf(stderr, "Out of memory\n");
+		return 1;
+	}
+
+	while ((c = getopt(argc, argv, "C:s:f:d:n:o:L:t:")) != EOF) {
+		switch (c) {
+			case 'C':
+				capture_out = optarg;
+				break;
+			case 's':
+				server = optarg;
+				break;
+			case 'f':
+				capture_in = optarg;
+				break;
+			case 'd':
+				priv_dir = optarg;
+				break;
+			case 'n':
+				ncycles = atoi(optarg);
+				if (ncycles < 1)
+					errflg = 1;
+				break;
+			case 'o':
+				actions_file = optarg;
+				break;
+			case 'L':
+				logfile = optarg;
+				break;
+			case 't':
+				nthreads = atoi(optarg);
+				if (nthreads < 1)
+					errflg = 1;
+				break;
+			default:
+				errflg = 1;
+		}
+	}
+
+	if (errflg || optind != argc || (capture_out == NULL) == (capture_in == NULL) ||
+	    (capture_in != NULL && priv_dir == NULL)) {
+		fprintf(stderr, "usage: %s %s\n", argv[0], usage);
+		fprintf(stderr, "       %s --version\n", argv[0]);
+		return 1;
+	}
+
+	if (pbs_loadconf(0) == 0) {
+		fprintf(stderr, "%s: unable to read the PBS configuration\n", argv[0]);
+		return 1;
+	}
+
+	if (pbs_client_thread_init_thread_context() != 0) {
+		fprintf(stderr, "%s: unable to initialize thread context\n", argv[0]);
+		return 1;
+	}
+
+	if (capture_out != NULL)
+		return capture_universe(server, capture_out);
+
+	if (load_capture(capture_in) != 0)
+		return 1;
+
+	if (actions_file != NULL && (actions_fp = fopen(actions_file, "w")) == NULL) {
+		perror(actions_file);
+		return 1;
+	}
+
+	if (logfile != NULL && logfile[0] != '/') {
+		char cwd[MAXPATHLEN + 1];
+
+		if (getcwd(cwd, sizeof(cwd)) == NULL) {
+			perror("getcwd");
+			return 1;
+		}
+		log_path = std::string(cwd) + "/" + logfile;
+		logfile = const_cast<char *>(log_path.c_str());
+	}
+
+	/* run in a copy so nothing the cycles write lands in the snapshot */
+	work_dir = copy_priv_dir(priv_dir);
+	if (work_dir.empty())
+		return 1;
+	if (chdir(work_dir.c_str()) == -1) {
+		perror(work_dir.c_str());
+		remove_priv_dir(work_dir);
+		return 1;
+	}
+
+	if (logfile != NULL && log_open(logfile, path_log) == -1) {
+		fprintf(stderr, "%s: logfile could not be opened\n", argv[0]);
+		remove_priv_dir(work_dir);
+		return 1;
+	}
+
+	sc_name = PBS_DFLT_SCHED_NAME;
+	dflt_sched = 1;
+	redirect_ifl();
+
+	if (schedinit(nthreads) != 0) {
+		fprintf(stderr, "%s: scheduler initialization failed\n", argv[0]);
+		remove_priv_dir(work_dir);
+		return 1;
+	}
+
+	rc = replay_cycles(ncycles);
+
+	if (actions_fp != NULL)
+		fclose(actions_fp);
+	log_close(1);
+	remove_priv_dir(work_dir);
+
+	return rc;
+}
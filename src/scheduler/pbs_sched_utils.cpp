@@ -157,6 +157,7 @@ on_segv(int sig)
 	if ((segv_last_time - segv_start_time) < 300) {
 		log_record(PBSEVENT_SYSTEM, PBS_EVENTCLASS_SERVER, LOG_INFO, __func__,
 			   "received a sigsegv within 5 minutes of start: aborting.");
+		log_async_flush();
 
 		/* Not unlocking mutex on purpose, we need to hold on to it until the process is killed */
 		abort();
@@ -164,6 +165,7 @@ on_segv(int sig)
 
 	log_record(PBSEVENT_SYSTEM, PBS_EVENTCLASS_SERVER, LOG_INFO, __func__,
 		   "received segv and restarting");
+	log_async_flush();
 
 	if (fork() > 0) {  /* the parent rexec's itself */
 		sleep(10); /* allow the child to die */
@@ -1198,6 +1200,11 @@ sched_main(int argc, char *argv[], schedule_func sched_ptr)
 #endif
 	pid = getpid();
 	daemon_protect(0, PBS_DAEMON_PROTECT_ON);
+
+	/* in the background now, so the log writer thread stays with us */
+	if (pbs_conf.pbs_log_async && (log_set_async(1) != 0))
+		log_err(-1, msg_daemonname, "unable to start log writer thread, logging synchronously");
+
 	freopen("/dev/null", "r", stdin);
 
 	/* write schedulers pid into lockfile */
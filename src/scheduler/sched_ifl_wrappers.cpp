@@ -40,6 +40,9 @@
 #include <pbs_config.h>
 
 #include <stdlib.h>
+#include <algorithm>
+#include <string>
+#include <vector>
 #include <pbs_ifl.h>
 #include <libpbs.h>
 #include "data_types.h"
@@ -49,6 +52,7 @@
 #include "misc.h"
 #include "log.h"
 #include "server_info.h"
+#include "cycle_profile.h"
 
 
 /**
@@ -75,9 +79,22 @@ handle_part_tolerance(void *ret)
 	return ret;
 }
 
+/* an asynchronous run waiting in send_run_job() to go out in a RunJobList */
+struct queued_run {
+	int sd;			/* instance sd of the job's server */
+	std::string jobid;
+	std::string execvnode;
+};
+
+static std::vector<queued_run> queued_runs;
+
 /**
  * @brief	Send the relevant runjob request to server
  *
+ * @par	In RJ_NOWAIT mode nothing waits on the result of the run, so the
+ *	run is only queued and goes out with others in one RunJobList
+ *	request, see send_run_job_list().
+ *
  * @param[in]	virtual_sd	-	virtual sd for the cluster
  * @param[in]	has_runjob_hook	- does server have a runjob hook?
  * @param[in]	jobid	-	id of the job to run
@@ -97,12 +114,77 @@ send_run_job(int virtual_sd, int has_runjob_hook, const std::string& jobid, char
 
 	job_owner_sd = get_svr_inst_fd(virtual_sd, svr_id_job);
 
-	if (sc_attrs.runjob_mode == RJ_EXECJOB_HOOK)
+	if (sc_attrs.runjob_mode == RJ_EXECJOB_HOOK) {
+		phase_timer timer(PHASE_RUN_REQUEST);
 		return pbs_runjob(job_owner_sd, const_cast<char *>(jobid.c_str()), execvnode, NULL);
-	else if (((sc_attrs.runjob_mode == RJ_RUNJOB_HOOK) && has_runjob_hook))
+	} else if (((sc_attrs.runjob_mode == RJ_RUNJOB_HOOK) && has_runjob_hook)) {
+		phase_timer timer(PHASE_RUN_REQUEST);
 		return pbs_asyrunjob_ack(job_owner_sd, const_cast<char *>(jobid.c_str()), execvnode, NULL);
-	else
-		return pbs_asyrunjob(job_owner_sd, const_cast<char *>(jobid.c_str()), execvnode, NULL);
+	}
+
+	queued_runs.push_back({job_owner_sd, jobid, execvnode});
+	if (queued_runs.size() >= MAX_RUNJOB_LIST)
+		send_run_job_list();
+
+	return 0;
+}
+
+/**
+ * @brief	Send the runs queued by send_run_job(), one RunJobList
+ *		request per server.  Must be called before anything that
+ *		expects those jobs to be running on the server, and at the
+ *		end of the cycle.
+ *
+ * @return	int
+ * @retval	number of jobs the server(s) could not run
+ */
+int
+send_run_job_list(void)
+{
+	int nfailed = 0;
+
+	if (queued_runs.empty())
+		return 0;
+
+	phase_timer timer(PHASE_RUN_REQUEST);
+
+	while (!queued_runs.empty()) {
+		int sd = queued_runs.front().sd;
+		std::vector<char *> jobids;
+		std::vector<char *> execvnodes;
+		struct batch_deljob_status *failed;
+
+		for (auto& qr : queued_runs) {
+			if (qr.sd == sd) {
+				jobids.push_back(const_cast<char *>(qr.jobid.c_str()));
+				execvnodes.push_back(const_cast<char *>(qr.execvnode.c_str()));
+			}
+		}
+
+		failed = pbs_runjoblist(sd, jobids.data(), execvnodes.data(), jobids.size(), NULL);
+		if (failed == NULL && pbs_errno != PBSE_NONE) {
+			const char *errbuf = pbs_geterrmsg(sd);
+
+			log_eventf(PBSEVENT_SCHED, PBS_EVENTCLASS_SCHED, LOG_WARNING, __func__,
+				   "Failed to send %d run requests: %s (%d)",
+				   static_cast<int>(jobids.size()), errbuf ? errbuf : "", pbs_errno);
+			nfailed += jobids.size();
+		}
+		for (auto pdel = failed; pdel != NULL; pdel = pdel->next) {
+			const char *errtxt = pbse_to_txt(pdel->code);
+
+			log_eventf(PBSEVENT_SCHED, PBS_EVENTCLASS_JOB, LOG_WARNING, pdel->name,
+				   "Run request failed: %s (%d)", errtxt ? errtxt : "", pdel->code);
+			nfailed++;
+		}
+		pbs_delstatfree(failed);
+
+		queued_runs.erase(std::remove_if(queued_runs.begin(), queued_runs.end(),
+						 [sd](const queued_run& qr) { return qr.sd == sd; }),
+				  queued_runs.end());
+	}
+
+	return nfailed;
 }
 
 /**
@@ -179,6 +261,9 @@ send_preempt_jobs(int virtual_sd, char **preempt_jobs_list)
 {
 	preempt_job_info *ret;
 
+	/* the jobs being preempted may have been started this cycle */
+	send_run_job_list();
+
     ret = pbs_preempt_jobs(virtual_sd, preempt_jobs_list);
 
 	if (handle_part_tolerance(ret) == NULL) {
@@ -205,6 +290,8 @@ send_sigjob(int virtual_sd, resource_resv *resresv, const char *signal, char *ex
 {
 	int ret = 0;
 
+	send_run_job_list();
+
 	ret = pbs_sigjob(get_svr_inst_fd(virtual_sd, resresv->svr_inst_id),
 			  const_cast<char *>(resresv->name.c_str()), const_cast<char *>(signal), extend);
 
@@ -146,6 +146,7 @@
 #include "check.h"
 #include "fifo.h"
 #include "buckets.h"
+#include "cycle_profile.h"
 #include "parse.h"
 #include "hook.h"
 #include "libpbs.h"
@@ -179,6 +180,7 @@ extern char **environ;
 server_info *
 query_server(status *pol, int pbs_sd)
 {
+	phase_timer timer(PHASE_QUERY);
 	struct batch_status *server;	/* info about the server */
 	struct batch_status *bs_resvs;	/* batch status of the reservations */
 	server_info *sinfo;		/* scheduler internal form of server info */
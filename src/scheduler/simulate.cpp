@@ -57,6 +57,7 @@
  * 	find_timed_event()
  * 	perform_event()
  * 	exists_run_event()
+ * 	earliest_resource_fit()
  * 	calc_run_time()
  * 	create_event_list()
  * 	create_events()
@@ -691,6 +692,100 @@ exists_resv_event(event_list *calendar, time_t end)
 	return 0;
 }
 
+/**
+ * @brief
+ * 		find the earliest time the nodes of the universe could hold the
+ *		consumable resources a queued job requests.  The free amount of
+ *		each resource is summed over all nodes and grown by the resources
+ *		released by each end event in the calendar.  Nothing else in the
+ *		calendar can create node resources, so the job can not possibly
+ *		run before this time.  It is a cheap lower bound which lets
+ *		calc_run_time() skip is_ok_to_run() on the events before it.
+ *
+ * @param[in] sinfo - the server (calendar and nodes)
+ * @param[in] resresv - the job to find the bound for
+ *
+ * @return	time_t
+ * @retval	earliest time the job's resources could be free
+ * @retval	0	: no bound could be found
+ */
+static time_t
+earliest_resource_fit(server_info *sinfo, resource_resv *resresv)
+{
+	std::unordered_map<resdef *, sch_resource_t> need;
+	std::unordered_map<resdef *, sch_resource_t> avail;
+	auto& checklist = sinfo->policy->resdef_to_check;
+
+	if (resresv->select == NULL || sinfo->nodes == NULL)
+		return 0;
+
+	for (int i = 0; resresv->select->chunks[i] != NULL; i++) {
+		chunk *chk = resresv->select->chunks[i];
+		for (resource_req *req = chk->req; req != NULL; req = req->next) {
+			if (req->type.is_consumable && checklist.find(req->def) != checklist.end())
+				need[req->def] += chk->num_chunks * req->amount;
+		}
+	}
+
+	for (auto it = need.begin(); it != need.end();) {
+		bool unbounded = false;
+		sch_resource_t amount = 0;
+
+		for (int i = 0; sinfo->nodes[i] != NULL && !unbounded; i++) {
+			schd_resource *res = find_resource(sinfo->nodes[i]->res, it->first);
+
+			/* unset resources may match as infinite, don't bound on them */
+			if (res == NULL || res->orig_str_avail == NULL)
+				unbounded = true;
+			else {
+				if (res->indirect_res != NULL)
+					res = res->indirect_res;
+				if (res->avail == SCHD_INFINITY_RES)
+					unbounded = true;
+				else if (res->avail > res->assigned)
+					amount += res->avail - res->assigned;
+			}
+		}
+		if (unbounded)
+			it = need.erase(it);
+		else {
+			avail[it->first] = amount;
+			++it;
+		}
+	}
+
+	auto fits = [&need, &avail]() {
+		for (const auto& n : need)
+			if (avail[n.first] < n.second)
+				return false;
+		return true;
+	};
+
+	if (need.empty() || fits())
+		return sinfo->server_time;
+
+	for (auto te = find_init_timed_event(get_next_event(sinfo->calendar), IGNORE_DISABLED_EVENTS, TIMED_END_EVENT);
+		te != NULL; te = find_next_timed_event(te, IGNORE_DISABLED_EVENTS, TIMED_END_EVENT)) {
+		auto eresv = static_cast<resource_resv *>(te->event_ptr);
+
+		if (eresv->nspec_arr != NULL) {
+			for (int i = 0; eresv->nspec_arr[i] != NULL; i++)
+				for (resource_req *req = eresv->nspec_arr[i]->resreq; req != NULL; req = req->next)
+					if (need.find(req->def) != need.end())
+						avail[req->def] += req->amount;
+		} else {
+			for (resource_req *req = eresv->resreq; req != NULL; req = req->next)
+				if (need.find(req->def) != need.end())
+					avail[req->def] += req->amount;
+		}
+
+		if (fits())
+			return te->event_time;
+	}
+
+	return 0;
+}
+
 /**
  * @brief
  * 		calculate the run time of a resresv through simulation of
@@ -724,6 +819,7 @@ calc_run_time(const std::string& name, server_info *sinfo, int flags)
 	nspec **ns = NULL;
 	unsigned int ok_flags = NO_ALLPART;
 	queue_info *qinfo = NULL;
+	time_t fit_time = 0;		/* job can't run before this time */
 
 	if (name.empty() || sinfo == NULL)
 		return (time_t) -1;
@@ -741,6 +837,9 @@ calc_run_time(const std::string& name, server_info *sinfo, int flags)
 	if (resresv->is_job) {
 		ok_flags |= IGNORE_EQUIV_CLASS;
 		qinfo = resresv->job->queue;
+		/* jobs in reservations run on the reservation's nodes */
+		if (resresv->job->is_queued && resresv->job->resv == NULL)
+			fit_time = earliest_resource_fit(sinfo, resresv);
 	}
 
 	err = new_schd_error();
@@ -752,8 +851,10 @@ calc_run_time(const std::string& name, server_info *sinfo, int flags)
 		 * because it's being simulated/updated in simulate_events()
 		 */
 
+		/* no need to check before enough resources have been freed */
 		auto desc = describe_simret(ret);
-		if (desc > 0 || (desc == 0 && policy_change_info(sinfo, resresv))) {
+		if (event_time >= fit_time &&
+			(desc > 0 || (desc == 0 && policy_change_info(sinfo, resresv)))) {
 			clear_schd_error(err);
 			ns = is_ok_to_run(sinfo->policy, sinfo, qinfo, resresv, ok_flags, err);
 		}
@@ -68,6 +68,7 @@
  * 	cmp_node_host()
  * 	cmp_aoe()
  * 	cmp_job_preemption_time_asc()
+ * 	sort_resresv_array_chunk()
  * 	sort_jobs()
  * 	swapfunc()
  * 	med3()
@@ -80,6 +81,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <errno.h>
+#include <pthread.h>
 #include <log.h>
 #include "data_types.h"
 #include "sort.h"
@@ -93,11 +95,15 @@
 #include "constant.h"
 #include "server_info.h"
 #include "resource.h"
+#include "multi_threading.h"
+#include "cycle_profile.h"
 
 #ifdef NAS
 #include "site_code.h"
 #endif
 
+/* true while sort_jobs() is sorting with the keys cached in resource_resv::sort_keys */
+static bool use_sort_keys = false;
 
 
 /**
@@ -507,6 +513,23 @@ multi_sort(resource_resv *r1, resource_resv *r2)
 {
 	int ret = 0;
 
+	if (use_sort_keys && r1 != NULL && r2 != NULL &&
+	    r1->sort_keys.size() == cstat.sort_by->size() &&
+	    r2->sort_keys.size() == cstat.sort_by->size()) {
+		for (size_t i = 0; i < r1->sort_keys.size(); i++) {
+			sch_resource_t v1 = r1->sort_keys[i];
+			sch_resource_t v2 = r2->sort_keys[i];
+
+			if (v1 == v2)
+				continue;
+			if ((*cstat.sort_by)[i].order == ASC)
+				return v1 < v2 ? -1 : 1;
+			else
+				return v1 < v2 ? 1 : -1;
+		}
+		return 0;
+	}
+
 	for (const auto& si : *cstat.sort_by) {
 		ret = resresv_sort_cmp(r1, r2, si);
 		if (ret)
@@ -1180,12 +1203,231 @@ cmp_resv_state(const void *r1, const void *r2)
 		return 0;
 }
 
+/**
+ * @brief
+ *		cache the job_sort_key values of a job so multi_sort() does not
+ *		have to look them up on every comparison
+ *
+ * @param[in,out]	resresv	-	job to cache the keys of
+ *
+ * @return	void
+ */
+static void
+set_sort_keys(resource_resv *resresv)
+{
+	resresv->sort_keys.clear();
+	resresv->sort_keys.reserve(cstat.sort_by->size());
+	for (const auto& si : *cstat.sort_by)
+		resresv->sort_keys.push_back(find_resresv_amount(resresv, si.res_name, si.def));
+}
+
+/**
+ * @brief
+ *		sort a chunk of a job array with cmp_sort()
+ *
+ * @param[in,out]	data	-	data for the chunk to sort
+ *
+ * @return	void
+ */
+void
+sort_resresv_array_chunk(th_data_sort_resresv *data)
+{
+	resource_resv **resresv_arr = data->resresv_arr;
+	int i;
+
+	if (data->set_keys) {
+		for (i = data->sidx; i <= data->eidx; i++)
+			set_sort_keys(resresv_arr[i]);
+	}
+
+	qsort(&resresv_arr[data->sidx], data->eidx - data->sidx + 1,
+		sizeof(resource_resv *), cmp_sort);
+}
+
+/**
+ * @brief
+ *		merge the sorted runs of a job array into one sorted array.
+ *		cmp_sort() is a total order, so the result is the same as
+ *		sorting the whole array in one go.
+ *
+ * @param[in,out]	resresv_arr	-	array to merge
+ * @param[in]		num		-	number of elements in the array
+ * @param[in]		run		-	size of each sorted run (the last may be shorter)
+ *
+ * @return	void
+ */
+static void
+merge_sorted_runs(resource_resv **resresv_arr, int num, int run)
+{
+	resource_resv **buf;
+	resource_resv **src;
+	resource_resv **dst;
+	resource_resv **tmp;
+
+	if (run >= num)
+		return;
+
+	buf = static_cast<resource_resv **>(malloc(num * sizeof(resource_resv *)));
+	if (buf == NULL) {
+		log_err(errno, __func__, MEM_ERR_MSG);
+		qsort(resresv_arr, num, sizeof(resource_resv *), cmp_sort);
+		return;
+	}
+
+	src = resresv_arr;
+	dst = buf;
+	for (; run < num; run *= 2) {
+		for (int lo = 0; lo < num; lo += 2 * run) {
+			int mid = (lo + run < num) ? lo + run : num;
+			int hi = (lo + 2 * run < num) ? lo + 2 * run : num;
+			int i = lo;
+			int j = mid;
+			int k = lo;
+
+			while (i < mid && j < hi) {
+				if (cmp_sort(&src[j], &src[i]) < 0)
+					dst[k++] = src[j++];
+				else
+					dst[k++] = src[i++];
+			}
+			while (i < mid)
+				dst[k++] = src[i++];
+			while (j < hi)
+				dst[k++] = src[j++];
+		}
+		tmp = src;
+		src = dst;
+		dst = tmp;
+	}
+
+	if (src != resresv_arr)
+		memcpy(resresv_arr, src, num * sizeof(resource_resv *));
+	free(buf);
+}
+
+/**
+ * @brief
+ *		sort several job arrays with cmp_sort().  Each array is broken up
+ *		into chunks which are sorted by the worker threads and then merged.
+ *		Chunks of all the arrays are queued together, so small arrays
+ *		(e.g., the jobs of each queue) are sorted concurrently.
+ *
+ * @param[in,out]	arrs		-	job arrays to sort
+ * @param[in]		set_keys	-	cache the job_sort_key values before sorting
+ *
+ * @return	void
+ */
+static void
+sort_resresv_arrays(const std::vector<resource_resv **>& arrs, bool set_keys)
+{
+	std::vector<int> nums;
+	std::vector<int> runs;
+	th_data_sort_resresv *tdata;
+	th_task_info *task;
+	int num_tasks = 0;
+	int tid;
+	int i;
+
+	tid = *((int *) pthread_getspecific(th_id_key));
+	for (const auto& arr : arrs) {
+		th_data_sort_resresv inline_data;
+		int num = count_array(arr);
+		int chunk_size;
+
+		nums.push_back(num);
+		if (num == 0) {
+			runs.push_back(0);
+			continue;
+		}
+
+		if (tid != 0 || num_threads <= 1) {
+			/* don't use multi-threading if I am a worker thread or num_threads is 1 */
+			chunk_size = num;
+		} else {
+			chunk_size = num / num_threads;
+			chunk_size = (chunk_size > MT_CHUNK_SIZE_MIN) ? chunk_size : MT_CHUNK_SIZE_MIN;
+			chunk_size = (chunk_size < MT_CHUNK_SIZE_MAX) ? chunk_size : MT_CHUNK_SIZE_MAX;
+		}
+		runs.push_back(chunk_size);
+
+		for (i = 0; i < num; i += chunk_size) {
+			int eidx = (i + chunk_size < num) ? i + chunk_size - 1 : num - 1;
+
+			tdata = NULL;
+			task = NULL;
+			if (chunk_size < num) {
+				tdata = static_cast<th_data_sort_resresv *>(malloc(sizeof(th_data_sort_resresv)));
+				task = static_cast<th_task_info *>(malloc(sizeof(th_task_info)));
+				if (tdata == NULL || task == NULL) {
+					log_err(errno, __func__, MEM_ERR_MSG);
+					free(tdata);
+					free(task);
+					tdata = NULL;
+				}
+			}
+			if (tdata == NULL) {
+				/* sort this chunk myself */
+				inline_data.set_keys = set_keys;
+				inline_data.resresv_arr = arr;
+				inline_data.sidx = i;
+				inline_data.eidx = eidx;
+				sort_resresv_array_chunk(&inline_data);
+				continue;
+			}
+
+			tdata->set_keys = set_keys;
+			tdata->resresv_arr = arr;
+			tdata->sidx = i;
+			tdata->eidx = eidx;
+			task->task_type = TS_SORT_RESRESV;
+			task->thread_data = (void *) tdata;
+
+			queue_work_for_threads(task);
+			num_tasks++;
+		}
+	}
+
+	/* Get results from worker threads */
+	for (i = 0; i < num_tasks;) {
+		pthread_mutex_lock(&result_lock);
+		while (ds_queue_is_empty(result_queue))
+			pthread_cond_wait(&result_cond, &result_lock);
+		while (!ds_queue_is_empty(result_queue)) {
+			task = static_cast<th_task_info *>(ds_dequeue(result_queue));
+			free(task->thread_data);
+			free(task);
+			i++;
+		}
+		pthread_mutex_unlock(&result_lock);
+	}
+
+	for (size_t j = 0; j < arrs.size(); j++)
+		merge_sorted_runs(arrs[j], nums[j], runs[j]);
+}
+
+/**
+ * @brief
+ *		sort a single job array, see sort_resresv_arrays()
+ *
+ * @param[in,out]	resresv_arr	-	job array to sort
+ * @param[in]		set_keys	-	cache the job_sort_key values before sorting
+ *
+ * @return	void
+ */
+static void
+sort_resresv_array(resource_resv **resresv_arr, bool set_keys)
+{
+	sort_resresv_arrays(std::vector<resource_resv **>(1, resresv_arr), set_keys);
+}
+
 /**
  * @brief
  * 		sort_jobs - This function sorts all jobs according to their preemption
  *      priority, preempted time and fairshare.
  *		sort_jobs is called whenever we need to sort jobs on the basis of
  *		various policies set in scheduler.
+ *		The job_sort_key values are looked up once per job before sorting
+ *		and the sorting itself is spread over the worker threads.
  * @param[in]		policy	-	Policy structure to decide whether to sort for fairshare or
  *                     			not. If yes, then according should it be according to
  *                     			by_queue or round_robin.
@@ -1196,6 +1438,11 @@ cmp_resv_state(const void *r1, const void *r2)
 void
 sort_jobs(status *policy, server_info *sinfo)
 {
+	phase_timer timer(PHASE_SORT);
+	std::vector<resource_resv **> qjobs;
+
+	use_sort_keys = true;
+
 	/** sort jobs in such a way that Higher Priority jobs come on top
 	 * followed by preempted jobs and then normal jobs
 	 */
@@ -1209,11 +1456,10 @@ sort_jobs(status *policy, server_info *sinfo)
 			 * preempted jobs, and fairshare usage
 			 */
 			for (int i = 0; i < sinfo->num_queues; i++) {
-				if (sinfo->queues[i]->sc.total > 0) {
-					qsort(sinfo->queues[i]->jobs, sinfo->queues[i]->sc.total,
-						sizeof(resource_resv*), cmp_sort);
-				}
+				if (sinfo->queues[i]->sc.total > 0)
+					qjobs.push_back(sinfo->queues[i]->jobs);
 			}
+			sort_resresv_arrays(qjobs, true);
 			for (int count = 0; count != sinfo->num_queues; count++) {
 				for (int index = 0; index < sinfo->queues[count]->sc.total; index++) {
 					sinfo->jobs[job_index] = sinfo->queues[count]->jobs[index];
@@ -1224,14 +1470,15 @@ sort_jobs(status *policy, server_info *sinfo)
 		}
 		/** Sort on entire complex **/
 		else if (!policy->by_queue && !policy->round_robin) {
-			qsort(sinfo->jobs, count_array(sinfo->jobs), sizeof(resource_resv *), cmp_sort);
+			sort_resresv_array(sinfo->jobs, true);
 		}
 	}
 	else if (policy->by_queue) {
-		for (int i = 0; i < sinfo->num_queues; i++) {
-			qsort(sinfo->queues[i]->jobs, count_array(sinfo->queues[i]->jobs), sizeof(resource_resv *), cmp_sort);
-		}
-		qsort(sinfo->jobs, count_array(sinfo->jobs), sizeof(resource_resv*), cmp_sort);
+		for (int i = 0; i < sinfo->num_queues; i++)
+			qjobs.push_back(sinfo->queues[i]->jobs);
+		sort_resresv_arrays(qjobs, true);
+		/* every job is in one of the queues, so its keys are already set */
+		sort_resresv_array(sinfo->jobs, false);
 	}
 	else if (policy->round_robin) {
 		if (sinfo -> queue_list != NULL) {
@@ -1240,14 +1487,13 @@ sort_jobs(status *policy, server_info *sinfo)
 			{
 				int queue_index_size = count_array(sinfo->queue_list[i]);
 				for (int j = 0; j < queue_index_size; j++)
-				{
-					qsort(sinfo->queue_list[i][j]->jobs, count_array(sinfo->queue_list[i][j]->jobs),
-						sizeof(resource_resv *), cmp_sort);
-				}
+					qjobs.push_back(sinfo->queue_list[i][j]->jobs);
 			}
-
+			sort_resresv_arrays(qjobs, true);
 		}
 	}
 	else
-		qsort(sinfo->jobs, count_array(sinfo->jobs), sizeof(resource_resv*), cmp_sort);
+		sort_resresv_array(sinfo->jobs, true);
+
+	use_sort_keys = false;
 }
@@ -186,6 +186,11 @@ int cmp_preemption(resource_resv *r1, resource_resv *r2);
  */
 int cmp_resv_state(const void *r1, const void *r2);
 
+/*
+ * sort_resresv_array_chunk - sort a chunk of a job array (worker thread task)
+ */
+void sort_resresv_array_chunk(th_data_sort_resresv *data);
+
 /*
  * sort_jobs - This function sorts all jobs according to their preemption
  *             priority, preempted time and fairshare.
@@ -62,6 +62,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <time.h>
+#include <unistd.h>
 #include "list_link.h"
 #include "attribute.h"
 #include "resource.h"
@@ -72,14 +73,22 @@
 #include "pbs_nodes.h"
 #include "log.h"
 #include "acct.h"
+#include "acct_bin.h"
 #include "pbs_license.h"
 #include "server.h"
 #include "svrfunc.h"
 #include "libutil.h"
+#include "pbs_internal.h"
 
 /* Local Data */
 
 static FILE *acctfile;		/* open stream for log file */
+static FILE *acctbinfile;	/* open stream for binary log file */
+static FILE *acctidxfile;	/* open stream for index of binary log file */
+static long long acctbin_off;	/* offset of the next binary record */
+static long long acctidx_off;	/* offset of the next index entry */
+static char *acctbin_buf = NULL;	/* encode buffer, kept between records */
+static size_t acctbin_bufsz = 0;
 static volatile int acct_opened = 0;
 static int acct_opened_day;
 static int acct_auto_switch = 0;
@@ -904,6 +913,69 @@ acct_resv(resc_resv *presv, char *buf, int len)
 	return (pb);
 }
 
+/**
+ * @brief
+ *	acct_open_bin - open the binary log and its index next to the text
+ *	accounting log, writing their headers if they are new
+ *
+ * @param[in]	filename - pathname of the text accounting log
+ * @param[out]	pbin - open binary log
+ * @param[out]	pidx - open index
+ * @param[out]	poff - offset of the next record in the binary log
+ * @param[out]	pidxoff - offset of the next entry in the index
+ *
+ * @par
+ *	Both files are unbuffered so a failed write leaves nothing behind in
+ *	stdio to be flushed later, and an index left with a partial entry by
+ *	a crash is cut back to whole entries.
+ *
+ * @return	int
+ * @retval	 0  - Success
+ * @retval	-1  - Failure, nothing is left open
+ */
+static int
+acct_open_bin(char *filename, FILE **pbin, FILE **pidx, long long *poff, long long *pidxoff)
+{
+	char path[_POSIX_PATH_MAX];
+	FILE *fp[2];
+	const char *sfx[2] = {ACCT_BIN_SUFFIX, ACCT_IDX_SUFFIX};
+	const char *magic[2] = {ACCT_BIN_MAGIC, ACCT_IDX_MAGIC};
+	long end[2];
+	int i;
+
+	for (i = 0; i < 2; i++) {
+		snprintf(path, sizeof(path), "%s%s", filename, sfx[i]);
+		if ((fp[i] = fopen(path, "a")) == NULL ||
+			setvbuf(fp[i], NULL, _IONBF, 0) != 0 ||
+			fseek(fp[i], 0L, SEEK_END) != 0 || (end[i] = ftell(fp[i])) < 0 ||
+			(end[i] == 0 && (fwrite(magic[i], 1, ACCT_MAGIC_LEN, fp[i]) != ACCT_MAGIC_LEN ||
+			fflush(fp[i]) != 0))) {
+			log_err(errno, __func__, path);
+			if (fp[i] != NULL)
+				fclose(fp[i]);
+			if (i == 1)
+				fclose(fp[0]);
+			return (-1);
+		}
+		if (end[i] == 0)
+			end[i] = ACCT_MAGIC_LEN;
+	}
+	if ((end[1] > ACCT_MAGIC_LEN) && ((end[1] - ACCT_MAGIC_LEN) % ACCT_IDX_ENTRY_LEN != 0)) {
+		end[1] -= (end[1] - ACCT_MAGIC_LEN) % ACCT_IDX_ENTRY_LEN;
+		if (ftruncate(fileno(fp[1]), (off_t)end[1]) == -1) {
+			log_err(errno, __func__, "could not truncate binary accounting index");
+			fclose(fp[0]);
+			fclose(fp[1]);
+			return (-1);
+		}
+	}
+	*pbin = fp[0];
+	*pidx = fp[1];
+	*poff = end[0];
+	*pidxoff = end[1];
+	return (0);
+}
+
 /**
  * @brief
  * acct_open() - open the acct file for append.
@@ -922,7 +994,11 @@ acct_open(char *filename)
 {
     char  filen[_POSIX_PATH_MAX];
 	char  logmsg[_POSIX_PATH_MAX+80];
-	FILE *newacct;
+	FILE *newacct = NULL;
+	FILE *newbin = NULL;
+	FILE *newidx = NULL;
+	long long newoff = 0;
+	long long newidxoff = 0;
 	time_t now;
 	struct tm *ptm;
 
@@ -946,17 +1022,29 @@ acct_open(char *filename)
 	} else if (*filename != '/') {
 		return (-1);		/* not absolute */
 	}
-	if ((newacct = fopen(filename, "a")) == NULL) {
-		log_err(errno, "acct_open", filename);
-		return (-1);
+	if (pbs_conf.pbs_acct_binary != ACCT_FMT_BINARY) {
+		if ((newacct = fopen(filename, "a")) == NULL) {
+			log_err(errno, "acct_open", filename);
+			return (-1);
+		}
+		(void)setvbuf(newacct, NULL, _IOLBF, 0); /* set line buffering */
+	}
+	if (pbs_conf.pbs_acct_binary != ACCT_FMT_TEXT) {
+		if (acct_open_bin(filename, &newbin, &newidx, &newoff, &newidxoff) == -1) {
+			if (newacct != NULL)
+				(void)fclose(newacct);
+			return (-1);
+		}
 	}
-
-	(void)setvbuf(newacct, NULL, _IOLBF, 0); /* set line buffering */
 
 	if (acct_opened > 0) 		/* if acct was open, close it */
-		(void)fclose(acctfile);
+		acct_close();
 
 	acctfile = newacct;
+	acctbinfile = newbin;
+	acctidxfile = newidx;
+	acctbin_off = newoff;
+	acctidx_off = newidxoff;
 	acct_opened = 1;			/* note that file is open */
 	(void)sprintf(logmsg, "Account file %s opened", filename);
 	log_event(PBSEVENT_SYSTEM, PBS_EVENTCLASS_SERVER, LOG_INFO,
@@ -975,7 +1063,15 @@ void
 acct_close()
 {
 	if (acct_opened == 1) {
-		(void)fclose(acctfile);
+		if (acctfile != NULL)
+			(void)fclose(acctfile);
+		if (acctbinfile != NULL) {
+			(void)fclose(acctbinfile);
+			(void)fclose(acctidxfile);
+		}
+		acctfile = NULL;
+		acctbinfile = NULL;
+		acctidxfile = NULL;
 		acct_opened = 0;
 	}
 }
@@ -994,6 +1090,8 @@ void
 write_account_record(int acctype, const char *id, char *text)
 {
 	struct tm *ptm;
+	size_t len;
+	char idx[ACCT_IDX_ENTRY_LEN];
 
 	if (acct_opened == 0)
 		return;		/* file not open, don't bother */
@@ -1009,11 +1107,43 @@ write_account_record(int acctype, const char *id, char *text)
 	if (text == NULL)
 		text = "";
 
-	(void)fprintf(acctfile,
-		"%02d/%02d/%04d %02d:%02d:%02d;%c;%s;%s\n",
-		ptm->tm_mon+1, ptm->tm_mday, ptm->tm_year+1900,
-		ptm->tm_hour, ptm->tm_min, ptm->tm_sec,
-		(char)acctype, id, text);
+	if (acctfile != NULL)
+		(void)fprintf(acctfile,
+			"%02d/%02d/%04d %02d:%02d:%02d;%c;%s;%s\n",
+			ptm->tm_mon+1, ptm->tm_mday, ptm->tm_year+1900,
+			ptm->tm_hour, ptm->tm_min, ptm->tm_sec,
+			(char)acctype, id, text);
+
+	if (acctbinfile == NULL)
+		return;
+	len = acct_bin_encode(&acctbin_buf, &acctbin_bufsz, time_now, acctype, id, text);
+	if (len == 0) {
+		log_err(errno, __func__, "binary accounting record not written");
+		return;
+	}
+	if (fwrite(acctbin_buf, 1, len, acctbinfile) != len || fflush(acctbinfile) != 0) {
+		log_err(errno, __func__, "binary accounting record not written");
+		/* drop a partial record so the records after it can still be read */
+		clearerr(acctbinfile);
+		if (ftruncate(fileno(acctbinfile), (off_t)acctbin_off) == -1)
+			log_err(errno, __func__, "could not truncate binary accounting log");
+		return;
+	}
+	/* the record is on disk before its index entry, so an index never points past the end */
+	acct_idx_encode(idx, time_now, acctbin_off, id);
+	if (fwrite(idx, 1, ACCT_IDX_ENTRY_LEN, acctidxfile) != ACCT_IDX_ENTRY_LEN ||
+		fflush(acctidxfile) != 0) {
+		log_err(errno, __func__, "binary accounting index not written");
+		/* drop the partial entry, and the record it was for, so both stay in step */
+		clearerr(acctidxfile);
+		if (ftruncate(fileno(acctidxfile), (off_t)acctidx_off) == -1)
+			log_err(errno, __func__, "could not truncate binary accounting index");
+		if (ftruncate(fileno(acctbinfile), (off_t)acctbin_off) == -1)
+			log_err(errno, __func__, "could not truncate binary accounting log");
+		return;
+	}
+	acctbin_off += len;
+	acctidx_off += ACCT_IDX_ENTRY_LEN;
 }
 
 /**
@@ -1902,8 +2032,8 @@ account_job_update(job *pjob, int type)
 	char *pb = NULL;
 	pbs_list_head attrlist;
 	struct svrattrl *patlist = NULL;
-	char *resc_used = NULL;
-	int resc_used_size = 0;
+	static char *resc_used = NULL;	/* kept between records, grown by pbs_strcat() */
+	static int resc_used_size = 0;
 	int k, len_upd, attr_index;
 	char save_char = '\0';
 	int old_perm;
@@ -1984,10 +2114,12 @@ account_job_update(job *pjob, int type)
 	resc_access_perm = old_perm;
 
 	/* Allocate initial space for resc_used.  Future space will be allocated by pbs_strcat(). */
-	resc_used = malloc(RESC_USED_BUF_SIZE);
-	if (resc_used == NULL)
-		goto writeit;
-	resc_used_size = RESC_USED_BUF_SIZE;
+	if (resc_used == NULL) {
+		resc_used = malloc(RESC_USED_BUF_SIZE);
+		if (resc_used == NULL)
+			goto writeit;
+		resc_used_size = RESC_USED_BUF_SIZE;
+	}
 	resc_used[0] = '\0';
 
 	patlist = GET_NEXT(attrlist);
@@ -2085,8 +2217,6 @@ account_job_update(job *pjob, int type)
 writeit:
 	acct_buf[acct_bufsize - 1] = '\0';
 	account_record(type, pjob, acct_buf);
-	if (resc_used != NULL)
-		free(resc_used);
 }
 
 /**
@@ -2200,38 +2330,35 @@ void
 log_suspend_resume_record(job *pjob, int acct_type)
 {
 	if (acct_type == PBS_ACCT_SUSPEND) {
-		char *resc_buf;
-		int resc_buf_size = RESC_USED_BUF_SIZE;
+		static char *resc_buf = NULL;	/* kept between records, grown by pbs_strcat() */
+		static int resc_buf_size = 0;
 
 		/* Allocating initial space as required by resc_used. Future space will be allocated by pbs_strcat(). */
-		resc_buf = malloc(RESC_USED_BUF_SIZE);
-		if (resc_buf == NULL)
-			return;
+		if (resc_buf == NULL) {
+			resc_buf = malloc(RESC_USED_BUF_SIZE);
+			if (resc_buf == NULL)
+				return;
+			resc_buf_size = RESC_USED_BUF_SIZE;
+		}
 
 		resc_buf[0] = '\0';
 
 		if (get_resc_used(pjob, &resc_buf, &resc_buf_size) == -1) {
 			write_account_record(acct_type, pjob->ji_qs.ji_jobid, NULL);
-			free(resc_buf);
 			return;
 		}
 
 		if (is_jattr_set(pjob, JOB_ATR_resc_released)) {
 			char *ret;
 			ret = pbs_strcat(&resc_buf, &resc_buf_size, " resources_released=");
-			if (ret == NULL) {
-				free(resc_buf);
+			if (ret == NULL)
 				return;
-			}
 
 			ret = pbs_strcat(&resc_buf, &resc_buf_size, get_jattr_str(pjob, JOB_ATR_resc_released));
-			if (ret == NULL) {
-				free(resc_buf);
+			if (ret == NULL)
 				return;
-			}
 		}
 		write_account_record(acct_type, pjob->ji_qs.ji_jobid, resc_buf + 1);
-		free(resc_buf);
 		return;
 	}
 
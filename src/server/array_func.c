@@ -283,11 +283,18 @@ update_sj_parent(job *parent, job *sj, char *sjid, char oldstate, char newstate)
 	ptbl->tkm_subjsct[ostatenum]--;
 	ptbl->tkm_subjsct[nstatenum]++;
 
-	if (oldstate == JOB_STATE_LTR_QUEUED)
-		range_remove_value(&ptbl->trm_quelist, idx);
-	if (newstate == JOB_STATE_LTR_QUEUED)
-		range_add_value(&ptbl->trm_quelist, idx, ptbl->tkm_step);
-	update_array_indices_remaining_attr(parent);
+	/*
+	 * Only transitions into or out of Queued change the remaining
+	 * indices, so don't rebuild (and re-save) that string for others.
+	 */
+	if (oldstate == JOB_STATE_LTR_QUEUED || newstate == JOB_STATE_LTR_QUEUED) {
+		if (oldstate == JOB_STATE_LTR_QUEUED)
+			range_remove_value(&ptbl->trm_quelist, idx);
+		if (newstate == JOB_STATE_LTR_QUEUED)
+			range_add_value(&ptbl->trm_quelist, idx, ptbl->tkm_step);
+		update_array_indices_remaining_attr(parent);
+	} else
+		update_subjob_state_ct(parent);
 
 	if (sj && newstate != JOB_STATE_LTR_QUEUED) {
 		if (is_jattr_set(sj, JOB_ATR_exit_status)) {
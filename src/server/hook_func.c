@@ -103,6 +103,7 @@
 #include <dirent.h>
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <sys/time.h>
 #include <sys/wait.h>
 #include <ctype.h>
 #include <errno.h>
@@ -143,6 +144,7 @@
 #include "pbs_sched.h"
 #include "dis.h"
 #include "acct.h"
+#include "svr_latency.h"
 
 /* External functions */
 extern void disable_svr_prov();
@@ -2321,6 +2323,7 @@ status_hook(hook *phook, struct batch_request *preq, pbs_list_head *pstathd, cha
 	(void)strcpy(pstat->brp_objname, hookname);
 	CLEAR_LINK(pstat->brp_stlink);
 	CLEAR_HEAD(pstat->brp_attr);
+	pstat->brp_blob = NULL;
 	append_link(pstathd, &pstat->brp_stlink, pstat);
 	preq->rq_reply.brp_count++;
 
@@ -3964,6 +3967,9 @@ int server_process_hooks(int rq_type, char *rq_user, char *rq_host, hook *phook,
 	pbs_list_head 		event_vnode;
 	pbs_list_head 		event_resv;
 	char			perf_label[MAXBUFLEN];
+	struct timeval		run_start;
+	struct timeval		run_end;
+	double			run_secs;
 
 	if (phook == NULL) {
 		log_event(PBSEVENT_DEBUG3,
@@ -4200,6 +4206,7 @@ int server_process_hooks(int rq_type, char *rq_user, char *rq_host, hook *phook,
 
 	log_event(PBSEVENT_DEBUG3, PBS_EVENTCLASS_HOOK,
 		LOG_INFO, phook->hook_name, "started");
+	gettimeofday(&run_start, NULL);
 
 	pbs_python_set_mode(PY_MODE); /* hook script mode */
 
@@ -4386,10 +4393,27 @@ int server_process_hooks(int rq_type, char *rq_user, char *rq_host, hook *phook,
 	}
 
 	pbs_python_set_mode(C_MODE); /* PBS C mode - flexible */
-	log_event(PBSEVENT_DEBUG3, PBS_EVENTCLASS_HOOK,
-		LOG_INFO, phook->hook_name, "finished");
 	set_alarm(0, NULL);
 
+	/*
+	 * Request-path hooks run on the server's main loop, so every
+	 * other request waits for them.  Report how long this one held it
+	 * and warn once a hook is using more than half of its alarm.
+	 */
+	gettimeofday(&run_end, NULL);
+	run_secs = (double)(run_end.tv_sec - run_start.tv_sec) +
+		(double)(run_end.tv_usec - run_start.tv_usec) * .000001;
+	log_eventf(PBSEVENT_DEBUG3, PBS_EVENTCLASS_HOOK, LOG_INFO,
+		phook->hook_name, "finished in %.3f secs", run_secs);
+	lat_add(LAT_HOOK, rq_type, (unsigned long)(run_secs * 1000000));
+	if ((rq_type != PBS_BATCH_HookPeriodic) && (phook->alarm > 0) &&
+	    (run_secs > (double)phook->alarm / 2))
+		log_eventf(PBSEVENT_ADMIN | PBSEVENT_DEBUG2, PBS_EVENTCLASS_HOOK,
+			LOG_WARNING, phook->hook_name,
+			"%s hook took %.3f secs of its %d sec alarm, "
+			"server requests were blocked meanwhile",
+			hook_event_as_string(hook_event), run_secs, phook->alarm);
+
 	switch (rc) {
 		case -1:	/* internal error */
 			log_event(PBSEVENT_DEBUG2, PBS_EVENTCLASS_HOOK,
@@ -1754,6 +1754,9 @@ resv_free(resc_resv *presv)
 	for (i=0; i < (int)RESV_ATR_LAST; i++)
 		free_rattr(presv, i);
 
+	for (i = 0; i < 2; i++)
+		free_brp_blob(presv->ri_statblob[i]);
+
 	/* delete any work task entries associated with the resv */
 
 	while ((pwt = (struct work_task *)GET_NEXT(presv->ri_svrtask)) != 0) {
@@ -52,6 +52,7 @@
 #include <time.h>
 
 #include <unistd.h>
+#include <pthread.h>
 #include "server_limits.h"
 #include "list_link.h"
 #include "attribute.h"
@@ -64,9 +65,12 @@
 #include <memory.h>
 #include "libutil.h"
 #include "pbs_db.h"
+#include "svr_latency.h"
 
 
 #define MAX_SAVE_TRIES 3
+#define RECOV_FETCH_SIZE 4096	/* job rows fetched from the cursor at a time */
+#define RECOV_MAX_THREADS 8	/* upper bound of threads loading job rows */
 
 extern void *svr_db_conn;
 extern int server_init_type;
@@ -80,6 +84,27 @@ extern time_t time_now;
 job *recov_job_cb(pbs_db_obj_info_t *dbobj, int *refreshed);
 resc_resv *recov_resv_cb(pbs_db_obj_info_t *dbobj, int *refreshed);
 
+struct recov_batch;
+
+/* a thread loading every step'th row of a batch, starting at row first */
+struct recov_loader {
+	struct recov_batch *batch;
+	int first;
+	int step;
+	int started;	/* set if tid is a thread to be joined */
+	pthread_t tid;
+};
+
+/* a batch of job rows fetched from the cursor by recov_jobs_db() */
+struct recov_batch {
+	void *rows;			/* from pbs_db_cursor_fetch() */
+	int count;			/* number of rows */
+	pbs_db_job_info_t *dbjobs;	/* the loaded rows */
+	int *rcs;			/* return code of loading each row */
+	int nloaders;
+	struct recov_loader loaders[RECOV_MAX_THREADS];
+};
+
 /**
  * @brief
  *		convert job structure to DB format
@@ -237,7 +262,9 @@ job_save_db(job *pjob)
 	int rc = -1;
 	int old_mtime, old_flags;
 	char *conn_db_err = NULL;
+	struct timespec start;
 
+	LAT_START(&start);
 	old_mtime = get_jattr_long(pjob, JOB_ATR_mtime);
 	old_flags = (get_jattr(pjob, JOB_ATR_mtime))->at_flags;
 
@@ -272,6 +299,7 @@ done:
 			panic_stop_db();
 	}
 
+	lat_record(LAT_DB_SAVE, LAT_DB_JOB, &start);
 	return (rc);
 }
 
@@ -453,7 +481,9 @@ resv_save_db(resc_resv *presv)
 	int old_mtime, old_flags;
 	char *conn_db_err = NULL;
 	attribute *mtime;
+	struct timespec start;
 
+	LAT_START(&start);
 	mtime = get_rattr(presv, RESV_ATR_mtime);
 	old_mtime = get_attr_l(mtime);
 	old_flags = mtime->at_flags;
@@ -488,6 +518,7 @@ done:
 			panic_stop_db();
 	}
 
+	lat_record(LAT_DB_SAVE, LAT_DB_RESV, &start);
 	return (rc);
 }
 
@@ -592,6 +623,205 @@ err:
 	return pj;
 }
 
+/**
+ * @brief
+ *		recov_load_rows - thread function loading the rows of a batch
+ *		into their pbs_db_job_info_t, which decodes the attribute array of
+ *		the row into its list of svrattrl. Nothing but the batch is touched.
+ *
+ * @param[in]	arg	- the struct recov_loader of the thread
+ *
+ * @return	void *
+ * @retval	NULL always
+ */
+static void *
+recov_load_rows(void *arg)
+{
+	struct recov_loader *pl = arg;
+	struct recov_batch *pb = pl->batch;
+	pbs_db_obj_info_t obj;
+	int i;
+
+	obj.pbs_db_obj_type = PBS_DB_JOB;
+	for (i = pl->first; i < pb->count; i += pl->step) {
+		obj.pbs_db_un.pbs_db_job = &pb->dbjobs[i];
+		pb->rcs[i] = pbs_db_batch_load(pb->rows, i, &obj);
+	}
+	return NULL;
+}
+
+/**
+ * @brief
+ *		recov_load_start - start loading the rows of a batch from row from
+ *		on, with one thread per nthreads. If a thread cannot be created,
+ *		its share of the rows is loaded right away by the caller.
+ *
+ * @param[in]	pb	- the batch
+ * @param[in]	from	- first row to load
+ * @param[in]	nthreads - number of threads
+ *
+ * @return	void
+ */
+static void
+recov_load_start(struct recov_batch *pb, int from, int nthreads)
+{
+	int i;
+
+	pb->nloaders = nthreads;
+	for (i = 0; i < nthreads; i++) {
+		pb->loaders[i].batch = pb;
+		pb->loaders[i].first = from + i;
+		pb->loaders[i].step = nthreads;
+		pb->loaders[i].started = (pthread_create(&pb->loaders[i].tid, NULL, recov_load_rows, &pb->loaders[i]) == 0);
+		if (!pb->loaders[i].started)
+			recov_load_rows(&pb->loaders[i]);
+	}
+}
+
+/**
+ * @brief
+ *		recov_load_wait - wait for the rows of a batch to be loaded
+ *
+ * @param[in]	pb	- the batch
+ *
+ * @return	void
+ */
+static void
+recov_load_wait(struct recov_batch *pb)
+{
+	int i;
+
+	for (i = 0; i < pb->nloaders; i++) {
+		if (pb->loaders[i].started)
+			pthread_join(pb->loaders[i].tid, NULL);
+	}
+	pb->nloaders = 0;
+}
+
+/**
+ * @brief
+ *		recov_jobs_db - recover all the jobs from the database at startup.
+ *
+ *		The job rows are read through a server side cursor, RECOV_FETCH_SIZE
+ *		at a time, in a three stage pipeline: while the next batch is being
+ *		fetched, the rows of the current one are loaded by up to
+ *		RECOV_MAX_THREADS threads, and once they are, the jobs are created
+ *		and linked into the queues and indexes by recov_job_cb(), on this
+ *		thread and in queue rank order, while the next batch loads.
+ *
+ * @param[in]	conn	- connected database handle
+ *
+ * @return	int
+ * @retval	-1	- Failure
+ * @retval	>=0	- number of jobs recovered
+ */
+int
+recov_jobs_db(void *conn)
+{
+	struct recov_batch batches[2];
+	struct recov_batch *cur = &batches[0];
+	struct recov_batch *nxt = &batches[1];
+	struct recov_batch *tmp;
+	pbs_db_obj_info_t obj;
+	struct timespec start;
+	struct timespec ts;
+	unsigned long fetch_us = 0;
+	unsigned long wait_us = 0;
+	unsigned long link_us = 0;
+	long ncpus;
+	int nthreads;
+	int njobs = 0;
+	int nrows = 0;
+	int refreshed;
+	int rc = 0;
+	int i;
+
+	LAT_START(&start);
+	memset(batches, 0, sizeof(batches));
+
+	ncpus = sysconf(_SC_NPROCESSORS_ONLN);
+	nthreads = (ncpus < 1) ? 1 : (ncpus > RECOV_MAX_THREADS) ? RECOV_MAX_THREADS : (int) ncpus;
+
+	for (i = 0; i < 2; i++) {
+		batches[i].dbjobs = calloc(RECOV_FETCH_SIZE, sizeof(pbs_db_job_info_t));
+		batches[i].rcs = calloc(RECOV_FETCH_SIZE, sizeof(int));
+		if (batches[i].dbjobs == NULL || batches[i].rcs == NULL) {
+			log_err(errno, __func__, "Out of memory");
+			rc = -1;
+			goto done;
+		}
+	}
+
+	obj.pbs_db_obj_type = PBS_DB_JOB;
+	obj.pbs_db_un.pbs_db_job = &cur->dbjobs[0];
+	if (pbs_db_cursor_open(conn, &obj, NULL) != 0) {
+		rc = -1;
+		goto done;
+	}
+
+	LAT_START(&ts);
+	cur->count = pbs_db_cursor_fetch(conn, RECOV_FETCH_SIZE, &cur->rows);
+	fetch_us += lat_since(&ts);
+	if (cur->count > 0) {
+		/* the first row is loaded here, before any thread, see pbs_db_batch_load() */
+		cur->rcs[0] = pbs_db_batch_load(cur->rows, 0, &obj);
+		recov_load_start(cur, 1, nthreads);
+	}
+
+	while (cur->count > 0) {
+		LAT_START(&ts);
+		nxt->count = pbs_db_cursor_fetch(conn, RECOV_FETCH_SIZE, &nxt->rows);
+		fetch_us += lat_since(&ts);
+
+		LAT_START(&ts);
+		recov_load_wait(cur);
+		wait_us += lat_since(&ts);
+
+		if (nxt->count > 0)
+			recov_load_start(nxt, 0, nthreads);
+
+		LAT_START(&ts);
+		for (i = 0; i < cur->count; i++) {
+			obj.pbs_db_un.pbs_db_job = &cur->dbjobs[i];
+			if (cur->rcs[i] != 0) {
+				free_db_attr_list(&cur->dbjobs[i].db_attr_list);
+				log_errf(PBSE_SYSTEM, __func__, "Failed to load job %s", cur->dbjobs[i].ji_jobid);
+				continue;
+			}
+			if (recov_job_cb(&obj, &refreshed) != NULL && refreshed)
+				njobs++;
+		}
+		link_us += lat_since(&ts);
+		nrows += cur->count;
+
+		pbs_db_batch_free(cur->rows);
+		cur->rows = NULL;
+		cur->count = 0;
+
+		tmp = cur;
+		cur = nxt;
+		nxt = tmp;
+	}
+	if (cur->count == -1)
+		rc = -1;
+
+	if (pbs_db_cursor_close(conn) != 0)
+		rc = -1;
+
+	log_eventf(PBSEVENT_SYSTEM, PBS_EVENTCLASS_SERVER, LOG_INFO, msg_daemonname,
+		"Recovered %d of %d jobs in %lu ms with %d loader threads: fetch %lu ms, load wait %lu ms, link %lu ms",
+		njobs, nrows, lat_since(&start) / 1000, nthreads, fetch_us / 1000, wait_us / 1000, link_us / 1000);
+
+done:
+	for (i = 0; i < 2; i++) {
+		free(batches[i].dbjobs);
+		free(batches[i].rcs);
+		batches[i].dbjobs = NULL;
+		batches[i].rcs = NULL;
+	}
+	return (rc == -1 ? -1 : njobs);
+}
+
 /**
  * @brief
  * 		recov_resv_cb - callback function to process and load
@@ -314,8 +314,10 @@ is_nattr_set(const struct pbsnode *pnode, int attr_idx)
 void
 free_nattr(struct pbsnode *pnode, int attr_idx)
 {
-	if (pnode != NULL)
+	if (pnode != NULL) {
 		free_attr(node_attr_def, get_nattr(pnode, attr_idx), attr_idx);
+		get_nattr(pnode, attr_idx)->at_flags |= ATR_VFLAG_MODCACHE;
+	}
 }
 
 /**
@@ -330,6 +332,7 @@ void
 clear_nattr(struct pbsnode *pnode, int attr_idx)
 {
 	clear_attr(get_nattr(pnode, attr_idx), &node_attr_def[attr_idx]);
+	get_nattr(pnode, attr_idx)->at_flags |= ATR_VFLAG_MODCACHE;
 }
 
 /**
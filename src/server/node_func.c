@@ -101,6 +101,7 @@ extern unsigned int pbs_mom_port;
 extern unsigned int pbs_rm_port;
 extern mominfo_time_t  mominfo_time;
 extern char	*resc_in_err;
+extern int	 resc_access_perm;
 extern void *node_idx;
 extern time_t	 time_now;
 extern int write_single_node_mom_attr(struct pbsnode *np);
@@ -199,6 +200,7 @@ status_nodeattrib(svrattrl *pal, struct pbsnode *pnode, int limit, int priv, pbs
 	attribute_def *padef = node_attr_def;
 
 	priv &= ATR_DFLAG_RDACC;  		/* user-client privilege      */
+	resc_access_perm = priv;		/* pass privilege to encode_resc() */
 
 	if (pal) {   /*caller has requested status on specific node-attributes*/
 		nth = 0;
@@ -317,6 +319,8 @@ initialize_pbsnode(struct pbsnode *pnode, char *pname, int ntype)
 	if (pnode->nd_moms == NULL)
 		return (PBSE_SYSTEM);
 	pnode->nd_nummslots = 1;
+	pnode->nd_statblob[0] = NULL;
+	pnode->nd_statblob[1] = NULL;
 	CLEAR_LINK(pnode->nd_link);
 
 	/* first, clear the attributes */
@@ -526,6 +530,8 @@ free_pnode(struct pbsnode *pnode)
 	free(pnode->nd_name);
 	free(pnode->nd_hostname);
 	free(pnode->nd_moms);
+	for (i = 0; i < 2; i++)
+		free_brp_blob(pnode->nd_statblob[i]);
 	/* free attributes */
 	for (i = 0; i < ND_ATR_LAST; i++) {
 		if (is_attr_set(&pnode->nd_attr[i]))
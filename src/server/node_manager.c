@@ -91,6 +91,7 @@
 #include	"provision.h"
 #include 	"pbs_sched.h"
 #include	"svrfunc.h"
+#include	"svr_latency.h"
 
 #if !defined(H_ERRNO_DECLARED)
 extern int h_errno;
@@ -129,6 +130,8 @@ extern struct prov_tracking * get_prov_record_by_vnode(char *);
 extern int parse_prov_vnode(char *,exec_vnode_listtype *);
 
 static void check_and_set_multivnode(struct pbsnode *);
+static unsigned int vnl_digest(vnl_t *);
+static int update2_unchanged(mominfo_t *, vnl_t *);
 int write_single_node_mom_attr(struct pbsnode *np);
 
 static char *hook_privilege = "Not allowed to update vnodes or to request scheduler restart cycle, if run as a non-manager/operator user %s@%s";
@@ -1174,6 +1177,17 @@ set_vnode_state(struct pbsnode *pnode, unsigned long state_bits, enum vnode_stat
 		return;
 	}
 
+	/*
+	 * Nothing changes, as for most of the updates from Moms, so there is
+	 * no transition to log or to fire a modifyvnode event for
+	 */
+	if (((type == Nd_State_Set && state_bits == pnode->nd_state) ||
+		(type == Nd_State_Or && (pnode->nd_state | state_bits) == pnode->nd_state) ||
+		(type == Nd_State_And && (pnode->nd_state & state_bits) == pnode->nd_state)) &&
+		(pnode->nd_state == get_nattr_long(pnode, ND_ATR_state)) &&
+		!(pnode->nd_state & INUSE_PROV))
+		return;
+
 	/*
 	 * Allocate space for the modifyvnode hook event params
 	 */
@@ -2579,6 +2593,8 @@ deallocate_job_from_node(char *jobid, struct pbsnode *pnode)
 	}
 
 	still_has_jobs = 0;
+	/* the jobs attribute is encoded from the subnode lists changed below */
+	get_nattr(pnode, ND_ATR_jobs)->at_flags |= ATR_VFLAG_MODCACHE;
 	for (np = pnode->nd_psn; np; np = np->next) {
 
 		for (prev = NULL, jp = np->jobs; jp; jp = next) {
@@ -4149,6 +4165,101 @@ err:
 }
 
 
+/**
+ * @brief
+ * 		FNV-1a digest of the vnode list of an UPDATE2 message: its mod
+ *		time and every vnode with all the names, values, types and flags
+ *		of its attributes.
+ *
+ * @param[in]	vnlp	- the vnode list
+ *
+ * @return	unsigned int
+ * @retval	the digest, never 0 which stands for no digest
+ */
+static unsigned int
+vnl_digest(vnl_t *vnlp)
+{
+	unsigned int h = 2166136261U;
+	const unsigned char *p;
+	size_t i;
+	size_t j;
+	int k;
+	long v;
+
+#define VNL_DIGEST_BYTES(ptr, len) \
+	for (p = (const unsigned char *)(ptr), k = 0; k < (int)(len); k++) { \
+		h ^= p[k]; \
+		h *= 16777619U; \
+	}
+
+	v = (long) vnlp->vnl_modtime;
+	VNL_DIGEST_BYTES(&v, sizeof(v))
+	for (i = 0; i < vnlp->vnl_used; i++) {
+		vnal_t *pvnal = VNL_NODENUM(vnlp, i);
+
+		VNL_DIGEST_BYTES(pvnal->vnal_id, strlen(pvnal->vnal_id) + 1)
+		for (j = 0; j < pvnal->vnal_used; j++) {
+			vna_t *psrp = VNAL_NODENUM(pvnal, j);
+
+			VNL_DIGEST_BYTES(psrp->vna_name, strlen(psrp->vna_name) + 1)
+			VNL_DIGEST_BYTES(psrp->vna_val, strlen(psrp->vna_val) + 1)
+			VNL_DIGEST_BYTES(&psrp->vna_type, sizeof(psrp->vna_type))
+			VNL_DIGEST_BYTES(&psrp->vna_flag, sizeof(psrp->vna_flag))
+		}
+		/* end of vnode marker */
+		VNL_DIGEST_BYTES("", 1)
+	}
+#undef VNL_DIGEST_BYTES
+
+	return (h == 0 ? 1 : h);
+}
+
+/**
+ * @brief
+ * 		Apply an UPDATE2 vnode list which is the same as the last one
+ *		applied for the Mom.  Every vnode in the list must still exist
+ *		with the Mom as a parent, otherwise nothing is done and the list
+ *		has to be applied in full by update2_to_vnode().  All that
+ *		update2_to_vnode() would change then are the stale, down and
+ *		unknown state bits of the vnodes, which are cleared here.
+ *		Vnodes already without them are not touched at all, so that no
+ *		state change hooks run and nothing is saved for them.
+ *
+ * @param[in]	pmom	- the Mom which sent the list
+ * @param[in]	vnlp	- the vnode list
+ *
+ * @return	int
+ * @retval	1	- the list was applied
+ * @retval	0	- the list has to be applied in full
+ */
+static int
+update2_unchanged(mominfo_t *pmom, vnl_t *vnlp)
+{
+	unsigned long clear = INUSE_STALE | INUSE_DOWN | INUSE_UNKNOWN;
+	struct pbsnode *pnode;
+	size_t i;
+	int j;
+
+	for (i = 0; i < vnlp->vnl_used; i++) {
+		pnode = find_nodebyname(VNL_NODENUM(vnlp, i)->vnal_id);
+		if (pnode == NULL)
+			return 0;
+		for (j = 0; j < pnode->nd_nummoms; j++) {
+			if (pnode->nd_moms[j] == pmom)
+				break;
+		}
+		if (j == pnode->nd_nummoms)
+			return 0;
+	}
+
+	for (i = 0; i < vnlp->vnl_used; i++) {
+		pnode = find_nodebyname(VNL_NODENUM(vnlp, i)->vnal_id);
+		if (pnode->nd_state & clear)
+			set_vnode_state(pnode, ~clear, Nd_State_And);
+	}
+	return 1;
+}
+
 /**
  * @brief
  * 		Input is coming from another server (MOM) over a TPP stream.
@@ -4194,6 +4305,7 @@ is_request(int stream, int version)
 	char			*val;
 	unsigned long		 oldstate;
 	vnl_t			*vnlp;			/* vnode list */
+	unsigned int		vnl_dig = 0;		/* digest of vnlp */
 	static char		node_up[] = "node up";
 	pbs_list_head		reported_hooks;
 	hook			*phook;
@@ -4201,7 +4313,9 @@ is_request(int stream, int version)
 	unsigned long		hook_rescdef_checksum;
 	unsigned long		chksum_rescdef;
 	static int		reply_send_tm = 0;
+	struct timespec		start;
 
+	LAT_START(&start);
 	CLEAR_HEAD(reported_hooks);
 	DBPRT(("%s: stream %d version %d\n", __func__, stream, version))
 	addr = tpp_getaddr(stream);
@@ -4498,9 +4612,20 @@ found:
 				vnlp = vn_decode_DIS(stream, &ret);
 				if (ret != DIS_SUCCESS)
 					goto err;
+				if (vnlp != NULL)
+					vnl_dig = vnl_digest(vnlp);
 				if (vnlp == NULL) {
 					sprintf(log_buffer, "vn_decode_DIS vn failed");
 					log_err(-1, __func__, log_buffer);
+				} else if ((vnlp->vnl_modtime == pmom->mi_modtime) &&
+					(vnl_dig == psvrmom->msr_vnl_digest) &&
+					update2_unchanged(pmom, vnlp)) {
+					/*
+					 * Same vnode list as the last one applied, as Moms
+					 * resend after reconnecting; nothing to decode or save
+					 */
+					log_eventf(PBSEVENT_DEBUG3, PBS_EVENTCLASS_NODE, LOG_DEBUG, pmom->mi_host,
+						"Mom reporting %lu vnodes, unchanged", vnlp->vnl_used);
 				} else if (vnlp->vnl_modtime >= pmom->mi_modtime) {
 					int	i, j;
 
@@ -4569,6 +4694,8 @@ found:
 						save_nodes_db(1, pmom); /* update the node database */
 						propagate_licenses_to_vnodes(pmom);
 					}
+				} else {
+					vnl_dig = 0;	/* older than what was applied */
 				}
 				vnl_free(vnlp);
 				vnlp = NULL;
@@ -4713,6 +4840,10 @@ found:
 				save_nodes_db(1, pmom); /* update the node database */
 			}
 
+			/* after any save above, which resets it */
+			if (vnl_dig != 0)
+				psvrmom->msr_vnl_digest = vnl_dig;
+
 		if (command_orig == IS_REGISTERMOM) {
 			/* Mom is acknowledging the info sent by the Server */
 			/* Mark the Mom and associated vnodes as up */
@@ -5172,6 +5303,8 @@ found:
 	}
 
 	tpp_eom(stream);
+	/* a registration is handled as an update, count it as what was sent */
+	lat_record(LAT_IS, command_orig ? command_orig : command, &start);
 	return;
 
 err:
@@ -6205,6 +6338,8 @@ assign_jobs_on_subnode(struct pbsnode *pnode, int hw_ncpus, char *jobid, int svr
 		}
 	}
 
+	/* the jobs attribute is encoded from the subnode lists changed below */
+	get_nattr(pnode, ND_ATR_jobs)->at_flags |= ATR_VFLAG_MODCACHE;
 	snp = pnode->nd_psn;
 	if (hw_ncpus == 0) {
 		/* setup jobinfo struture */
@@ -6914,6 +7049,7 @@ set_nodes(void *pobj, int objtype, char *execvnod_in, char **execvnod_out, char
 				rp->next = (phowl + i)->hw_pnd->nd_resvp;
 				(phowl + i)->hw_pnd->nd_resvp = rp;
 				rp->resvp = presv;
+				get_nattr((phowl + i)->hw_pnd, ND_ATR_resvs)->at_flags |= ATR_VFLAG_MODCACHE;
 
 				/* create a backlink from the reservation to the vnode */
 				tmp_pl = malloc(sizeof(pbsnode_list_t));
@@ -7097,6 +7233,7 @@ free_resvNodes(resc_resv *presv)
 
 			DBPRT(("Freeing resvinfo on node %s from reservation %s\n",
 				pnode->nd_name, presv->ri_qs.ri_resvID))
+			get_nattr(pnode, ND_ATR_resvs)->at_flags |= ATR_VFLAG_MODCACHE;
 			if (prev == NULL) {
 				pnode->nd_resvp = rinfp->next;
 				free(rinfp);
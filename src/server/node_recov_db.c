@@ -82,6 +82,7 @@
 #include <memory.h>
 #include "libutil.h"
 #include "pbs_db.h"
+#include "svr_latency.h"
 
 struct pbsnode *recov_node_cb(pbs_db_obj_info_t *dbobj, int *refreshed);
 struct pbsnode *pbsd_init_node(pbs_db_node_info_t *dbnode, int type);
@@ -335,6 +336,19 @@ node_save_db(struct pbsnode *pnode)
 	char *conn_db_err = NULL;
 	int savetype;
 	int rc = -1;
+	struct timespec start;
+	int i;
+
+	LAT_START(&start);
+
+	/*
+	 * the vnode changed other than by an UPDATE2 of its Moms, have the
+	 * next one reapplied in full, see is_request()
+	 */
+	for (i = 0; i < pnode->nd_nummoms; i++) {
+		if (pnode->nd_moms[i] != NULL && pnode->nd_moms[i]->mi_data != NULL)
+			((mom_svrinfo_t *) pnode->nd_moms[i]->mi_data)->msr_vnl_digest = 0;
+	}
 
 	if ((savetype = node_to_db(pnode, &dbnode))  == -1)
 		goto done;
@@ -359,6 +373,7 @@ done:
 		free(conn_db_err);
 		panic_stop_db();
 	}
+	lat_record(LAT_DB_SAVE, LAT_DB_NODE, &start);
 	return rc;
 }
 
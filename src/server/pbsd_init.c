@@ -100,6 +100,7 @@
 #include "pbs_share.h"
 #include "pbs_undolr.h"
 #include "liblicense.h"
+#include "svr_latency.h"
 
 #ifndef SIGKILL
 /* there is some weid stuff in gcc include files signal.h & sys/params.h */
@@ -165,7 +166,7 @@ extern void offline_all_provisioning_vnodes(void);
 extern void stop_db();
 extern job *job_recov_db_spl(pbs_db_job_info_t *dbjob, job *pjob);
 extern pbs_sched *sched_alloc(char *sched_name);
-extern job *recov_job_cb(pbs_db_obj_info_t *, int *);
+extern int recov_jobs_db(void *);
 extern resc_resv *recov_resv_cb(pbs_db_obj_info_t *, int *);
 extern pbs_queue *recov_queue_cb(pbs_db_obj_info_t *, int *);
 extern pbs_sched *recov_sched_cb(pbs_db_obj_info_t *, int *);
@@ -184,12 +185,31 @@ static void  stop_me(int);
 static int   Rmv_if_resv_not_possible(job *);
 static int   attach_queue_to_reservation(resc_resv *);
 static void  call_log_license(struct work_task *);
+static void  log_phase_time(char *, struct timespec *);
 /* private data */
 
 #define CHANGE_STATE 1
 #define KEEP_STATE   0
 static char badlicense[] = "One or more PBS license keys are invalid, jobs may not run";
 char *pbs_licensing_location  = NULL;
+/**
+ * @brief
+ *		log_phase_time - log how long a phase of the startup recovery took
+ *		and restart the clock for the next one
+ *
+ * @param[in]	phase	- name of the phase
+ * @param[in,out] start	- start time of the phase, reset to now
+ *
+ * @return	void
+ */
+static void
+log_phase_time(char *phase, struct timespec *start)
+{
+	log_eventf(PBSEVENT_SYSTEM, PBS_EVENTCLASS_SERVER, LOG_INFO, msg_daemonname,
+		"Recovery of %s took %lu ms", phase, lat_since(start) / 1000);
+	LAT_START(start);
+}
+
 /**
  * @brief
  *		Initializes the server attribute array with default values which are
@@ -314,7 +334,6 @@ pbsd_init(int type)
 	struct sigaction oact;
 
 	struct tm	*ptm;
-	pbs_db_job_info_t	dbjob = {{0}};
 	pbs_db_resv_info_t	dbresv = {{0}};
 	pbs_db_que_info_t	dbque = {{0}};
 	pbs_db_sched_info_t	dbsched = {{0}};
@@ -322,6 +341,7 @@ pbsd_init(int type)
 	void	*conn = (void *) svr_db_conn;
 	char *buf = NULL;
 	int buf_len = 0;
+	struct timespec phase_start;
 
 #ifdef  RLIMIT_CORE
 	int      char_in_cname = 0;
@@ -656,6 +676,7 @@ pbsd_init(int type)
 	}
 
 	server.sv_qs.sv_numque = 0;
+	LAT_START(&phase_start);
 
 	/* get jobs from DB for this instance of server, by port and address */
 	obj.pbs_db_obj_type = PBS_DB_QUEUE;
@@ -670,6 +691,7 @@ pbsd_init(int type)
 		}
 		return (-1);
 	}
+	log_phase_time("queues", &phase_start);
 
 	/* Initialize server instsances before loading jobs/resv */
 	init_msi();
@@ -685,6 +707,7 @@ pbsd_init(int type)
 	/* at this point, we know all the resource types have been defined,        */
 	/* build the resource summation table for validating the Select directives */
 	update_resc_sum();
+	log_phase_time("nodes", &phase_start);
 
 	/*
 	 * 8B. If not a "create" initialization, recover reservations.
@@ -711,13 +734,14 @@ pbsd_init(int type)
 		}
 		return (-1);
 	}
+	log_phase_time("reservations", &phase_start);
 
 	/*
 	 * 9. If not "create" or "clean" recovery, recover the jobs.
 	 *    If a create or clean recovery, delete any jobs.
 	 *    Before job creation/recovery, create the jobs index.
 	 */
-	if ((jobs_idx = pbs_idx_create(0, 0)) == NULL) {
+	if ((jobs_idx = pbs_idx_create(PBS_IDX_HASH, 0)) == NULL) {
 		log_err(-1, __func__, "Creating jobs index failed!");
 		return (-1);
 	}
@@ -725,9 +749,7 @@ pbsd_init(int type)
 	server.sv_qs.sv_numjobs = 0;
 
 	/* get jobs from DB */
-	obj.pbs_db_obj_type = PBS_DB_JOB;
-	obj.pbs_db_un.pbs_db_job = &dbjob;
-	rc = pbs_db_search(conn, &obj, NULL, (query_cb_t)&recov_job_cb);
+	rc = recov_jobs_db(conn);
 	if (rc == -1) {
 		pbs_db_get_errmsg(PBS_DB_ERR, &conn_db_err);
 		if (conn_db_err != NULL) {
@@ -735,11 +757,12 @@ pbsd_init(int type)
 			free(conn_db_err);
 		}
 		return (-1);
-	} else if (rc == 1) {
+	} else if (rc == 0) {
 		if ((type != RECOV_CREATE) && (type != RECOV_COLD))
 			log_event(PBSEVENT_DEBUG, PBS_EVENTCLASS_SERVER,
 				LOG_DEBUG, msg_daemonname, msg_init_nojobs);
 	}
+	log_phase_time("jobs", &phase_start);
 
 	log_eventf(PBSEVENT_SYSTEM, PBS_EVENTCLASS_SERVER, LOG_NOTICE, msg_daemonname, msg_init_exptjobs, server.sv_qs.sv_numjobs);
 
@@ -1137,6 +1160,7 @@ pbsd_init(int type)
 	hook_track_save(NULL, -1); /* refresh path_hooks_tracking file */
 
 	(void)set_task(WORK_Immed, time_now, memory_debug_log, NULL);
+	(void)set_task(WORK_Timed, time_now + LAT_DUMP_INTERVAL, lat_dump, NULL);
 
 	return (0);
 }
@@ -1201,6 +1201,10 @@ main(int argc, char **argv)
 	tpp_set_app_net_handler(net_down_handler, net_restore_handler);
 	tpp_conf.node_type = TPP_LEAF_NODE_LISTEN; /* server needs to know about all CTL LEAVE messages */
 
+	/* in the background now, so the log writer thread stays with us */
+	if (pbs_conf.pbs_log_async && (log_set_async(1) != 0))
+		log_err(-1, msg_daemonname, "unable to start log writer thread, logging synchronously");
+
 	if ((tppfd = tpp_init(&tpp_conf)) == -1) {
 		log_err(-1, msg_daemonname, "tpp_init failed");
 		fprintf(stderr, "%s", log_buffer);
@@ -110,6 +110,9 @@
 #include <libutil.h>
 #include "pbs_sched.h"
 #include "auth.h"
+#ifndef PBS_MOM
+#include "svr_latency.h"
+#endif
 
 /* global data items */
 
@@ -391,6 +394,10 @@ process_request(int sfds)
 	conn_t		     *conn;
 #ifndef PBS_MOM
 	int		     access_by_krb;
+	int		     rq_type;
+	struct timespec	     start;
+
+	LAT_START(&start);
 #endif
 
 
@@ -418,6 +425,16 @@ process_request(int sfds)
 		return;
 	}
 	request->rq_conn = sfds;
+#ifndef PBS_MOM
+	/*
+	 * The peer of a connection does not change, so reuse the name
+	 * resolved for its first request instead of doing a reverse lookup
+	 * for every request, e.g. each run request from the scheduler.
+	 */
+	if (conn->cn_physhost[0] != '\0')
+		strcpy(request->rq_host, conn->cn_physhost);
+	else
+#endif
 	if (get_connecthost(sfds, request->rq_host, PBS_MAXHOSTNAME)) {
 		log_eventf(PBSEVENT_DEBUG, PBS_EVENTCLASS_REQUEST, LOG_DEBUG, __func__, "%s: %lu", msg_reqbadhost, get_connectaddr(sfds));
 		req_reject(PBSE_BADHOST, 0, request);
@@ -660,6 +677,7 @@ process_request(int sfds)
 			case PBS_BATCH_MoveJob:
 			case PBS_BATCH_QueueJob:
 			case PBS_BATCH_RunJob:
+			case PBS_BATCH_RunJobList:
 			case PBS_BATCH_StageIn:
 			case PBS_BATCH_jobscript:
 				req_reject(PBSE_SVRDOWN, 0, request);
@@ -696,7 +714,13 @@ process_request(int sfds)
 	 * the request struture.
 	 */
 
+#ifndef PBS_MOM
+	rq_type = request->rq_type;	/* request may be freed by dispatch */
+	dispatch_request(sfds, request);
+	lat_record(LAT_BATCH, rq_type, &start);
+#else
 	dispatch_request(sfds, request);
+#endif
 	return;
 }
 
@@ -961,6 +985,10 @@ dispatch_request(int sfds, struct batch_request *request)
 			req_runjob(request);
 			break;
 
+		case PBS_BATCH_RunJobList:
+			req_runjoblist(request);
+			break;
+
 		case PBS_BATCH_DefSchReply:
 			req_defschedreply(request);
 			break;
@@ -1174,6 +1202,12 @@ process_IS_CMD(int stream)
 	struct batch_request *request;
 	struct	sockaddr_in	*addr;
 	char *msgid = NULL;
+#ifndef PBS_MOM
+	int rq_type;
+	struct timespec start;
+
+	LAT_START(&start);
+#endif
 
 	if ((addr = tpp_getaddr(stream)) == NULL) {
 		log_event(PBSEVENT_DEBUG, PBS_EVENTCLASS_REQUEST, LOG_DEBUG, "?", "Sender unknown");
@@ -1224,9 +1258,13 @@ process_IS_CMD(int stream)
 				   ATR_DFLAG_SvWR;
 
 	}
-#endif
 
+	rq_type = request->rq_type;	/* request may be freed by dispatch */
+	dispatch_request(stream, request);
+	lat_record(LAT_BATCH, rq_type, &start);
+#else
 	dispatch_request(stream, request);
+#endif
 }
 
 /**
@@ -1660,6 +1698,10 @@ free_br(struct batch_request *preq)
 			if (preq->rq_ind.rq_deletejoblist.rq_jobslist)
 				free_string_array(preq->rq_ind.rq_deletejoblist.rq_jobslist);
 			break;
+		case PBS_BATCH_RunJobList:
+			free_string_array(preq->rq_ind.rq_runjoblist.rq_jobslist);
+			free_string_array(preq->rq_ind.rq_runjoblist.rq_destinlist);
+			break;
 		case PBS_BATCH_CopyFiles:
 		case PBS_BATCH_DelFiles:
 			freebr_cpyfile(&preq->rq_ind.rq_cpyfile);
@@ -69,6 +69,7 @@
 #include "pbs_nodes.h"
 #include "svrfunc.h"
 #include "pbs_db.h"
+#include "svr_latency.h"
 
 
 #ifndef PBS_MOM
@@ -156,7 +157,9 @@ que_save_db(pbs_queue *pque)
 	char *conn_db_err = NULL;
 	int savetype;
 	int rc = -1;
+	struct timespec start;
 
+	LAT_START(&start);
 	if ((savetype = que_to_db(pque, &dbque)) == -1)
 		goto done;
 	
@@ -175,6 +178,7 @@ done:
 		free(conn_db_err);
 		panic_stop_db();
 	}
+	lat_record(LAT_DB_SAVE, LAT_DB_QUEUE, &start);
 	return rc;
 }
 
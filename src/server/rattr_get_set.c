@@ -275,8 +275,10 @@ is_rattr_set(const resc_resv *presv, int attr_idx)
 void
 free_rattr(resc_resv *presv, int attr_idx)
 {
-	if (presv != NULL)
+	if (presv != NULL) {
 		free_attr(resv_attr_def, get_rattr(presv, attr_idx), attr_idx);
+		get_rattr(presv, attr_idx)->at_flags |= ATR_VFLAG_MODCACHE;
+	}
 }
 
 /**
@@ -291,4 +293,5 @@ void
 clear_rattr(resc_resv *presv, int attr_idx)
 {
 	clear_attr(get_rattr(presv, attr_idx), &resv_attr_def[attr_idx]);
+	get_rattr(presv, attr_idx)->at_flags |= ATR_VFLAG_MODCACHE;
 }
@@ -253,6 +253,38 @@ dis_reply_write(int sfds, struct batch_request *preq)
 	return rc;
 }
 
+/**
+ * @brief
+ * 		Record the failure of one job of a RunJobList request in the
+ *		list of per job results of the parent request
+ *
+ * @param[in,out]	preq	- the RunJobList request
+ * @param[in]		jid	- job which failed to run
+ * @param[in]		code	- why it failed
+ *
+ * @return	error code
+ * @retval	0	- success
+ * @retval	PBSE_SYSTEM	- out of memory
+ */
+int
+update_runjoblist_stat(struct batch_request *preq, char *jid, int code)
+{
+	struct batch_deljob_status *pstat;
+
+	pstat = malloc(sizeof(struct batch_deljob_status));
+	if (pstat == NULL || (pstat->name = strdup(jid)) == NULL) {
+		free(pstat);
+		log_err(-1, __func__, "Unable to allocate Memory!\n");
+		return (PBSE_SYSTEM);
+	}
+	pstat->code = code;
+	pstat->next = preq->rq_reply.brp_un.brp_deletejoblist.brp_delstatc;
+	preq->rq_reply.brp_un.brp_deletejoblist.brp_delstatc = pstat;
+	preq->rq_reply.brp_count++;
+
+	return 0;
+}
+
 int
 reply_send_status_part(struct batch_request *preq)
 {
@@ -320,7 +352,12 @@ reply_send(struct batch_request *request)
 
 	/* if this is a child request, just move the error to the parent */
 	if (request->rq_parentbr) {
-		if ((request->rq_parentbr->rq_reply.brp_choice == BATCH_REPLY_CHOICE_NULL) && (request->rq_parentbr->rq_reply.brp_code == 0)) {
+		if (request->rq_parentbr->rq_type == PBS_BATCH_RunJobList) {
+			/* each job of a run job list gets its own status */
+			if (request->rq_reply.brp_code != PBSE_NONE)
+				rc = update_runjoblist_stat(request->rq_parentbr,
+					request->rq_ind.rq_run.rq_jid, request->rq_reply.brp_code);
+		} else if ((request->rq_parentbr->rq_reply.brp_choice == BATCH_REPLY_CHOICE_NULL) && (request->rq_parentbr->rq_reply.brp_code == 0)) {
 			request->rq_parentbr->rq_reply.brp_code = request->rq_reply.brp_code;
 			request->rq_parentbr->rq_reply.brp_auxcode = request->rq_reply.brp_auxcode;
 			if (request->rq_reply.brp_choice == BATCH_REPLY_CHOICE_Text) {
@@ -409,7 +446,7 @@ reply_ack(struct batch_request *preq)
 		return;
 	}
 
-	if (preq->rq_type != PBS_BATCH_DeleteJobList) {
+	if (preq->rq_type != PBS_BATCH_DeleteJobList && preq->rq_type != PBS_BATCH_RunJobList) {
 		if (preq->rq_reply.brp_choice != BATCH_REPLY_CHOICE_NULL)
 			/* in case another reply was being built up, clean it out */
 			reply_free(&preq->rq_reply);
@@ -459,6 +496,7 @@ reply_free(struct batch_reply *prep)
 		while (pstat) {
 			pstatx = (struct brp_status *)GET_NEXT(pstat->brp_stlink);
 			free_attrlist(&pstat->brp_attr);
+			free_brp_blob(pstat->brp_blob);
 			(void)free(pstat);
 			pstat = pstatx;
 		}
@@ -527,7 +565,7 @@ req_reject(int code, int aux, struct batch_request *preq)
 	}
 	set_err_msg(code, msgbuf, ERR_MSG_SIZE);
 	
-	if (preq->rq_type != PBS_BATCH_DeleteJobList) {
+	if (preq->rq_type != PBS_BATCH_DeleteJobList && preq->rq_type != PBS_BATCH_RunJobList) {
 		if (preq->rq_reply.brp_choice != BATCH_REPLY_CHOICE_NULL) {
 			/* in case another reply was being built up, clean it out */
 			reply_free(&preq->rq_reply);
@@ -347,6 +347,7 @@ remove_node_from_resv(resc_resv *presv, struct pbsnode *pnode)
 			else
 				prev->next = rinfp->next;
 			free(rinfp);
+			get_nattr(pnode, ND_ATR_resvs)->at_flags |= ATR_VFLAG_MODCACHE;
 			break;
 		}
 	}
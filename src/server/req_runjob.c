@@ -104,6 +104,7 @@
 #include "provision.h"
 #include "pbs_share.h"
 #include "pbs_sched.h"
+#include "pbs_db.h"
 
 
 /* External Functions Called: */
@@ -695,6 +696,100 @@ req_runjob(struct batch_request *preq)
 		reply_send(preq);
 	return;
 }
+
+/**
+ * @brief
+ * 	req_runjoblist - service the Run Job List Request
+ *
+ * @par
+ *	Each job of the list is run through req_runjob() in a child request
+ *	of type AsyrunJob_ack, so hooks, provisioning and moves to a peer
+ *	server work as for a single job.  reply_send() collects the failure
+ *	of each child into the reply of this request, which goes back to
+ *	the client once every child is done.  The database writes made
+ *	while starting the list are committed in a single transaction.
+ *
+ * @param[in] preq - pointer to batch request structure
+ *
+ * @return void
+ *
+ */
+void
+req_runjoblist(struct batch_request *preq)
+{
+	struct rq_runjoblist *prl = &preq->rq_ind.rq_runjoblist;
+	struct batch_request *pchild;
+	char *jid;
+	char *dest;
+	int in_trx;
+	int i;
+
+	if ((preq->rq_perm & (ATR_DFLAG_MGWR | ATR_DFLAG_OPWR)) == 0) {
+		req_reject(PBSE_PERM, 0, preq);
+		return;
+	}
+
+	preq->rq_reply.brp_choice = BATCH_REPLY_CHOICE_Delete;
+	preq->rq_reply.brp_un.brp_deletejoblist.brp_delstatc = NULL;
+	preq->rq_reply.brp_count = 0;
+
+	/* hold the reply until the whole list has been handed out */
+	++preq->rq_refct;
+
+	in_trx = (pbs_db_begin_trx(svr_db_conn) == 0);
+	if (!in_trx)
+		log_err(-1, __func__, "Unable to start a database transaction, saving jobs one by one");
+
+	for (i = 0; i < prl->rq_count; i++) {
+		jid = prl->rq_jobslist[i];
+		dest = prl->rq_destinlist[i];
+
+		/*
+		 * A list always says where to run each job, there is no
+		 * deferring to the scheduler, and it runs single jobs or
+		 * subjobs only, never a range.
+		 */
+		if ((strlen(jid) > PBS_MAXSVRJOBID) || (*dest == '\0') ||
+		    (is_job_array(jid) == IS_ARRAY_Range)) {
+			update_runjoblist_stat(preq, jid, PBSE_IVALREQ);
+			continue;
+		}
+
+		pchild = alloc_br(PBS_BATCH_AsyrunJob_ack);
+		if (pchild == NULL) {
+			update_runjoblist_stat(preq, jid, PBSE_SYSTEM);
+			continue;
+		}
+		pchild->rq_perm = preq->rq_perm;
+		pchild->rq_fromsvr = preq->rq_fromsvr;
+		pchild->rq_conn = preq->rq_conn;
+		pchild->rq_orgconn = preq->rq_orgconn;
+		pchild->rq_time = preq->rq_time;
+		strcpy(pchild->rq_user, preq->rq_user);
+		strcpy(pchild->rq_host, preq->rq_host);
+		pchild->rq_extend = preq->rq_extend;
+		pchild->rq_reply.brp_choice = BATCH_REPLY_CHOICE_NULL;
+		pbs_strncpy(pchild->rq_ind.rq_run.rq_jid, jid, sizeof(pchild->rq_ind.rq_run.rq_jid));
+		/* owned by the list, children never free it */
+		pchild->rq_ind.rq_run.rq_destin = dest;
+		pchild->rq_parentbr = preq;
+		preq->rq_refct++;
+
+		req_runjob(pchild);
+	}
+
+	if (in_trx && pbs_db_end_trx(svr_db_conn, PBS_DB_COMMIT) != 0) {
+		char *conn_db_err = NULL;
+
+		pbs_db_get_errmsg(PBS_DB_ERR, &conn_db_err);
+		log_errf(PBSE_INTERNAL, __func__, "Failed to commit run job list %s", conn_db_err ? conn_db_err : "");
+		free(conn_db_err);
+		panic_stop_db();
+	}
+
+	if (--preq->rq_refct == 0)
+		reply_send(preq);
+}
 /**
  * @brief
  * 		req_runjob - service the Run Job and Asyc Run Job Requests
@@ -113,6 +113,8 @@ extern pbs_license_counts license_counts;
 
 extern int status_attrib(svrattrl *, void *, attribute_def *, attribute *, int, int, pbs_list_head *, int *);
 extern int status_nodeattrib(svrattrl *, struct pbsnode *, int, int, pbs_list_head *, int *);
+extern int status_blob_find(svrattrl *, struct brp_blob **, attribute_def *, attribute *, int, int, struct brp_status *);
+extern void status_blob_new(struct brp_blob **, attribute_def *, attribute *, int, int, struct brp_status *);
 
 extern int svr_chk_histjob(job *);
 
@@ -527,6 +529,7 @@ status_que(pbs_queue *pque, struct batch_request *preq, pbs_list_head *pstathd)
 	strcpy(pstat->brp_objname, pque->qu_qs.qu_name);
 	CLEAR_LINK(pstat->brp_stlink);
 	CLEAR_HEAD(pstat->brp_attr);
+	pstat->brp_blob = NULL;
 	append_link(pstathd, &pstat->brp_stlink, pstat);
 	preq->rq_reply.brp_count++;
 
@@ -599,10 +602,22 @@ req_stat_node(struct batch_request *preq)
 		rc = status_node(pnode, preq, &preply->brp_un.brp_status);
 
 	} else {			/* get status of all nodes */
-	
+		/*
+		 * Send the status back to TCP clients in parts, as is done
+		 * for jobs, so a large "pbsnodes -av" does not build the
+		 * whole reply in memory before any of it reaches the client.
+		 * Peer servers stat nodes over TPP and expect a single reply.
+		 */
 		for (i = 0; i < svr_totnodes; i++) {
 			pnode = pbsndlist[i];
 
+			if ((preply->brp_count >= MAX_NODES_PER_REPLY) &&
+			    (preq->prot == PROT_TCP) &&
+			    (preq->rq_conn != PBS_LOCAL_CONNECTION)) {
+				rc = reply_send_status_part(preq);
+				if (rc != PBSE_NONE)
+					return;
+			}
 			rc = status_node(pnode, preq,
 				&preply->brp_un.brp_status);
 			if (rc)
@@ -676,6 +691,7 @@ status_node(struct pbsnode *pnode, struct batch_request *preq, pbs_list_head *ps
 	strcpy(pstat->brp_objname, pnode->nd_name);
 	CLEAR_LINK(pstat->brp_stlink);
 	CLEAR_HEAD(pstat->brp_attr);
+	pstat->brp_blob = NULL;
 
 	/*add this new brp_status structure to the list hanging off*/
 	/*the request's reply substructure                         */
@@ -689,7 +705,11 @@ status_node(struct pbsnode *pnode, struct batch_request *preq, pbs_list_head *ps
 	bad = 0;                                        /*global variable*/
 	pal = (svrattrl *)GET_NEXT(preq->rq_ind.rq_status.rq_attr);
 
-	rc = status_nodeattrib(pal, pnode, ND_ATR_LAST, preq->rq_perm, &pstat->brp_attr, &bad);
+	if (!status_blob_find(pal, pnode->nd_statblob, node_attr_def, pnode->nd_attr, ND_ATR_LAST, preq->rq_perm, pstat)) {
+		rc = status_nodeattrib(pal, pnode, ND_ATR_LAST, preq->rq_perm, &pstat->brp_attr, &bad);
+		if ((rc == 0) && (pal == NULL))
+			status_blob_new(pnode->nd_statblob, node_attr_def, pnode->nd_attr, ND_ATR_LAST, preq->rq_perm, pstat);
+	}
 
 	/*reverting back the state*/
 
@@ -780,6 +800,7 @@ req_stat_svr(struct batch_request *preq)
 	strcpy(pstat->brp_objname, server_name);
 	pstat->brp_objtype = MGR_OBJ_SERVER;
 	CLEAR_HEAD(pstat->brp_attr);
+	pstat->brp_blob = NULL;
 	append_link(&preply->brp_un.brp_status, &pstat->brp_stlink, pstat);
 	preply->brp_count++;
 
@@ -887,6 +908,7 @@ status_sched(pbs_sched *psched, struct batch_request *preq, pbs_list_head *pstat
 
 	CLEAR_LINK(pstat->brp_stlink);
 	CLEAR_HEAD(pstat->brp_attr);
+	pstat->brp_blob = NULL;
 	append_link(pstathd, &pstat->brp_stlink, pstat);
 	preq->rq_reply.brp_count++;
 
@@ -1104,6 +1126,7 @@ status_resv(resc_resv *presv, struct batch_request *preq, pbs_list_head *pstathd
 	strcpy(pstat->brp_objname, presv->ri_qs.ri_resvID);
 	CLEAR_LINK(pstat->brp_stlink);
 	CLEAR_HEAD(pstat->brp_attr);
+	pstat->brp_blob = NULL;
 	append_link(pstathd, &pstat->brp_stlink, pstat);
 	preq->rq_reply.brp_count++;
 
@@ -1112,11 +1135,18 @@ status_resv(resc_resv *presv, struct batch_request *preq, pbs_list_head *pstathd
 	bad = 0;	/*global: record ordinal position where got error*/
 	pal = (svrattrl *) GET_NEXT(preq->rq_ind.rq_status.rq_attr);
 
-	if (status_attrib(pal, resv_attr_idx, resv_attr_def, presv->ri_wattr,
-		RESV_ATR_LAST, preq->rq_perm, &pstat->brp_attr, &bad) == 0)
+	if (status_blob_find(pal, presv->ri_statblob, resv_attr_def, presv->ri_wattr,
+		RESV_ATR_LAST, preq->rq_perm, pstat))
 		return (0);
-	else
+
+	if (status_attrib(pal, resv_attr_idx, resv_attr_def, presv->ri_wattr,
+		RESV_ATR_LAST, preq->rq_perm, &pstat->brp_attr, &bad) != 0)
 		return (PBSE_NOATTR);
+
+	if (pal == NULL)
+		status_blob_new(presv->ri_statblob, resv_attr_def, presv->ri_wattr,
+			RESV_ATR_LAST, preq->rq_perm, pstat);
+	return (0);
 }
 
 /**
@@ -1157,6 +1187,7 @@ status_resc(struct resource_def *prd, struct batch_request *preq, pbs_list_head
 	strcpy(pstat->brp_objname, prd->rs_name);
 	CLEAR_LINK(pstat->brp_stlink);
 	CLEAR_HEAD(pstat->brp_attr);
+	pstat->brp_blob = NULL;
 
 	/* add attributes to the status reply */
 	if (private) {
@@ -47,6 +47,8 @@
  *
  * Included funtions are:
  *	svrcached()
+ *	status_blob_find()
+ *	status_blob_new()
  *	status_attrib()
  *	status_job()
  *	status_subjob()
@@ -82,6 +84,9 @@ extern struct server server;
 extern char	     statechars[];
 extern time_t time_now;
 
+/* which of an object's two status blobs serves the given privilege */
+#define STATUS_BLOB_SLOT(priv) (((priv) & (ATR_DFLAG_OPRD | ATR_DFLAG_MGRD)) ? 1 : 0)
+
 /**
  * @brief
  * 		svrcached - either link in (to phead) a cached svrattrl struct which is
@@ -177,6 +182,163 @@ svrcached(attribute *pat, pbs_list_head *phead, attribute_def *pdef)
 	}
 }
 
+/**
+ * @brief
+ * 		attrs_modified - check whether any attribute of an object, or any
+ *		resource entry of one of its resource attributes, was modified
+ *		since the object's status blobs were encoded.
+ *
+ * @param[in]	padef	-	attribute definition array
+ * @param[in]	pattr	-	attribute array of the object
+ * @param[in]	limit	-	number of attributes
+ *
+ * @return	int
+ * @retval	1	: something was modified
+ * @retval	0	: nothing was modified
+ */
+static int
+attrs_modified(attribute_def *padef, attribute *pattr, int limit)
+{
+	int index;
+	resource *presc;
+
+	for (index = 0; index < limit; index++) {
+		if ((pattr + index)->at_flags & ATR_VFLAG_MODCACHE)
+			return 1;
+		if (((padef + index)->at_type != ATR_TYPE_RESC) || !is_attr_set(pattr + index))
+			continue;
+		for (presc = (resource *)GET_NEXT((pattr + index)->at_val.at_list); presc;
+			presc = (resource *)GET_NEXT(presc->rs_link)) {
+			if (presc->rs_value.at_flags & ATR_VFLAG_MODCACHE)
+				return 1;
+		}
+	}
+	return 0;
+}
+
+/**
+ * @brief
+ * 		attrs_mark_encoded - clear the modified-since-cache flag of every
+ *		attribute and resource entry of an object once its status blob
+ *		has been built.
+ *
+ * @par
+ *		Attributes which svrcached() did not re-encode (not set or not
+ *		readable at this privilege) still carry their old cached svrattrl,
+ *		which is dropped here so that clearing the flag cannot make
+ *		svrcached() reuse it.
+ *
+ * @param[in]		padef	-	attribute definition array
+ * @param[in,out]	pattr	-	attribute array of the object
+ * @param[in]		limit	-	number of attributes
+ *
+ * @return	void
+ */
+static void
+attrs_mark_encoded(attribute_def *padef, attribute *pattr, int limit)
+{
+	int index;
+	resource *presc;
+
+	for (index = 0; index < limit; index++) {
+		if ((pattr + index)->at_flags & ATR_VFLAG_MODCACHE) {
+			free_svrcache(pattr + index);
+			(pattr + index)->at_flags &= ~ATR_VFLAG_MODCACHE;
+		}
+		if (((padef + index)->at_type != ATR_TYPE_RESC) || !is_attr_set(pattr + index))
+			continue;
+		for (presc = (resource *)GET_NEXT((pattr + index)->at_val.at_list); presc;
+			presc = (resource *)GET_NEXT(presc->rs_link))
+			presc->rs_value.at_flags &= ~ATR_VFLAG_MODCACHE;
+	}
+}
+
+/**
+ * @brief
+ * 		status_blob_find - drop an object's status blobs if any of its
+ *		attributes changed, otherwise link the blob for the requester's
+ *		privilege into the status reply entry.
+ *
+ * @par
+ *		Must be called for every status of the object, including ones for
+ *		specific attributes, as svrcached() clears the modified flags that
+ *		tell whether the blobs are stale.
+ *
+ * @param[in]		pal	-	specific attributes to status, if any
+ * @param[in,out]	cache	-	the object's two status blobs
+ * @param[in]		padef	-	attribute definition array
+ * @param[in]		pattr	-	attribute array of the object
+ * @param[in]		limit	-	number of attributes
+ * @param[in]		priv	-	user-client privilege
+ * @param[in,out]	pstat	-	status reply entry for the object
+ *
+ * @return	int
+ * @retval	1	: blob linked in, attribute list need not be built
+ * @retval	0	: caller must build the attribute list
+ */
+int
+status_blob_find(svrattrl *pal, struct brp_blob **cache, attribute_def *padef, attribute *pattr, int limit, int priv, struct brp_status *pstat)
+{
+	struct brp_blob *blob;
+	int i;
+
+	if (attrs_modified(padef, pattr, limit)) {
+		for (i = 0; i < 2; i++) {
+			free_brp_blob(cache[i]);
+			cache[i] = NULL;
+		}
+		return 0;
+	}
+	if ((pal != NULL) || (get_sattr_long(SVR_ATR_show_hidden_attribs) != 0))
+		return 0;
+
+	priv &= (ATR_DFLAG_RDACC | ATR_DFLAG_SvWR);
+	blob = cache[STATUS_BLOB_SLOT(priv)];
+	if ((blob == NULL) || (blob->bb_len == 0) || (blob->bb_perm != priv))
+		return 0;
+
+	blob->bb_refct++;
+	pstat->brp_blob = blob;
+	return 1;
+}
+
+/**
+ * @brief
+ * 		status_blob_new - after the full attribute list of an object was
+ *		built into a status reply entry, attach a new empty blob to both
+ *		the entry and the object; encode_DIS_reply() fills it in.
+ *
+ * @param[in,out]	cache	-	the object's two status blobs
+ * @param[in]		padef	-	attribute definition array
+ * @param[in,out]	pattr	-	attribute array of the object
+ * @param[in]		limit	-	number of attributes
+ * @param[in]		priv	-	user-client privilege
+ * @param[in,out]	pstat	-	status reply entry for the object
+ *
+ * @return	void
+ */
+void
+status_blob_new(struct brp_blob **cache, attribute_def *padef, attribute *pattr, int limit, int priv, struct brp_status *pstat)
+{
+	struct brp_blob *blob;
+	int slot;
+
+	if (get_sattr_long(SVR_ATR_show_hidden_attribs) != 0)
+		return;
+	if ((blob = calloc(1, sizeof(struct brp_blob))) == NULL)
+		return;
+
+	attrs_mark_encoded(padef, pattr, limit);
+
+	priv &= (ATR_DFLAG_RDACC | ATR_DFLAG_SvWR);
+	blob->bb_perm = priv;
+	blob->bb_refct = 2;
+	slot = STATUS_BLOB_SLOT(priv);
+	free_brp_blob(cache[slot]);
+	cache[slot] = blob;
+	pstat->brp_blob = blob;
+}
+
 /*
  * status_attrib - add each requested or all attributes to the status reply
  *
@@ -292,6 +454,7 @@ status_job(job *pjob, struct batch_request *preq, svrattrl *pal, pbs_list_head *
 		pstat->brp_objtype = MGR_OBJ_JOB;
 	(void)strcpy(pstat->brp_objname, pjob->ji_qs.ji_jobid);
 	CLEAR_HEAD(pstat->brp_attr);
+	pstat->brp_blob = NULL;
 	append_link(pstathd, &pstat->brp_stlink, pstat);
 	preq->rq_reply.brp_count++;
 
@@ -403,6 +566,7 @@ status_subjob(job *pjob, struct batch_request *preq, svrattrl *pal, int subj, pb
 		pstat->brp_objtype = MGR_OBJ_JOB;
 	(void)strcpy(pstat->brp_objname, objname);
 	CLEAR_HEAD(pstat->brp_attr);
+	pstat->brp_blob = NULL;
 	append_link(pstathd, &pstat->brp_stlink, pstat);
 	preq->rq_reply.brp_count++;
 
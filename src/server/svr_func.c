@@ -6551,6 +6551,7 @@ unset_jobscript_max_size(void)
  */
 extern char *msg_script_open;
 extern char *msg_script_write;
+extern char *msg_err_malloc;
 extern char *path_spool;
 
 /*
@@ -6559,6 +6560,10 @@ extern char *path_spool;
  *  	It populates the ji_script field of the job as well as returns
  *      a pointer to the script
  *
+ *	All subjobs of an array share the script of their parent, so the
+ *	parent keeps the script once loaded and each subjob gets a copy of
+ *	it instead of reading it from the database again.
+ *
  * @param[in, out] pj - Job pointer. pj->ji_script has the script loaded into it.
  *
  * @return Text buffer containing the job script
@@ -6572,6 +6577,7 @@ svr_load_jobscript(job *pj)
 	void *conn = (void *) svr_db_conn;
 	pbs_db_jobscr_info_t jobscr;
 	pbs_db_obj_info_t obj;
+	job *parent = NULL;
 
 	if (pj->ji_script) {
 		free(pj->ji_script);
@@ -6579,7 +6585,15 @@ svr_load_jobscript(job *pj)
 	}
 
 	if (pj->ji_qs.ji_svrflags & JOB_SVFLG_SubJob) {
-		strcpy(jobscr.ji_jobid, pj->ji_parentaj->ji_qs.ji_jobid);
+		parent = pj->ji_parentaj;
+		if (parent->ji_script) {
+			if ((pj->ji_script = strdup(parent->ji_script)) == NULL) {
+				log_err(errno, __func__, msg_err_malloc);
+				return NULL;
+			}
+			return pj->ji_script;
+		}
+		strcpy(jobscr.ji_jobid, parent->ji_qs.ji_jobid);
 	} else {
 		strcpy(jobscr.ji_jobid, pj->ji_qs.ji_jobid);
 	}
@@ -6603,6 +6617,16 @@ svr_load_jobscript(job *pj)
 		return NULL;
 	}
 
+	if (parent) {
+		if ((pj->ji_script = strdup(jobscr.script)) == NULL) {
+			log_err(errno, __func__, msg_err_malloc);
+			free(jobscr.script);
+			return NULL;
+		}
+		parent->ji_script = jobscr.script;
+		return pj->ji_script;
+	}
+
 	pj->ji_script = jobscr.script;
 
 	return jobscr.script;
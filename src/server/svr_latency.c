@@ -0,0 +1,425 @@
+/*
+ * Copyright (C) 1994-2021 Altair Engineering, Inc.
+ * For more information, contact Altair at www.altair.com.
+ *
+ * This file is part of both the OpenPBS software ("OpenPBS")
+ * and the PBS Professional ("PBS Pro") software.
+ *
+ * Open Source License Information:
+ *
+ * OpenPBS is free software. You can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * OpenPBS is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Commercial License Information:
+ *
+ * PBS Pro is commercially licensed software that shares a common core with
+ * the OpenPBS software.  For a copy of the commercial license terms and
+ * conditions, go to: (http://www.pbspro.com/agreement.html) or contact the
+ * Altair Legal Department.
+ *
+ * Altair's dual-license business model allows companies, individuals, and
+ * organizations to create proprietary derivative works of OpenPBS and
+ * distribute them - whether embedded or bundled with other software -
+ * under a commercial license agreement.
+ *
+ * Use of Altair's trademarks, including but not limited to "PBS™",
+ * "OpenPBS®", "PBS Professional®", and "PBS Pro™" and Altair's logos is
+ * subject to Altair's trademark licensing policies.
+ */
+
+/**
+ * @file	svr_latency.c
+ *
+ * @brief
+ * 		svr_latency.c - service time histograms of the server main loop
+ *
+ *	The time the main loop spends on each batch request, on each message
+ *	from a MoM, on database saves and on hook runs is counted in a fixed
+ *	size histogram per request type with power of two buckets, so
+ *	recording one costs a clock read and a few adds.  Every
+ *	LAT_DUMP_INTERVAL seconds the types seen since the last dump are
+ *	logged and the totals since start are written to PBS_SVRMETRICS in
+ *	server_priv in the Prometheus text format.
+ *
+ * Functions included are:
+ * 	lat_add()
+ * 	lat_record()
+ * 	lat_dump()
+ *
+ */
+#include <pbs_config.h>   /* the master config generated by configure */
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "libpbs.h"
+#include "net_connect.h"
+#include "server_limits.h"
+#include "log.h"
+#include "work_task.h"
+#include "svr_latency.h"
+
+extern time_t time_now;
+
+struct lat_hist {
+	unsigned long	lh_count;		/* number of times recorded */
+	unsigned long	lh_sum;			/* total usecs */
+	unsigned long	lh_max;			/* longest usecs */
+	unsigned long	lh_bucket[LAT_BUCKETS];
+};
+
+/* since the last dump, only these are touched when recording */
+static struct lat_hist lat_interval[LAT_CLASS_HIGH][LAT_MAX_TYPE];
+/* since the server started, folded in from lat_interval at each dump */
+static struct lat_hist lat_total[LAT_CLASS_HIGH][LAT_MAX_TYPE];
+
+static const char *lat_class_names[LAT_CLASS_HIGH] = {
+	"batch",
+	"is",
+	"db_save",
+	"hook"
+};
+
+static const char *batch_names[LAT_MAX_TYPE] = {
+	[PBS_BATCH_Connect] = "Connect",
+	[PBS_BATCH_QueueJob] = "QueueJob",
+	[PBS_BATCH_jobscript] = "jobscript",
+	[PBS_BATCH_RdytoCommit] = "RdytoCommit",
+	[PBS_BATCH_Commit] = "Commit",
+	[PBS_BATCH_DeleteJob] = "DeleteJob",
+	[PBS_BATCH_HoldJob] = "HoldJob",
+	[PBS_BATCH_LocateJob] = "LocateJob",
+	[PBS_BATCH_Manager] = "Manager",
+	[PBS_BATCH_MessJob] = "MessJob",
+	[PBS_BATCH_ModifyJob] = "ModifyJob",
+	[PBS_BATCH_MoveJob] = "MoveJob",
+	[PBS_BATCH_ReleaseJob] = "ReleaseJob",
+	[PBS_BATCH_Rerun] = "Rerun",
+	[PBS_BATCH_RunJob] = "RunJob",
+	[PBS_BATCH_SelectJobs] = "SelectJobs",
+	[PBS_BATCH_Shutdown] = "Shutdown",
+	[PBS_BATCH_SignalJob] = "SignalJob",
+	[PBS_BATCH_StatusJob] = "StatusJob",
+	[PBS_BATCH_StatusQue] = "StatusQue",
+	[PBS_BATCH_StatusSvr] = "StatusSvr",
+	[PBS_BATCH_TrackJob] = "TrackJob",
+	[PBS_BATCH_AsyrunJob] = "AsyrunJob",
+	[PBS_BATCH_Rescq] = "Rescq",
+	[PBS_BATCH_ReserveResc] = "ReserveResc",
+	[PBS_BATCH_ReleaseResc] = "ReleaseResc",
+	[PBS_BATCH_FailOver] = "FailOver",
+	[PBS_BATCH_StageIn] = "StageIn",
+	[PBS_BATCH_OrderJob] = "OrderJob",
+	[PBS_BATCH_SelStat] = "SelStat",
+	[PBS_BATCH_RegistDep] = "RegistDep",
+	[PBS_BATCH_CopyFiles] = "CopyFiles",
+	[PBS_BATCH_DelFiles] = "DelFiles",
+	[PBS_BATCH_JobObit] = "JobObit",
+	[PBS_BATCH_MvJobFile] = "MvJobFile",
+	[PBS_BATCH_StatusNode] = "StatusNode",
+	[PBS_BATCH_Disconnect] = "Disconnect",
+	[PBS_BATCH_JobCred] = "JobCred",
+	[PBS_BATCH_CopyFiles_Cred] = "CopyFiles_Cred",
+	[PBS_BATCH_DelFiles_Cred] = "DelFiles_Cred",
+	[PBS_BATCH_SubmitResv] = "SubmitResv",
+	[PBS_BATCH_StatusResv] = "StatusResv",
+	[PBS_BATCH_DeleteResv] = "DeleteResv",
+	[PBS_BATCH_UserCred] = "UserCred",
+	[PBS_BATCH_ConfirmResv] = "ConfirmResv",
+	[PBS_BATCH_DefSchReply] = "DefSchReply",
+	[PBS_BATCH_StatusSched] = "StatusSched",
+	[PBS_BATCH_StatusRsc] = "StatusRsc",
+	[PBS_BATCH_StatusHook] = "StatusHook",
+	[PBS_BATCH_PySpawn] = "PySpawn",
+	[PBS_BATCH_CopyHookFile] = "CopyHookFile",
+	[PBS_BATCH_DelHookFile] = "DelHookFile",
+	[PBS_BATCH_HookPeriodic] = "HookPeriodic",
+	[PBS_BATCH_RelnodesJob] = "RelnodesJob",
+	[PBS_BATCH_ModifyResv] = "ModifyResv",
+	[PBS_BATCH_ResvOccurEnd] = "ResvOccurEnd",
+	[PBS_BATCH_PreemptJobs] = "PreemptJobs",
+	[PBS_BATCH_Cred] = "Cred",
+	[PBS_BATCH_Authenticate] = "Authenticate",
+	[PBS_BATCH_ModifyJob_Async] = "ModifyJob_Async",
+	[PBS_BATCH_AsyrunJob_ack] = "AsyrunJob_ack",
+	[PBS_BATCH_RegisterSched] = "RegisterSched",
+	[PBS_BATCH_ModifyVnode] = "ModifyVnode",
+	[PBS_BATCH_DeleteJobList] = "DeleteJobList",
+	[PBS_BATCH_ServerReady] = "ServerReady",
+	[PBS_BATCH_RunJobList] = "RunJobList"
+};
+
+static const char *is_names[LAT_MAX_TYPE] = {
+	[IS_NULL] = "NULL",
+	[IS_CMD] = "CMD",
+	[IS_CMD_REPLY] = "CMD_REPLY",
+	[IS_CLUSTER_ADDRS] = "CLUSTER_ADDRS",
+	[IS_UPDATE] = "UPDATE",
+	[IS_RESCUSED] = "RESCUSED",
+	[IS_JOBOBIT] = "JOBOBIT",
+	[IS_OBITREPLY] = "OBITREPLY",
+	[IS_REPLYHELLO] = "REPLYHELLO",
+	[IS_SHUTDOWN] = "SHUTDOWN",
+	[IS_IDLE] = "IDLE",
+	[IS_REGISTERMOM] = "REGISTERMOM",
+	[IS_UPDATE2] = "UPDATE2",
+	[IS_DISCARD_JOB] = "DISCARD_JOB",
+	[IS_DISCARD_DONE] = "DISCARD_DONE",
+	[IS_UPDATE_FROM_HOOK] = "UPDATE_FROM_HOOK",
+	[IS_RESCUSED_FROM_HOOK] = "RESCUSED_FROM_HOOK",
+	[IS_HOOK_JOB_ACTION] = "HOOK_JOB_ACTION",
+	[IS_HOOK_ACTION_ACK] = "HOOK_ACTION_ACK",
+	[IS_HOOK_SCHEDULER_RESTART_CYCLE] = "HOOK_SCHEDULER_RESTART_CYCLE",
+	[IS_HOOK_CHECKSUMS] = "HOOK_CHECKSUMS",
+	[IS_UPDATE_FROM_HOOK2] = "UPDATE_FROM_HOOK2",
+	[IS_HELLOSVR] = "HELLOSVR"
+};
+
+static const char *db_names[LAT_MAX_TYPE] = {
+	[LAT_DB_JOB] = "job",
+	[LAT_DB_RESV] = "resv",
+	[LAT_DB_NODE] = "node",
+	[LAT_DB_QUEUE] = "queue",
+	[LAT_DB_SVR] = "server"
+};
+
+/**
+ * @brief
+ *		name of a type of a class for the log and the metrics file
+ *
+ * @param[in]	cls	-	class of the type
+ * @param[in]	type	-	the type
+ * @param[out]	buf	-	buffer for the number of an unnamed type
+ * @param[in]	len	-	size of buf
+ *
+ * @return	const char *
+ */
+static const char *
+lat_type_name(enum lat_class cls, int type, char *buf, size_t len)
+{
+	const char *name;
+
+	switch (cls) {
+		case LAT_IS:
+			name = is_names[type];
+			break;
+		case LAT_DB_SAVE:
+			name = db_names[type];
+			break;
+		default:
+			name = batch_names[type];
+			break;
+	}
+	if (name == NULL) {
+		snprintf(buf, len, "%d", type);
+		name = buf;
+	}
+	return name;
+}
+
+/**
+ * @brief
+ *		lat_add - count a service time in the histogram of a type
+ *
+ * @param[in]	cls	-	class of the type
+ * @param[in]	type	-	PBS_BATCH_*, IS_* or LAT_DB_* type, depending on cls
+ * @param[in]	usecs	-	time taken
+ *
+ * @return	void
+ */
+void
+lat_add(enum lat_class cls, int type, unsigned long usecs)
+{
+	struct lat_hist *lh;
+	unsigned long v;
+	int b;
+
+	if ((type < 0) || (type >= LAT_MAX_TYPE))
+		return;
+	lh = &lat_interval[cls][type];
+
+	for (b = 0, v = usecs; (v != 0) && (b < LAT_BUCKETS - 1); v >>= 1)
+		b++;
+	lh->lh_bucket[b]++;
+	lh->lh_count++;
+	lh->lh_sum += usecs;
+	if (usecs > lh->lh_max)
+		lh->lh_max = usecs;
+}
+
+/**
+ * @brief
+ *		lat_since - time elapsed since start
+ *
+ * @param[in]	start	-	time taken with LAT_START()
+ *
+ * @return	unsigned long
+ * @retval	usecs since start
+ */
+unsigned long
+lat_since(const struct timespec *start)
+{
+	struct timespec now;
+	long usecs;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	usecs = (now.tv_sec - start->tv_sec) * 1000000L +
+		(now.tv_nsec - start->tv_nsec) / 1000;
+	return (usecs > 0 ? (unsigned long)usecs : 0);
+}
+
+/**
+ * @brief
+ *		lat_record - count the time since start in the histogram of a type
+ *
+ * @param[in]	cls	-	class of the type
+ * @param[in]	type	-	PBS_BATCH_*, IS_* or LAT_DB_* type, depending on cls
+ * @param[in]	start	-	time taken with LAT_START()
+ *
+ * @return	void
+ */
+void
+lat_record(enum lat_class cls, int type, const struct timespec *start)
+{
+	lat_add(cls, type, lat_since(start));
+}
+
+/**
+ * @brief
+ *		upper bound in usecs of the bucket holding a quantile
+ *
+ * @param[in]	lh	-	histogram
+ * @param[in]	q	-	quantile, 0 < q <= 1
+ *
+ * @return	unsigned long
+ */
+static unsigned long
+lat_quantile(const struct lat_hist *lh, double q)
+{
+	unsigned long want = (unsigned long)(q * lh->lh_count + 0.5);
+	unsigned long seen = 0;
+	int b;
+
+	for (b = 0; b < LAT_BUCKETS - 1; b++) {
+		seen += lh->lh_bucket[b];
+		if (seen >= want)
+			break;
+	}
+	return (b == LAT_BUCKETS - 1) ? lh->lh_max : (1UL << b);
+}
+
+/**
+ * @brief
+ *		write the histograms since start to PBS_SVRMETRICS
+ *
+ * @return	void
+ */
+static void
+lat_write_metrics(void)
+{
+	const char *tmpfile = PBS_SVRMETRICS ".new";
+	char numbuf[16];
+	const char *name;
+	struct lat_hist *lh;
+	unsigned long cum;
+	FILE *fp;
+	int c, t, b;
+
+	if ((fp = fopen(tmpfile, "w")) == NULL) {
+		log_eventf(PBSEVENT_DEBUG2, PBS_EVENTCLASS_FILE, LOG_DEBUG, PBS_SVRMETRICS,
+			"Unable to open %s: %s", tmpfile, strerror(errno));
+		return;
+	}
+
+	fprintf(fp, "# HELP pbs_server_service_seconds Time the server main loop spent on a request, message, save or hook run.\n");
+	fprintf(fp, "# TYPE pbs_server_service_seconds histogram\n");
+	for (c = 0; c < LAT_CLASS_HIGH; c++) {
+		for (t = 0; t < LAT_MAX_TYPE; t++) {
+			lh = &lat_total[c][t];
+			if (lh->lh_count == 0)
+				continue;
+			name = lat_type_name(c, t, numbuf, sizeof(numbuf));
+			cum = 0;
+			for (b = 0; b < LAT_BUCKETS - 1; b++) {
+				cum += lh->lh_bucket[b];
+				fprintf(fp, "pbs_server_service_seconds_bucket{class=\"%s\",type=\"%s\",le=\"%g\"} %lu\n",
+					lat_class_names[c], name, (double)(1UL << b) / 1000000, cum);
+			}
+			fprintf(fp, "pbs_server_service_seconds_bucket{class=\"%s\",type=\"%s\",le=\"+Inf\"} %lu\n",
+				lat_class_names[c], name, lh->lh_count);
+			fprintf(fp, "pbs_server_service_seconds_sum{class=\"%s\",type=\"%s\"} %.6f\n",
+				lat_class_names[c], name, (double)lh->lh_sum / 1000000);
+			fprintf(fp, "pbs_server_service_seconds_count{class=\"%s\",type=\"%s\"} %lu\n",
+				lat_class_names[c], name, lh->lh_count);
+		}
+	}
+
+	if (fclose(fp) != 0 || rename(tmpfile, PBS_SVRMETRICS) != 0) {
+		log_eventf(PBSEVENT_DEBUG2, PBS_EVENTCLASS_FILE, LOG_DEBUG, PBS_SVRMETRICS,
+			"Unable to write %s: %s", PBS_SVRMETRICS, strerror(errno));
+		unlink(tmpfile);
+	}
+}
+
+/**
+ * @brief
+ *		lat_dump - log the service times of the types seen since the last
+ *		dump, add them to the totals and write those to PBS_SVRMETRICS.
+ *		Reschedules itself every LAT_DUMP_INTERVAL seconds.
+ *
+ * @param[in]	ptask	-	pointer to the work task, NULL if called directly
+ *
+ * @return	void
+ */
+void
+lat_dump(struct work_task *ptask)
+{
+	char numbuf[16];
+	struct lat_hist *lh;
+	struct lat_hist *tot;
+	int logit;
+	int c, t, b;
+
+	if (ptask)
+		(void)set_task(WORK_Timed, time_now + LAT_DUMP_INTERVAL, lat_dump, NULL);
+
+	logit = will_log_event(PBSEVENT_DEBUG2);
+	for (c = 0; c < LAT_CLASS_HIGH; c++) {
+		for (t = 0; t < LAT_MAX_TYPE; t++) {
+			lh = &lat_interval[c][t];
+			if (lh->lh_count == 0)
+				continue;
+			if (logit)
+				log_eventf(PBSEVENT_DEBUG2, PBS_EVENTCLASS_SERVER, LOG_DEBUG, "svr_latency",
+					"%s %s: count=%lu avg=%.3fms p50<=%.3fms p99<=%.3fms max=%.3fms",
+					lat_class_names[c], lat_type_name(c, t, numbuf, sizeof(numbuf)),
+					lh->lh_count, (double)lh->lh_sum / lh->lh_count / 1000,
+					(double)lat_quantile(lh, 0.5) / 1000,
+					(double)lat_quantile(lh, 0.99) / 1000,
+					(double)lh->lh_max / 1000);
+
+			tot = &lat_total[c][t];
+			tot->lh_count += lh->lh_count;
+			tot->lh_sum += lh->lh_sum;
+			if (lh->lh_max > tot->lh_max)
+				tot->lh_max = lh->lh_max;
+			for (b = 0; b < LAT_BUCKETS; b++)
+				tot->lh_bucket[b] += lh->lh_bucket[b];
+			memset(lh, 0, sizeof(*lh));
+		}
+	}
+
+	lat_write_metrics();
+}
@@ -73,6 +73,7 @@
 #include "pbs_db.h"
 #include "pbs_sched.h"
 #include "pbs_share.h"
+#include "svr_latency.h"
 
 /* Global Data Items: */
 
@@ -263,7 +264,9 @@ svr_save_db(struct server *ps)
 	int savetype;
 	int rc = -1;
 	char *conn_db_err = NULL;
+	struct timespec start;
 
+	LAT_START(&start);
 	/* as part of the server save, update svrlive file now,
 	 * used in failover
 	 */
@@ -289,6 +292,7 @@ done:
 		free(conn_db_err);
 	}
 
+	lat_record(LAT_DB_SAVE, LAT_DB_SVR, &start);
 	return (rc);
 }
 
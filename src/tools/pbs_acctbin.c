@@ -0,0 +1,246 @@
+/*
+ * Copyright (C) 1994-2021 Altair Engineering, Inc.
+ * For more information, contact Altair at www.altair.com.
+ *
+ * This file is part of both the OpenPBS software ("OpenPBS")
+ * and the PBS Professional ("PBS Pro") software.
+ *
+ * Open Source License Information:
+ *
+ * OpenPBS is free software. You can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * OpenPBS is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Commercial License Information:
+ *
+ * PBS Pro is commercially licensed software that shares a common core with
+ * the OpenPBS software.  For a copy of the commercial license terms and
+ * conditions, go to: (http://www.pbspro.com/agreement.html) or contact the
+ * Altair Legal Department.
+ *
+ * Altair's dual-license business model allows companies, individuals, and
+ * organizations to create proprietary derivative works of OpenPBS and
+ * distribute them - whether embedded or bundled with other software -
+ * under a commercial license agreement.
+ *
+ * Use of Altair's trademarks, including but not limited to "PBS™",
+ * "OpenPBS®", "PBS Professional®", and "PBS Pro™" and Altair's logos is
+ * subject to Altair's trademark licensing policies.
+ */
+
+
+/**
+ * @file	pbs_acctbin.c
+ *
+ * @brief
+ *	pbs_acctbin - print the records of a binary accounting log as lines
+ *	of the text accounting log, optionally only those of one job or
+ *	reservation and of a time range.  The index next to the log is used
+ *	to find the records when it is there, else the log is read through.
+ *
+ *	pbs_acctbin [-j id] [-s start] [-e end] log
+ */
+#include <pbs_config.h>   /* the master config generated by configure */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <limits.h>
+#include "pbs_version.h"
+#include "pbs_internal.h"
+#include "acct_bin.h"
+
+static char *id = NULL;		/* -j, only records of this id */
+static unsigned int idhash;
+static time_t start = 0;	/* -s, only records at or after */
+static time_t end = 0;		/* -e, only records at or before */
+
+static char *recbuf = NULL;
+static size_t recbufsz = 0;
+
+/**
+ * @brief
+ *	match - check a record or an index entry against the filters
+ *
+ * @param[in]	t	- time of the record
+ * @param[in]	rid	- id of the record, NULL to skip the id check
+ *
+ * @return	int
+ * @retval	1	- wanted
+ * @retval	0	- not wanted
+ */
+static int
+match(time_t t, const char *rid)
+{
+	if (start != 0 && t < start)
+		return 0;
+	if (end != 0 && t > end)
+		return 0;
+	if (id != NULL && rid != NULL && strcmp(id, rid) != 0)
+		return 0;
+	return 1;
+}
+
+/**
+ * @brief
+ *	print_indexed - print the wanted records by way of the index
+ *
+ * @param[in]	binfp	- binary log
+ * @param[in]	idxfp	- its index, past the header
+ * @param[in]	path	- name of the binary log, for messages
+ *
+ * @return	int
+ * @retval	0	- success
+ * @retval	1	- error
+ */
+static int
+print_indexed(FILE *binfp, FILE *idxfp, char *path)
+{
+	struct acct_idx_ent ent;
+	struct acct_bin_rec rec;
+
+	while (acct_idx_read(idxfp, &ent) == 1) {
+		if (!match(ent.ai_time, NULL))
+			continue;
+		if (id != NULL && ent.ai_idhash != idhash)
+			continue;
+		if (fseeko(binfp, (off_t)ent.ai_offset, SEEK_SET) != 0 ||
+			acct_bin_read(binfp, &rec, &recbuf, &recbufsz) != 1) {
+			fprintf(stderr, "pbs_acctbin: %s: bad record at offset %lld\n",
+				path, ent.ai_offset);
+			return 1;
+		}
+		if (match(rec.ab_time, rec.ab_id) && acct_bin_to_text(&rec, stdout) == -1)
+			return 1;
+	}
+	return 0;
+}
+
+/**
+ * @brief
+ *	print_all - print the wanted records reading through the log
+ *
+ * @param[in]	binfp	- binary log, past the header
+ * @param[in]	path	- name of the binary log, for messages
+ *
+ * @return	int
+ * @retval	0	- success
+ * @retval	1	- error
+ */
+static int
+print_all(FILE *binfp, char *path)
+{
+	struct acct_bin_rec rec;
+	int rc;
+
+	while ((rc = acct_bin_read(binfp, &rec, &recbuf, &recbufsz)) == 1) {
+		if (match(rec.ab_time, rec.ab_id) && acct_bin_to_text(&rec, stdout) == -1)
+			return 1;
+	}
+	if (rc == -1) {
+		fprintf(stderr, "pbs_acctbin: %s: bad record at offset %lld\n",
+			path, (long long)ftello(binfp));
+		return 1;
+	}
+	return 0;
+}
+
+/**
+ * @brief
+ *	main - the entry point of pbs_acctbin
+ *
+ * @return	int
+ * @retval	0	- success
+ * @retval	1	- the log could not be read
+ * @retval	2	- usage error
+ */
+int
+main(int argc, char *argv[])
+{
+	char binpath[_POSIX_PATH_MAX];
+	char idxpath[_POSIX_PATH_MAX];
+	FILE *binfp;
+	FILE *idxfp;
+	size_t len;
+	int errflg = 0;
+	int rc;
+	int c;
+
+	/*the real deal or output pbs_version and exit?*/
+	PRINT_VERSION_AND_EXIT(argc, argv);
+
+	while ((c = getopt(argc, argv, "j:s:e:")) != EOF) {
+		switch (c) {
+			case 'j':
+				id = optarg;
+				idhash = acct_bin_idhash(id);
+				break;
+			case 's':
+				if ((start = cvtdate(optarg)) < 0)
+					errflg++;
+				break;
+			case 'e':
+				if ((end = cvtdate(optarg)) < 0)
+					errflg++;
+				break;
+			default:
+				errflg++;
+		}
+	}
+	if (errflg || optind != argc - 1) {
+		fprintf(stderr, "usage: pbs_acctbin [-j id] [-s [[CC]YY]MMDDhhmm[.SS]] "
+			"[-e [[CC]YY]MMDDhhmm[.SS]] log\n");
+		fprintf(stderr, "       pbs_acctbin --version\n");
+		return 2;
+	}
+
+	/* accept the log with or without its suffix */
+	len = strlen(argv[optind]);
+	if (len > sizeof(ACCT_BIN_SUFFIX) - 1 &&
+		strcmp(argv[optind] + len - (sizeof(ACCT_BIN_SUFFIX) - 1), ACCT_BIN_SUFFIX) == 0)
+		len -= sizeof(ACCT_BIN_SUFFIX) - 1;
+	if (len + sizeof(ACCT_BIN_SUFFIX) > sizeof(binpath)) {
+		fprintf(stderr, "pbs_acctbin: %s: name too long\n", argv[optind]);
+		return 2;
+	}
+	snprintf(binpath, sizeof(binpath), "%.*s%s", (int)len, argv[optind], ACCT_BIN_SUFFIX);
+	snprintf(idxpath, sizeof(idxpath), "%.*s%s", (int)len, argv[optind], ACCT_IDX_SUFFIX);
+
+	if ((binfp = fopen(binpath, "r")) == NULL) {
+		fprintf(stderr, "pbs_acctbin: %s: %s\n", binpath, strerror(errno));
+		return 1;
+	}
+	if (acct_bin_check_magic(binfp, ACCT_BIN_MAGIC) != 0) {
+		fprintf(stderr, "pbs_acctbin: %s: not a binary accounting log\n", binpath);
+		fclose(binfp);
+		return 1;
+	}
+
+	idxfp = fopen(idxpath, "r");
+	if (idxfp != NULL && acct_bin_check_magic(idxfp, ACCT_IDX_MAGIC) != 0) {
+		fclose(idxfp);
+		idxfp = NULL;
+	}
+	if (idxfp != NULL) {
+		rc = print_indexed(binfp, idxfp, binpath);
+		fclose(idxfp);
+	} else
+		rc = print_all(binfp, binpath);
+
+	fclose(binfp);
+	if (fflush(stdout) != 0)
+		rc = 1;
+	free(recbuf);
+	return rc;
+}
@@ -0,0 +1,191 @@
+/*
+ * Copyright (C) 1994-2021 Altair Engineering, Inc.
+ * For more information, contact Altair at www.altair.com.
+ *
+ * This file is part of both the OpenPBS software ("OpenPBS")
+ * and the PBS Professional ("PBS Pro") software.
+ *
+ * Open Source License Information:
+ *
+ * OpenPBS is free software. You can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * OpenPBS is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Commercial License Information:
+ *
+ * PBS Pro is commercially licensed software that shares a common core with
+ * the OpenPBS software.  For a copy of the commercial license terms and
+ * conditions, go to: (http://www.pbspro.com/agreement.html) or contact the
+ * Altair Legal Department.
+ *
+ * Altair's dual-license business model allows companies, individuals, and
+ * organizations to create proprietary derivative works of OpenPBS and
+ * distribute them - whether embedded or bundled with other software -
+ * under a commercial license agreement.
+ *
+ * Use of Altair's trademarks, including but not limited to "PBS™",
+ * "OpenPBS®", "PBS Professional®", and "PBS Pro™" and Altair's logos is
+ * subject to Altair's trademark licensing policies.
+ */
+
+/*
+ * pbs_idx_bench - compare AVL and hash backed pbs_idx on job id keys
+ *
+ * usage: pbs_idx_bench [-n number_of_keys]
+ *
+ * Inserts, finds (hit and miss) and deletes job id style keys in an
+ * index of each kind and prints the time taken per phase.
+ */
+
+#include <pbs_config.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/time.h>
+#include "pbs_idx.h"
+
+#define BENCH_DFLT_KEYS 1000000
+#define BENCH_KEYLEN 64
+
+/**
+ * @brief
+ *	Returns the current wall clock time in seconds.
+ */
+static double
+now(void)
+{
+	struct timeval tv;
+
+	gettimeofday(&tv, NULL);
+	return ((double)tv.tv_sec + (double)tv.tv_usec * .000001);
+}
+
+/**
+ * @brief
+ *	Run one insert/find/miss/delete pass over 'keys' on an index
+ *	created with 'flags' and print the timings.
+ *
+ * @return int
+ * @retval 0	all operations behaved as expected
+ * @retval 1	an index operation failed
+ */
+static int
+run_bench(const char *name, int flags, char *keys, int nkeys)
+{
+	void *idx;
+	void *data;
+	void *key;
+	char miss[BENCH_KEYLEN];
+	double t;
+	int i;
+
+	if ((idx = pbs_idx_create(flags, 0)) == NULL) {
+		fprintf(stderr, "%s: pbs_idx_create failed\n", name);
+		return 1;
+	}
+
+	t = now();
+	for (i = 0; i < nkeys; i++) {
+		if (pbs_idx_insert(idx, keys + i * BENCH_KEYLEN, keys + i * BENCH_KEYLEN) != PBS_IDX_RET_OK) {
+			fprintf(stderr, "%s: insert of %s failed\n", name, keys + i * BENCH_KEYLEN);
+			return 1;
+		}
+	}
+	printf("%-5s insert  %9.3f secs\n", name, now() - t);
+
+	t = now();
+	for (i = 0; i < nkeys; i++) {
+		key = keys + i * BENCH_KEYLEN;
+		if (pbs_idx_find(idx, &key, &data, NULL) != PBS_IDX_RET_OK || data != key) {
+			fprintf(stderr, "%s: find of %s failed\n", name, (char *)key);
+			return 1;
+		}
+	}
+	printf("%-5s find    %9.3f secs\n", name, now() - t);
+
+	t = now();
+	for (i = 0; i < nkeys; i++) {
+		snprintf(miss, sizeof(miss), "%d.missing.example.com", i);
+		key = miss;
+		if (pbs_idx_find(idx, &key, &data, NULL) == PBS_IDX_RET_OK) {
+			fprintf(stderr, "%s: found missing key %s\n", name, miss);
+			return 1;
+		}
+	}
+	printf("%-5s miss    %9.3f secs\n", name, now() - t);
+
+	t = now();
+	for (i = 0; i < nkeys; i++)
+		pbs_idx_delete(idx, keys + i * BENCH_KEYLEN);
+	printf("%-5s delete  %9.3f secs\n", name, now() - t);
+
+	key = NULL;
+	if (pbs_idx_find(idx, &key, &data, NULL) == PBS_IDX_RET_OK) {
+		fprintf(stderr, "%s: index not empty after delete\n", name);
+		return 1;
+	}
+	pbs_idx_destroy(idx);
+	return 0;
+}
+
+int
+main(int argc, char *argv[])
+{
+	char *keys;
+	int nkeys = BENCH_DFLT_KEYS;
+	int c;
+	int i;
+	int rc;
+
+	while ((c = getopt(argc, argv, "n:")) != -1) {
+		switch (c) {
+			case 'n':
+				nkeys = atoi(optarg);
+				break;
+			default:
+				fprintf(stderr, "usage: %s [-n number_of_keys]\n", argv[0]);
+				return 1;
+		}
+	}
+	if (nkeys <= 0) {
+		fprintf(stderr, "number of keys must be positive\n");
+		return 1;
+	}
+
+	keys = malloc((size_t)nkeys * BENCH_KEYLEN);
+	if (keys == NULL) {
+		fprintf(stderr, "out of memory\n");
+		return 1;
+	}
+	/* job ids arrive in sequence number order, shuffle to vary the load */
+	for (i = 0; i < nkeys; i++)
+		snprintf(keys + i * BENCH_KEYLEN, BENCH_KEYLEN, "%d.pbsserver.example.com", i);
+	srandom(1);
+	for (i = nkeys - 1; i > 0; i--) {
+		char tmp[BENCH_KEYLEN];
+		int j = random() % (i + 1);
+
+		memcpy(tmp, keys + i * BENCH_KEYLEN, BENCH_KEYLEN);
+		memcpy(keys + i * BENCH_KEYLEN, keys + j * BENCH_KEYLEN, BENCH_KEYLEN);
+		memcpy(keys + j * BENCH_KEYLEN, tmp, BENCH_KEYLEN);
+	}
+
+	printf("%d keys\n", nkeys);
+	rc = run_bench("avl", 0, keys, nkeys);
+	if (rc == 0)
+		rc = run_bench("hash", PBS_IDX_HASH, keys, nkeys);
+
+	free(keys);
+	return rc;
+}
@@ -0,0 +1,119 @@
+# coding: utf-8
+# Copyright (C) 1994-2021 Altair Engineering, Inc.
+# For more information, contact Altair at www.altair.com.
+#
+# This file is part of both the OpenPBS software ("OpenPBS")
+# and the PBS Professional ("PBS Pro") software.
+#
+# Open Source License Information:
+#
+# OpenPBS is free software. You can redistribute it and/or modify it under
+# the terms of the GNU Affero General Public License as published by the
+# Free Software Foundation, either version 3 of the License, or (at your
+# option) any later version.
+#
+# OpenPBS is distributed in the hope that it will be useful, but WITHOUT
+# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+# FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public
+# License for more details.
+#
+# You should have received a copy of the GNU Affero General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Commercial License Information:
+#
+# PBS Pro is commercially licensed software that shares a common core with
+# the OpenPBS software.  For a copy of the commercial license terms and
+# conditions, go to: (http://www.pbspro.com/agreement.html) or contact the
+# Altair Legal Department.
+#
+# Altair's dual-license business model allows companies, individuals, and
+# organizations to create proprietary derivative works of OpenPBS and
+# distribute them - whether embedded or bundled with other software -
+# under a commercial license agreement.
+#
+# Use of Altair's trademarks, including but not limited to "PBS™",
+# "OpenPBS®", "PBS Professional®", and "PBS Pro™" and Altair's logos is
+# subject to Altair's trademark licensing policies.
+
+
+
+from tests.functional import *
+
+
+class TestAcctBinary(TestFunctional):
+    """
+    TestSuite for the binary accounting log, its index and pbs_acctbin
+    """
+
+    def setUp(self):
+        TestFunctional.setUp(self)
+        self.du.set_pbs_config(confs={'PBS_ACCT_BINARY': 1}, append=True)
+        self.server.restart()
+        self.assertTrue(self.server.isUp(), 'Failed to restart PBS Server')
+        self.acct_log = os.path.join(self.server.pbs_conf['PBS_HOME'],
+                                     'server_priv', 'accounting',
+                                     time.strftime('%Y%m%d'))
+
+    def tearDown(self):
+        self.du.unset_pbs_config(confs=['PBS_ACCT_BINARY'])
+        TestFunctional.tearDown(self)
+
+    def run_job(self):
+        """
+        Submit a short job and wait for it to leave the server
+        """
+        j = Job(TEST_USER)
+        j.set_sleep_time(1)
+        jid = self.server.submit(j)
+        self.server.expect(JOB, 'queue', id=jid, op=UNSET, offset=1)
+        return jid
+
+    def acctbin(self, *args):
+        """
+        Run pbs_acctbin on today's log and return its output lines
+        """
+        cmd = [os.path.join(self.server.pbs_conf['PBS_EXEC'], 'bin',
+                            'pbs_acctbin')] + list(args) + [self.acct_log]
+        ret = self.du.run_cmd(self.server.hostname, cmd, sudo=True)
+        self.assertEqual(ret['rc'], 0, ret['err'])
+        return ret['out']
+
+    def text_records(self, jid):
+        """
+        Return the lines of today's text log about jid
+        """
+        ret = self.du.cat(self.server.hostname, self.acct_log, sudo=True)
+        return [l for l in ret['out'] if (';%s;' % jid) in l]
+
+    def test_round_trip(self):
+        """
+        Records written before and after the log is reopened read back
+        from the binary log by id and by time as they are in the text log
+        """
+        jid1 = self.run_job()
+        time.sleep(2)
+        mid = time.time()
+
+        # reopen the accounting logs, as on rotation
+        self.assertTrue(self.server.signal('-HUP'))
+        self.server.log_match('Account file %s opened' % self.acct_log,
+                              starttime=int(mid))
+        jid2 = self.run_job()
+
+        for jid in (jid1, jid2):
+            expected = self.text_records(jid)
+            self.assertTrue(expected)
+            self.assertEqual(self.acctbin('-j', jid), expected)
+
+        since = time.strftime('%Y%m%d%H%M.%S', time.localtime(mid))
+        out = self.acctbin('-s', since)
+        self.assertFalse([l for l in out if (';%s;' % jid1) in l])
+        self.assertEqual([l for l in out if (';%s;' % jid2) in l],
+                         self.text_records(jid2))
+
+        # the index holds whole entries only
+        ret = self.du.run_cmd(self.server.hostname,
+                              ['stat', '-c', '%s', self.acct_log + '.idx'],
+                              sudo=True)
+        self.assertEqual((int(ret['out'][0]) - 8) % 24, 0)
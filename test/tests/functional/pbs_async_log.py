@@ -0,0 +1,78 @@
+# coding: utf-8
+# Copyright (C) 1994-2021 Altair Engineering, Inc.
+# For more information, contact Altair at www.altair.com.
+#
+# This file is part of both the OpenPBS software ("OpenPBS")
+# and the PBS Professional ("PBS Pro") software.
+#
+# Open Source License Information:
+#
+# OpenPBS is free software. You can redistribute it and/or modify it under
+# the terms of the GNU Affero General Public License as published by the
+# Free Software Foundation, either version 3 of the License, or (at your
+# option) any later version.
+#
+# OpenPBS is distributed in the hope that it will be useful, but WITHOUT
+# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+# FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public
+# License for more details.
+#
+# You should have received a copy of the GNU Affero General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Commercial License Information:
+#
+# PBS Pro is commercially licensed software that shares a common core with
+# the OpenPBS software.  For a copy of the commercial license terms and
+# conditions, go to: (http://www.pbspro.com/agreement.html) or contact the
+# Altair Legal Department.
+#
+# Altair's dual-license business model allows companies, individuals, and
+# organizations to create proprietary derivative works of OpenPBS and
+# distribute them - whether embedded or bundled with other software -
+# under a commercial license agreement.
+#
+# Use of Altair's trademarks, including but not limited to "PBS™",
+# "OpenPBS®", "PBS Professional®", and "PBS Pro™" and Altair's logos is
+# subject to Altair's trademark licensing policies.
+
+
+
+from tests.functional import *
+
+
+class TestAsyncLogging(TestFunctional):
+    """
+    TestSuite for logging from a writer thread (PBS_LOG_ASYNC)
+    """
+
+    def setUp(self):
+        TestFunctional.setUp(self)
+        a = {'PBS_LOG_ASYNC': 1}
+        self.du.set_pbs_config(confs=a, append=True)
+        PBSInitServices().restart()
+        self.assertTrue(self.server.isUp(), 'Failed to restart PBS Daemons')
+
+    def test_job_logged(self):
+        """
+        With asynchronous logging the server, scheduler and mom still
+        log the life of a job
+        """
+        j = Job(TEST_USER)
+        j.set_sleep_time(1)
+        jid = self.server.submit(j)
+        self.server.log_match(jid + ";Job Queued")
+        self.scheduler.log_match(jid + ";Job run")
+        self.mom.log_match("Job;%s;Started, pid" % jid)
+        self.server.expect(JOB, 'queue', id=jid, op=UNSET, offset=1)
+        self.server.log_match(jid + ";Exit_status=0")
+
+    def test_log_flushed_on_shutdown(self):
+        """
+        Records buffered when the server shuts down are written out
+        before it exits
+        """
+        self.server.qterm()
+        self.server.log_match("Log;Log closed", max_attempts=5)
+        self.server.start()
+        self.assertTrue(self.server.isUp(), 'Failed to start PBS Server')
@@ -0,0 +1,121 @@
+# coding: utf-8
+# Copyright (C) 1994-2021 Altair Engineering, Inc.
+# For more information, contact Altair at www.altair.com.
+#
+# This file is part of both the OpenPBS software ("OpenPBS")
+# and the PBS Professional ("PBS Pro") software.
+#
+# Open Source License Information:
+#
+# OpenPBS is free software. You can redistribute it and/or modify it under
+# the terms of the GNU Affero General Public License as published by the
+# Free Software Foundation, either version 3 of the License, or (at your
+# option) any later version.
+#
+# OpenPBS is distributed in the hope that it will be useful, but WITHOUT
+# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+# FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public
+# License for more details.
+#
+# You should have received a copy of the GNU Affero General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Commercial License Information:
+#
+# PBS Pro is commercially licensed software that shares a common core with
+# the OpenPBS software.  For a copy of the commercial license terms and
+# conditions, go to: (http://www.pbspro.com/agreement.html) or contact the
+# Altair Legal Department.
+#
+# Altair's dual-license business model allows companies, individuals, and
+# organizations to create proprietary derivative works of OpenPBS and
+# distribute them - whether embedded or bundled with other software -
+# under a commercial license agreement.
+#
+# Use of Altair's trademarks, including but not limited to "PBS™",
+# "OpenPBS®", "PBS Professional®", and "PBS Pro™" and Altair's logos is
+# subject to Altair's trademark licensing policies.
+
+
+
+from tests.functional import *
+
+
+class TestStatCache(TestFunctional):
+    """
+    TestSuite for the pre-encoded full status of vnodes and reservations
+    """
+
+    def full_status(self, obj_type, obj_id):
+        """
+        Return the attributes of a status for all attributes of the object
+        """
+        st = self.server.status(obj_type, id=obj_id)
+        self.assertEqual(len(st), 1)
+        return st[0]
+
+    def test_vnode_stat_follows_changes(self):
+        """
+        A full vnode status reflects attribute, job and resources_assigned
+        changes made since the previous full status
+        """
+        vn = self.mom.shortname
+        self.server.manager(MGR_CMD_SET, NODE, {'comment': 'first'}, id=vn)
+        self.assertEqual(self.full_status(NODE, vn)['comment'], 'first')
+        self.server.manager(MGR_CMD_SET, NODE, {'comment': 'second'}, id=vn)
+        self.assertEqual(self.full_status(NODE, vn)['comment'], 'second')
+
+        j = Job(TEST_USER, {'Resource_List.select': '1:ncpus=1'})
+        jid = self.server.submit(j)
+        self.server.expect(JOB, {'job_state': 'R'}, id=jid)
+        st = self.full_status(NODE, vn)
+        self.assertIn(jid, st['jobs'])
+        self.assertEqual(st['resources_assigned.ncpus'], '1')
+
+        self.server.delete(jid, wait=True)
+        st = self.full_status(NODE, vn)
+        self.assertNotIn('jobs', st)
+        self.assertEqual(st['resources_assigned.ncpus'], '0')
+
+    def test_resv_stat_follows_changes(self):
+        """
+        A full reservation status reflects a change which a status of
+        specific attributes has already seen
+        """
+        now = int(time.time())
+        r = Reservation(TEST_USER, {'reserve_start': now + 3600,
+                                    'reserve_end': now + 7200})
+        rid = self.server.submit(r)
+        a = {'reserve_state': (MATCH_RE, 'RESV_CONFIRMED|2')}
+        self.server.expect(RESV, a, id=rid)
+        self.full_status(RESV, rid)
+
+        self.server.alterresv(rid, {ATTR_N: 'renamed'})
+        self.server.expect(RESV, {'Reserve_Name': 'renamed'}, id=rid)
+        st = self.full_status(RESV, rid)
+        self.assertEqual(st['Reserve_Name'], 'renamed')
+
+    def test_resv_stat_after_unset(self):
+        """
+        A full reservation status stops showing an attribute which the
+        server unset after the previous full status
+        """
+        now = int(time.time())
+        r = Reservation(TEST_USER, {'reserve_start': now + 3600,
+                                    'reserve_end': now + 7200})
+        rid = self.server.submit(r)
+        a = {'reserve_state': (MATCH_RE, 'RESV_CONFIRMED|2')}
+        self.server.expect(RESV, a, id=rid)
+
+        self.server.manager(MGR_CMD_SET, SERVER, {'scheduling': False})
+        new_end = self.bu.convert_seconds_to_datetime(now + 9000)
+        self.server.alterresv(rid, {'reserve_end': new_end})
+        a2 = {'reserve_state': (MATCH_RE, 'RESV_BEING_ALTERED|11')}
+        self.server.expect(RESV, a2, id=rid)
+        st = self.full_status(RESV, rid)
+        self.assertIn('reserve_alter_revert.walltime', st)
+
+        self.server.manager(MGR_CMD_SET, SERVER, {'scheduling': True})
+        self.server.expect(RESV, a, id=rid)
+        st = self.full_status(RESV, rid)
+        self.assertFalse([k for k in st if k.startswith('reserve_alter_')])